@@ -0,0 +1,116 @@
+// 半径フィルタのマイクロベンチマーク
+// 従来の点ごとの haversine_km（AoS）と、CoordinateStore の SoA カーネルを比較する
+//
+//   ./haversine_benchmark [点数...]
+#include "spatial/coordinate_store.hpp"
+#include "spatial/geo_index.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 従来の店舗配列と同じ行指向のレイアウト
+struct Point {
+    double latitude;
+    double longitude;
+};
+
+constexpr double kCenterLat = 34.6851;
+constexpr double kCenterLon = 135.8050;
+constexpr double kRadiusKm = 10.0;
+
+// 最適化で計算が消されないようにする
+template <class T>
+void keep(T&& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// 1回あたりの平均時間（マイクロ秒）とヒット数
+template <class Fn>
+std::pair<double, size_t> measure(size_t iterations, Fn&& fn) {
+    size_t hits = fn();  // ウォームアップ
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        hits = fn();
+        keep(hits);
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    return {elapsed.count() / static_cast<double>(iterations), hits};
+}
+
+void run(size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat(33.5, 35.8);
+    std::uniform_real_distribution<double> lon(134.5, 136.5);
+
+    std::vector<Point> points;
+    spatial::CoordinateStore store;
+    points.reserve(count);
+    store.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Point p{lat(rng), lon(rng)};
+        points.push_back(p);
+        store.push_back(p.latitude, p.longitude);
+    }
+
+    size_t iterations = std::max<size_t>(10, 20'000'000 / count);
+    std::pmr::vector<std::uint32_t> out;
+    out.reserve(count);
+
+    auto [scalar_us, scalar_hits] = measure(iterations, [&] {
+        out.clear();
+        for (size_t i = 0; i < points.size(); ++i) {
+            const auto& p = points[i];
+            if (spatial::haversine_km(kCenterLat, kCenterLon, p.latitude, p.longitude) <= kRadiusKm) {
+                out.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        return out.size();
+    });
+
+    auto [soa_us, soa_hits] = measure(iterations, [&] {
+        out.clear();
+        store.filter_within_radius(kCenterLat, kCenterLon, kRadiusKm, 0, store.size(), out);
+        return out.size();
+    });
+
+    auto [equirect_us, equirect_hits] = measure(iterations, [&] {
+        out.clear();
+        store.filter_within_radius(kCenterLat, kCenterLon, kRadiusKm, 0, store.size(), out,
+                                   spatial::DistanceMode::Equirectangular);
+        return out.size();
+    });
+
+    auto per_point_ns = [count](double us) { return us * 1000.0 / static_cast<double>(count); };
+
+    std::println("📏 {} points (radius {} km)", count, kRadiusKm);
+    std::println("   scalar haversine     {:10.2f} us/call  {:6.2f} ns/point  hits={}",
+                 scalar_us, per_point_ns(scalar_us), scalar_hits);
+    std::println("   soa haversine        {:10.2f} us/call  {:6.2f} ns/point  hits={}  ({:.1f}x)",
+                 soa_us, per_point_ns(soa_us), soa_hits, scalar_us / soa_us);
+    std::println("   soa equirectangular  {:10.2f} us/call  {:6.2f} ns/point  hits={}  ({:.1f}x)",
+                 equirect_us, per_point_ns(equirect_us), equirect_hits, scalar_us / equirect_us);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::println("🧮 Radius filter benchmark (kernel: {})", spatial::CoordinateStore::kernel_name());
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) {
+            run(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+        }
+        return 0;
+    }
+
+    for (size_t count : {1'000uz, 10'000uz, 100'000uz}) {
+        run(count);
+    }
+    return 0;
+}
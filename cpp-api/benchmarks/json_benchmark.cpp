@@ -0,0 +1,141 @@
+// Shop 配列の JSON 化のマイクロベンチマーク
+// 従来の std::format による1件ごとの文字列生成と連結、JsonWriter による
+// 1つのバッファへの追記、および文字列エスケープ単体を比較する
+//
+//   ./json_benchmark [店舗数...]
+#include "serialization/domain_json.hpp"
+#include "serialization/json_writer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 最適化で計算が消されないようにする
+template <class T>
+void keep(T&& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// 1回あたりの平均時間（マイクロ秒）と出力サイズ
+template <class Fn>
+std::pair<double, size_t> measure(size_t iterations, Fn&& fn) {
+    size_t bytes = fn();  // ウォームアップ
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        bytes = fn();
+        keep(bytes);
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    return {elapsed.count() / static_cast<double>(iterations), bytes};
+}
+
+// 従来の ShopService::shop_to_json（エスケープなし）
+std::string format_shop(const domain::Shop& shop) {
+    return std::format(
+        R"({{"id":"{}","name":"{}","address":"{}","phone":"{}","latitude":{},"longitude":{},"region":"{}","spiceParameters":{{"spiciness":{},"stimulation":{},"aroma":{}}},"rating":{},"description":"{}","image_url":"{}"}})",
+        shop.id, shop.name, shop.address,
+        shop.phone.value_or(""),
+        shop.latitude, shop.longitude, shop.region,
+        shop.spice_params.spiciness, shop.spice_params.stimulation, shop.spice_params.aroma,
+        shop.rating,
+        shop.description.value_or(""),
+        shop.image_url.value_or("")
+    );
+}
+
+std::vector<domain::Shop> make_shops(size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat(34.3, 34.9);
+    std::uniform_real_distribution<double> lon(135.6, 136.0);
+    std::uniform_int_distribution<int> level(0, 100);
+
+    std::vector<domain::Shop> shops;
+    shops.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        shops.emplace_back(
+            std::format("shop-{:06}", i),
+            std::format("スパイスカレー {}号店", i),
+            std::format("奈良県奈良市三条町{}-{}", i % 100, i % 7),
+            std::nullopt,
+            lat(rng), lon(rng), "奈良市",
+            domain::SpiceParameters(level(rng), level(rng), level(rng)),
+            std::round(std::uniform_real_distribution<double>(3.0, 5.0)(rng) * 10.0) / 10.0,
+            "スパイスの香りが広がる本格カレー。季節の野菜と自家製ガラムマサラで仕上げた一皿は、"
+            "辛さと旨味のバランスが絶妙です。"
+        );
+    }
+    return shops;
+}
+
+void run(size_t count) {
+    auto shops = make_shops(count);
+    size_t iterations = std::max<size_t>(5, 2'000'000 / count);
+
+    auto [format_us, format_bytes] = measure(iterations, [&] {
+        std::string json = "[";
+        for (size_t i = 0; i < shops.size(); ++i) {
+            if (i > 0) json += ',';
+            json += format_shop(shops[i]);
+        }
+        json += ']';
+        return json.size();
+    });
+
+    std::string buffer;
+    auto [writer_us, writer_bytes] = measure(iterations, [&] {
+        buffer.clear();
+        serialization::JsonWriter writer(buffer);
+        writer.begin_array();
+        for (const auto& shop : shops) {
+            serialization::write_shop(writer, shop);
+        }
+        writer.end_array();
+        return buffer.size();
+    });
+
+    // エスケープ単体（説明文のみ）
+    std::string escaped;
+    auto [escape_us, escape_bytes] = measure(iterations, [&] {
+        escaped.clear();
+        for (const auto& shop : shops) {
+            serialization::append_escaped(escaped, *shop.description);
+        }
+        return escaped.size();
+    });
+
+    auto per_shop_ns = [count](double us) { return us * 1000.0 / static_cast<double>(count); };
+    auto mb_per_s = [](size_t bytes, double us) { return static_cast<double>(bytes) / us; };
+
+    std::println("🧾 {} shops", count);
+    std::println("   std::format + concat  {:10.2f} us/call  {:7.2f} ns/shop  {:8.1f} MB/s",
+                 format_us, per_shop_ns(format_us), mb_per_s(format_bytes, format_us));
+    std::println("   JsonWriter            {:10.2f} us/call  {:7.2f} ns/shop  {:8.1f} MB/s  ({:.1f}x)",
+                 writer_us, per_shop_ns(writer_us), mb_per_s(writer_bytes, writer_us), format_us / writer_us);
+    std::println("   append_escaped only   {:10.2f} us/call  {:7.2f} ns/shop  {:8.1f} MB/s",
+                 escape_us, per_shop_ns(escape_us), mb_per_s(escape_bytes, escape_us));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::println("🧮 JSON serialization benchmark (escape kernel: {})", serialization::escape_kernel_name());
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) {
+            run(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+        }
+        return 0;
+    }
+
+    for (size_t count : {100uz, 1'000uz, 10'000uz}) {
+        run(count);
+    }
+    return 0;
+}
@@ -0,0 +1,301 @@
+// ユーザー登録の書き込みのベンチマーク
+// 1件ずつコミットする従来の書き込み（ワーカーが書き込みを待つ）と、UserWriteCombiner の
+// sender で書き込みを待たずに投入するグループコミットを、処理中の登録数ごとに比較する
+// 既定ではコミットを模した書き込み関数を使う（接続数の上限・1文の往復・WAL の flush。
+// flush 中に届いたコミットは次の flush でまとめて永続化するため、従来側も同時のコミットはまとまる）
+//
+//   ./user_insert_benchmark [処理中の登録数...]             # 模擬 DB
+//   ./user_insert_benchmark --postgres [処理中の登録数...]  # DB_* の PostgreSQL（users に行を追加する）
+//   BENCH_WORKERS=16 ./user_insert_benchmark                # 従来側のワーカー数（既定はコア数）
+#include "database/connection_pool.hpp"
+#include "repository/postgres_user_repository.hpp"
+#include "repository/user_write_combiner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <format>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <semaphore>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using InsertResults = std::vector<std::expected<domain::User, std::string>>;
+
+// 1回の計測で書き込む登録数
+constexpr size_t kRegistrations = 4'000;
+
+// コミットを模した書き込み関数
+class SimulatedDatabase {
+public:
+    static constexpr size_t kConnections = 10;                     // PoolOptions::max_size の既定値
+    static constexpr auto kRoundTrip = std::chrono::microseconds(200);
+    static constexpr auto kRowCost = std::chrono::microseconds(5);
+    static constexpr auto kFlush = std::chrono::microseconds(1'000);  // WAL の fsync
+
+    InsertResults insert(std::span<const domain::User> users) {
+        connections_.acquire();
+        std::this_thread::sleep_for(kRoundTrip + kRowCost * users.size());
+        wait_flush();
+        connections_.release();
+
+        InsertResults results;
+        results.reserve(users.size());
+        for (const auto& user : users) {
+            domain::User inserted = user;
+            inserted.id = std::to_string(next_id_.fetch_add(1));
+            results.push_back(std::move(inserted));
+        }
+        return results;
+    }
+
+private:
+    // 実行中の flush には間に合わないため、次に開始する flush の完了を待つ
+    // （最初に待ったコミットが flush を行い、その間に届いたコミットは次の flush にまとまる）
+    void wait_flush() {
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        std::uint64_t needed = started_ + 1;
+        while (completed_ < needed) {
+            if (flushing_) {
+                flush_cv_.wait(lock);
+                continue;
+            }
+            flushing_ = true;
+            std::uint64_t generation = ++started_;
+            lock.unlock();
+            std::this_thread::sleep_for(kFlush);
+            lock.lock();
+            completed_ = generation;
+            flushing_ = false;
+            flush_cv_.notify_all();
+        }
+    }
+
+    std::counting_semaphore<> connections_{kConnections};
+    std::atomic<int> next_id_{1};
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    std::uint64_t started_ = 0;
+    std::uint64_t completed_ = 0;
+    bool flushing_ = false;
+};
+
+// 計測結果
+struct RunStats {
+    double rows_per_s = 0;
+    double p50_ms = 0;
+    double p99_ms = 0;
+    size_t failed = 0;
+};
+
+// 登録ごとの待ち時間（投入から結果まで）を集計する
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(size_t capacity) : latencies_(capacity) {}
+
+    void record(Clock::time_point submitted, bool ok) {
+        latencies_[next_.fetch_add(1)] = std::chrono::duration<double, std::milli>(Clock::now() - submitted).count();
+        if (!ok) {
+            failed_.fetch_add(1);
+        }
+    }
+
+    RunStats finish(Clock::duration elapsed) {
+        std::sort(latencies_.begin(), latencies_.end());
+        auto at = [this](double q) { return latencies_[static_cast<size_t>(q * static_cast<double>(latencies_.size() - 1))]; };
+        return RunStats{
+            static_cast<double>(latencies_.size()) / std::chrono::duration<double>(elapsed).count(),
+            at(0.50), at(0.99), failed_.load()
+        };
+    }
+
+private:
+    std::vector<double> latencies_;
+    std::atomic<size_t> next_{0};
+    std::atomic<size_t> failed_{0};
+};
+
+class UserFactory {
+public:
+    domain::User next() {
+        auto n = next_.fetch_add(1);
+        auto username = std::format("bench_{}_{}", prefix_, n);
+        return domain::User("", username, username + "@example.com");
+    }
+
+private:
+    std::string prefix_ = std::format("{}_{}", getpid(), Clock::now().time_since_epoch().count() % 1'000'000);
+    std::atomic<size_t> next_{0};
+};
+
+// 従来: clients 件の登録をワーカーが1件ずつ取り出し、コミットを待ってから次の登録へ進む
+// （ワーカー数を超える登録はキューで待つ。完了した登録の代わりに次の登録が届く）
+RunStats run_per_row(const repository::UserWriteCombiner::BatchInsert& insert_batch,
+                     UserFactory& users, size_t clients, size_t workers) {
+    LatencyRecorder recorder(kRegistrations);
+    std::mutex mutex;
+    std::deque<Clock::time_point> queue(std::min(clients, kRegistrations), Clock::now());
+    size_t issued = queue.size();
+
+    auto start = Clock::now();
+    std::vector<std::jthread> threads;
+    for (size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&] {
+            while (true) {
+                Clock::time_point submitted;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (queue.empty()) {
+                        return;
+                    }
+                    submitted = queue.front();
+                    queue.pop_front();
+                }
+
+                auto user = users.next();
+                auto results = insert_batch(std::span<const domain::User>(&user, 1));
+                recorder.record(submitted, results.size() == 1 && results[0].has_value());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (issued < kRegistrations) {
+                    ++issued;
+                    queue.push_back(Clock::now());
+                }
+            }
+        });
+    }
+    threads.clear();
+    return recorder.finish(Clock::now() - start);
+}
+
+// グループコミット: clients 件の登録を待たずに投入し、完了した登録の代わりに次の登録を投入する
+// （結果を待つスレッドはない）
+class CombinedRun {
+public:
+    CombinedRun(repository::UserWriteCombiner& combiner, UserFactory& users)
+        : combiner_(combiner), users_(users) {}
+
+    RunStats run(size_t clients) {
+        auto start = Clock::now();
+        size_t initial = std::min(clients, kRegistrations);
+        issued_.store(initial);
+        for (size_t i = 0; i < initial; ++i) {
+            submit();
+        }
+        done_.wait();
+        return recorder_.finish(Clock::now() - start);
+    }
+
+private:
+    void submit() {
+        auto submitted = Clock::now();
+        stdexec::start_detached(
+            combiner_.insert(users_.next())
+            | stdexec::then([this, submitted](std::expected<domain::User, std::string> result) {
+                  recorder_.record(submitted, result.has_value());
+                  if (issued_.fetch_add(1) < kRegistrations) {
+                      submit();
+                  }
+                  done_.count_down();
+              })
+        );
+    }
+
+    repository::UserWriteCombiner& combiner_;
+    UserFactory& users_;
+    LatencyRecorder recorder_{kRegistrations};
+    std::atomic<size_t> issued_{0};
+    std::latch done_{static_cast<std::ptrdiff_t>(kRegistrations)};
+};
+
+void run(const repository::UserWriteCombiner::BatchInsert& insert_batch, UserFactory& users,
+         size_t clients, size_t workers) {
+    auto per_row = run_per_row(insert_batch, users, clients, workers);
+
+    repository::UserWriteCombiner combiner(insert_batch);
+    CombinedRun combined_run(combiner, users);
+    auto combined = combined_run.run(clients);
+    combiner.stop();  // 完了の通知を終えてから combined_run を破棄する
+    auto metrics = combiner.metrics();
+
+    std::println("🧾 {} registrations in flight", clients);
+    std::println("   per-row commit ({:2} workers)  {:9.0f} rows/s  p50 {:7.2f} ms  p99 {:7.2f} ms  failed {}",
+                 workers, per_row.rows_per_s, per_row.p50_ms, per_row.p99_ms, per_row.failed);
+    std::println("   UserWriteCombiner (0 parked)  {:9.0f} rows/s  p50 {:7.2f} ms  p99 {:7.2f} ms  failed {}  ({:.1f}x, avg batch {:.1f})",
+                 combined.rows_per_s, combined.p50_ms, combined.p99_ms, combined.failed,
+                 combined.rows_per_s / per_row.rows_per_s,
+                 static_cast<double>(metrics.rows) / static_cast<double>(std::max<std::uint64_t>(metrics.batches, 1)));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int first_level = 1;
+    bool postgres = argc > 1 && std::string_view(argv[1]) == "--postgres";
+    if (postgres) {
+        first_level = 2;
+    }
+
+    std::vector<size_t> levels;
+    for (int i = first_level; i < argc; ++i) {
+        levels.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    if (levels.empty()) {
+        levels = {1, 8, 64, 256};
+    }
+
+    // サーバーのスレッドプールと同じワーカー数（BENCH_WORKERS で変更）
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    if (const char* workers_env = std::getenv("BENCH_WORKERS")) {
+        workers = std::max<size_t>(1, std::strtoull(workers_env, nullptr, 10));
+    }
+    UserFactory users;
+
+    if (!postgres) {
+        std::println("💾 User insert benchmark (simulated: {} connections, {}us round trip, {}us WAL flush)",
+                     SimulatedDatabase::kConnections, SimulatedDatabase::kRoundTrip.count(),
+                     SimulatedDatabase::kFlush.count());
+        SimulatedDatabase database;
+        repository::UserWriteCombiner::BatchInsert insert_batch = [&database](std::span<const domain::User> batch) {
+            return database.insert(batch);
+        };
+        for (size_t clients : levels) {
+            run(insert_batch, users, std::max<size_t>(clients, 1), workers);
+        }
+        return 0;
+    }
+
+    auto config = database::DatabaseConfig::from_env();
+    if (!config) {
+        std::println("❌ Failed to load database configuration from environment (DB_PASSWORD is required)");
+        return 1;
+    }
+    auto options = database::PoolOptions::from_env();
+    auto pool = database::ConnectionPool::create(*config, options);
+    if (!pool) {
+        std::println("❌ Failed to create connection pool: {}", pool.error());
+        return 1;
+    }
+    auto repository = std::make_shared<repository::PostgresUserRepository>(pool.value());
+
+    std::println("💾 User insert benchmark (PostgreSQL {}:{}, pool max {})", config->host, config->port, options.max_size);
+    repository::UserWriteCombiner::BatchInsert insert_batch = [repository](std::span<const domain::User> batch) {
+        return repository->add_batch(batch);
+    };
+    for (size_t clients : levels) {
+        run(insert_batch, users, std::max<size_t>(clients, 1), workers);
+    }
+    return 0;
+}
@@ -7,8 +7,10 @@ DROP TABLE IF EXISTS users CASCADE;
 DROP TABLE IF EXISTS shops CASCADE;
 
 -- Create shops table
+-- id はバイト順（COLLATE "C"）で比較する。API サーバーのスナップショット・キーセットページングの
+-- 並び順と一致し、id を含む比較・並べ替えが主キーと下のインデックスをそのまま使える
 CREATE TABLE shops (
-    id VARCHAR(255) PRIMARY KEY,
+    id VARCHAR(255) COLLATE "C" PRIMARY KEY,
     name VARCHAR(255) NOT NULL,
     address TEXT NOT NULL,
     phone VARCHAR(50),
@@ -27,8 +29,11 @@ CREATE TABLE shops (
 
 -- Create indexes for better query performance
 CREATE INDEX idx_shops_region ON shops(region);
-CREATE INDEX idx_shops_rating ON shops(rating DESC);
-CREATE INDEX idx_shops_spiciness ON shops(spiciness);
+CREATE INDEX idx_shops_region_rating ON shops(region, rating DESC);
+-- 並び替え（sort=rating / spiciness / name）とキーセットページングの同順位を id で解決する
+CREATE INDEX idx_shops_rating ON shops(rating DESC, id);
+CREATE INDEX idx_shops_spiciness ON shops(spiciness DESC, id);
+CREATE INDEX idx_shops_name ON shops((name COLLATE "C"), id);
 CREATE INDEX idx_shops_location ON shops(latitude, longitude);
 
 -- Create users table
@@ -53,7 +58,7 @@ CREATE INDEX idx_users_email ON users(email);
 -- User favorite shops (many-to-many)
 CREATE TABLE user_favorite_shops (
     user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,
-    shop_id VARCHAR(255) REFERENCES shops(id) ON DELETE CASCADE,
+    shop_id VARCHAR(255) COLLATE "C" REFERENCES shops(id) ON DELETE CASCADE,
     created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
     PRIMARY KEY (user_id, shop_id)
 );
@@ -65,7 +70,7 @@ CREATE INDEX idx_user_favorite_shops_shop ON user_favorite_shops(shop_id);
 -- User disliked shops (many-to-many)
 CREATE TABLE user_disliked_shops (
     user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,
-    shop_id VARCHAR(255) REFERENCES shops(id) ON DELETE CASCADE,
+    shop_id VARCHAR(255) COLLATE "C" REFERENCES shops(id) ON DELETE CASCADE,
     created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
     PRIMARY KEY (user_id, shop_id)
 );
@@ -74,6 +79,44 @@ CREATE TABLE user_disliked_shops (
 CREATE INDEX idx_user_disliked_shops_user ON user_disliked_shops(user_id);
 CREATE INDEX idx_user_disliked_shops_shop ON user_disliked_shops(shop_id);
 
+-- Cache invalidation notifications
+-- 行の変更を NOTIFY "<table>_changed" '<operation>:<id>' で API サーバーへ通知する
+-- （ペイロードが空の id はテーブル全体の無効化）
+CREATE OR REPLACE FUNCTION notify_row_change() RETURNS trigger AS $$
+DECLARE
+    row_id TEXT;
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        row_id := OLD.id::TEXT;
+    ELSE
+        row_id := NEW.id::TEXT;
+    END IF;
+    PERFORM pg_notify(TG_TABLE_NAME || '_changed', TG_OP || ':' || row_id);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION notify_table_truncate() RETURNS trigger AS $$
+BEGIN
+    PERFORM pg_notify(TG_TABLE_NAME || '_changed', TG_OP || ':');
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER shops_notify_change
+    AFTER INSERT OR UPDATE OR DELETE ON shops
+    FOR EACH ROW EXECUTE FUNCTION notify_row_change();
+CREATE TRIGGER shops_notify_truncate
+    AFTER TRUNCATE ON shops
+    FOR EACH STATEMENT EXECUTE FUNCTION notify_table_truncate();
+
+CREATE TRIGGER users_notify_change
+    AFTER INSERT OR UPDATE OR DELETE ON users
+    FOR EACH ROW EXECUTE FUNCTION notify_row_change();
+CREATE TRIGGER users_notify_truncate
+    AFTER TRUNCATE ON users
+    FOR EACH STATEMENT EXECUTE FUNCTION notify_table_truncate();
+
 -- Insert sample data for shops
 INSERT INTO shops (id, name, address, phone, latitude, longitude, region, spiciness, stimulation, aroma, rating, description) VALUES
 ('shop-001', 'スパイスカレー本舗 渋谷店', '東京都渋谷区道玄坂1-2-3', '03-1234-5678', 35.6595, 139.7004, '渋谷', 75, 80, 85, 4.5, '本格的なスパイスカレーの名店'),
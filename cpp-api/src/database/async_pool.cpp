@@ -0,0 +1,595 @@
+#include "database/async_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <print>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace database {
+
+namespace {
+
+// libpq のメッセージ末尾の改行を除く
+std::string trim_message(const char* message) {
+    std::string text = message ? message : "";
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+        text.pop_back();
+    }
+    return text;
+}
+
+constexpr std::uint64_t kWakeToken = ~std::uint64_t{0};
+
+} // namespace
+
+size_t PgResult::affected_rows() const {
+    if (!result_) {
+        return 0;
+    }
+    std::string_view tuples = PQcmdTuples(result_.get());
+    size_t count = 0;
+    std::from_chars(tuples.data(), tuples.data() + tuples.size(), count);
+    return count;
+}
+
+std::expected<std::vector<std::string>, std::string> parse_text_array(std::string_view value) {
+    if (value.size() < 2 || value.front() != '{' || value.back() != '}') {
+        return std::unexpected(std::format("Malformed array: {}", value));
+    }
+
+    std::vector<std::string> elements;
+    std::string_view body = value.substr(1, value.size() - 2);
+    size_t i = 0;
+    while (i < body.size()) {
+        std::string element;
+        if (body[i] == '"') {
+            // 引用符の中ではバックスラッシュが次の1文字をエスケープする
+            ++i;
+            while (i < body.size() && body[i] != '"') {
+                if (body[i] == '\\' && i + 1 < body.size()) {
+                    ++i;
+                }
+                element += body[i++];
+            }
+            if (i >= body.size()) {
+                return std::unexpected(std::format("Unterminated quote in array: {}", value));
+            }
+            ++i;
+        } else {
+            size_t end = body.find(',', i);
+            if (end == std::string_view::npos) {
+                end = body.size();
+            }
+            auto raw = body.substr(i, end - i);
+            if (raw == "NULL" || raw.starts_with('{')) {
+                return std::unexpected(std::format("Unsupported array element in {}", value));
+            }
+            element = std::string(raw);
+            i = end;
+        }
+        elements.push_back(std::move(element));
+
+        if (i < body.size()) {
+            if (body[i] != ',') {
+                return std::unexpected(std::format("Malformed array: {}", value));
+            }
+            ++i;
+        }
+    }
+    return elements;
+}
+
+AsyncPool::AsyncPool(std::string connection_string, int epoll_fd, int wake_fd, size_t connections,
+                     std::chrono::milliseconds query_timeout)
+    : connection_string_(std::move(connection_string))
+    , epoll_fd_(epoll_fd)
+    , wake_fd_(wake_fd)
+    , query_timeout_(query_timeout)
+    , startup_remaining_(connections) {
+    connections_.reserve(connections);
+    for (size_t i = 0; i < connections; ++i) {
+        auto c = std::make_unique<PgConnection>();
+        c->index = i;
+        connections_.push_back(std::move(c));
+    }
+}
+
+std::expected<std::unique_ptr<AsyncPool>, std::string> AsyncPool::create(
+    const DatabaseConfig& config,
+    size_t connections,
+    std::chrono::milliseconds query_timeout
+) {
+    if (connections == 0) {
+        return std::unexpected("Async pool needs at least one connection");
+    }
+    if (query_timeout <= std::chrono::milliseconds(0)) {
+        return std::unexpected("Async pool query timeout must be positive");
+    }
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        return std::unexpected(std::format("epoll_create1 failed: {}", std::strerror(errno)));
+    }
+    int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        close(epoll_fd);
+        return std::unexpected(std::format("eventfd failed: {}", std::strerror(errno)));
+    }
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.u64 = kWakeToken;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event);
+
+    std::unique_ptr<AsyncPool> pool(new AsyncPool(config.connection_string(), epoll_fd, wake_fd, connections, query_timeout));
+    auto* raw = pool.get();
+    pool->thread_ = std::jthread([raw](std::stop_token stop_token) { raw->run(stop_token); });
+
+    // すべての接続が prepare まで終えるのを待つ（1本でも失敗すれば作成失敗）
+    std::unique_lock<std::mutex> lock(pool->startup_mutex_);
+    pool->startup_cv_.wait(lock, [raw] { return raw->startup_remaining_ == 0 || !raw->startup_error_.empty(); });
+    if (!pool->startup_error_.empty()) {
+        return std::unexpected(std::format("Failed to initialize async pool: {}", pool->startup_error_));
+    }
+    lock.unlock();
+
+    std::println("AsyncPool initialized: {} non-blocking connections, query timeout {}ms",
+                 connections, query_timeout.count());
+    return pool;
+}
+
+AsyncPool::~AsyncPool() {
+    if (thread_.joinable()) {
+        thread_.request_stop();
+        std::uint64_t one = 1;
+        [[maybe_unused]] auto written = write(wake_fd_, &one, sizeof(one));
+        thread_.join();
+    }
+    close(wake_fd_);
+    close(epoll_fd_);
+}
+
+void AsyncPool::submit(QueryOp* op) noexcept {
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    op->deadline = std::chrono::steady_clock::now() + query_timeout_;
+
+    QueryOp* head = incoming_.load(std::memory_order_relaxed);
+    do {
+        op->next = head;
+    } while (!incoming_.compare_exchange_weak(head, op, std::memory_order_release, std::memory_order_relaxed));
+
+    // 空から積んだときだけ起こす（I/O スレッドは起床後にまとめて取り出す）
+    if (head == nullptr) {
+        std::uint64_t one = 1;
+        [[maybe_unused]] auto written = write(wake_fd_, &one, sizeof(one));
+    }
+}
+
+void AsyncPool::take_submissions() {
+    QueryOp* list = incoming_.exchange(nullptr, std::memory_order_acquire);
+
+    // スタックは新しい順なので反転して到着順にする
+    QueryOp* ordered = nullptr;
+    while (list) {
+        QueryOp* next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    while (ordered) {
+        QueryOp* next = ordered->next;
+        ordered->next = nullptr;
+        if (pending_tail_) {
+            pending_tail_->next = ordered;
+        } else {
+            pending_head_ = ordered;
+        }
+        pending_tail_ = ordered;
+        ordered = next;
+    }
+}
+
+void AsyncPool::dispatch_pending() {
+    bool any_alive = false;
+    for (auto& c : connections_) {
+        if (c->state != ConnState::Disconnected) {
+            any_alive = true;
+        }
+        if (c->state == ConnState::Ready && !c->current && !c->cancelling && pending_head_) {
+            QueryOp* op = pending_head_;
+            pending_head_ = op->next;
+            if (!pending_head_) {
+                pending_tail_ = nullptr;
+            }
+            op->next = nullptr;
+            start_query(*c, op);
+        }
+    }
+
+    // 再接続待ちの接続しかなければ、待たせずに失敗させる
+    if (!any_alive && pending_head_) {
+        fail_pending(std::format("No database connection available: {}", last_error_));
+    }
+}
+
+void AsyncPool::fail_pending(const std::string& error) {
+    while (pending_head_) {
+        QueryOp* op = pending_head_;
+        pending_head_ = op->next;
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        op->complete(op, std::unexpected(error));
+    }
+    pending_tail_ = nullptr;
+}
+
+int AsyncPool::expire_queries(std::chrono::steady_clock::time_point now) {
+    int timeout_ms = -1;
+    auto wake_at = [&](std::chrono::steady_clock::time_point at) {
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(at - now).count();
+        wait = std::max<decltype(wait)>(wait, 0);
+        timeout_ms = timeout_ms < 0 ? static_cast<int>(wait) : std::min(timeout_ms, static_cast<int>(wait));
+    };
+
+    // 待ち行列は（ほぼ）到着順なので期限も先頭から来る
+    while (pending_head_ && pending_head_->deadline <= now) {
+        QueryOp* op = pending_head_;
+        pending_head_ = op->next;
+        if (!pending_head_) {
+            pending_tail_ = nullptr;
+        }
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        op->complete(op, std::unexpected(std::string(kTimeoutError)));
+    }
+    if (pending_head_) {
+        wake_at(pending_head_->deadline);
+    }
+
+    for (auto& c : connections_) {
+        if (c->current && c->current->deadline <= now) {
+            cancel_query(*c, now);
+        }
+        if (c->cancelling) {
+            if (now >= c->cancel_deadline) {
+                disconnect(*c, "Cancelled query did not finish");
+            } else {
+                wake_at(c->cancel_deadline);
+            }
+        } else if (c->current) {
+            wake_at(c->current->deadline);
+        }
+    }
+    return timeout_ms;
+}
+
+void AsyncPool::cancel_query(PgConnection& c, std::chrono::steady_clock::time_point now) {
+    // PQcancel は別接続でキャンセル要求を送るまでブロックするが、タイムアウト時だけなので I/O スレッドで行う
+    char error[256] = "PQgetCancel failed";
+    PGcancel* cancel = PQgetCancel(c.conn);
+    bool sent = cancel && PQcancel(cancel, error, sizeof(error));
+    if (cancel) {
+        PQfreeCancel(cancel);
+    }
+
+    finish_query(c, std::unexpected(std::string(kTimeoutError)));
+    if (!sent) {
+        disconnect(c, std::format("Failed to cancel timed out query: {}", trim_message(error)));
+        return;
+    }
+
+    // 取り消したコマンドの結果を読み捨ててから次のクエリに使う
+    c.cancelling = true;
+    c.cancel_deadline = now + query_timeout_;
+}
+
+void AsyncPool::run(std::stop_token stop_token) {
+    for (auto& c : connections_) {
+        start_connect(*c);
+    }
+
+    std::array<epoll_event, 64> events{};
+    while (!stop_token.stop_requested()) {
+        // クエリの期限・再接続待ちの接続があればその時刻に起きる
+        auto now = std::chrono::steady_clock::now();
+        int timeout_ms = expire_queries(now);
+        for (auto& c : connections_) {
+            if (c->state == ConnState::Disconnected) {
+                auto wait = std::chrono::ceil<std::chrono::milliseconds>(c->retry_at - now).count();
+                wait = std::max<decltype(wait)>(wait, 0);
+                timeout_ms = timeout_ms < 0 ? static_cast<int>(wait) : std::min(timeout_ms, static_cast<int>(wait));
+            }
+        }
+
+        int count = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout_ms);
+        if (count < 0 && errno != EINTR) {
+            std::println("❌ AsyncPool epoll_wait failed: {}", std::strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u64 == kWakeToken) {
+                std::uint64_t value;
+                while (read(wake_fd_, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+            on_ready(*connections_[events[i].data.u64], events[i].events);
+        }
+
+        now = std::chrono::steady_clock::now();
+        for (auto& c : connections_) {
+            if (c->state == ConnState::Disconnected && now >= c->retry_at) {
+                start_connect(*c);
+            }
+        }
+
+        take_submissions();
+        dispatch_pending();
+    }
+
+    // 停止時は実行中・待機中のクエリを失敗させてから接続を閉じる
+    take_submissions();
+    fail_pending("Async pool is shutting down");
+    for (auto& c : connections_) {
+        if (c->current) {
+            finish_query(*c, std::unexpected("Async pool is shutting down"));
+        }
+        unwatch(*c);
+        if (c->conn) {
+            PQfinish(c->conn);
+            c->conn = nullptr;
+        }
+    }
+}
+
+void AsyncPool::start_connect(PgConnection& c) {
+    c.conn = PQconnectStart(connection_string_.c_str());
+    if (!c.conn || PQstatus(c.conn) == CONNECTION_BAD) {
+        disconnect(c, c.conn ? trim_message(PQerrorMessage(c.conn)) : "out of memory");
+        return;
+    }
+    c.state = ConnState::Connecting;
+    c.poll = PGRES_POLLING_WRITING;
+    continue_connect(c);
+}
+
+void AsyncPool::continue_connect(PgConnection& c) {
+    // PQconnectPoll はソケットを作り直すことがあるため毎回登録し直す
+    if (c.fd != PQsocket(c.conn)) {
+        unwatch(c);
+        c.fd = PQsocket(c.conn);
+    }
+
+    switch (c.poll) {
+    case PGRES_POLLING_READING:
+        watch(c, EPOLLIN);
+        return;
+    case PGRES_POLLING_WRITING:
+        watch(c, EPOLLOUT);
+        return;
+    case PGRES_POLLING_OK:
+        if (PQsetnonblocking(c.conn, 1) != 0) {
+            disconnect(c, trim_message(PQerrorMessage(c.conn)));
+            return;
+        }
+        c.state = ConnState::Preparing;
+        c.prepared = 0;
+        send_next_prepare(c);
+        return;
+    default:
+        disconnect(c, trim_message(PQerrorMessage(c.conn)));
+        return;
+    }
+}
+
+void AsyncPool::send_next_prepare(PgConnection& c) {
+    if (c.prepared == statements::kAll.size()) {
+        c.state = ConnState::Ready;
+        c.reconnect_delay = std::chrono::milliseconds(0);
+        watch(c, EPOLLIN);
+        if (!c.started) {
+            c.started = true;
+            report_startup("");
+        }
+        return;
+    }
+
+    const auto& statement = statements::kAll[c.prepared];
+    if (!PQsendPrepare(c.conn, statement.name, statement.sql, 0, nullptr)) {
+        disconnect(c, trim_message(PQerrorMessage(c.conn)));
+        return;
+    }
+    flush(c);
+}
+
+void AsyncPool::start_query(PgConnection& c, QueryOp* op) {
+    c.current = op;
+    c.result = PgResult();
+    c.error.clear();
+
+    // PQsendQueryPrepared は値を送信バッファへコピーするため、ポインタは呼び出しの間だけ有効であればよい
+    std::vector<const char*> values;
+    values.reserve(op->params.size());
+    for (const auto& param : op->params) {
+        values.push_back(param ? param->c_str() : nullptr);
+    }
+
+    if (!PQsendQueryPrepared(c.conn, op->statement, static_cast<int>(values.size()), values.data(),
+                             nullptr, nullptr, 0)) {
+        auto error = trim_message(PQerrorMessage(c.conn));
+        if (PQstatus(c.conn) == CONNECTION_BAD) {
+            disconnect(c, error);
+        } else {
+            finish_query(c, std::unexpected(error));
+        }
+        return;
+    }
+    flush(c);
+}
+
+bool AsyncPool::flush(PgConnection& c) {
+    int result = PQflush(c.conn);
+    if (result < 0) {
+        disconnect(c, trim_message(PQerrorMessage(c.conn)));
+        return false;
+    }
+    // 書き切れなければ書き込み可能を待つ（その間の受信も読む必要がある）
+    c.writing = result == 1;
+    watch(c, c.writing ? EPOLLIN | EPOLLOUT : EPOLLIN);
+    return true;
+}
+
+void AsyncPool::on_ready(PgConnection& c, std::uint32_t events) {
+    if (c.state == ConnState::Disconnected) {
+        return;
+    }
+    if (c.state == ConnState::Connecting) {
+        c.poll = PQconnectPoll(c.conn);
+        continue_connect(c);
+        return;
+    }
+
+    if (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+        if (!PQconsumeInput(c.conn)) {
+            disconnect(c, trim_message(PQerrorMessage(c.conn)));
+            return;
+        }
+    }
+    if (c.writing && !flush(c)) {
+        return;
+    }
+    read_results(c);
+}
+
+void AsyncPool::read_results(PgConnection& c) {
+    // 実行中のコマンドがなければ、届いたのは通知か切断
+    if (c.state == ConnState::Ready && !c.current && !c.cancelling) {
+        if (PQstatus(c.conn) == CONNECTION_BAD) {
+            disconnect(c, trim_message(PQerrorMessage(c.conn)));
+        }
+        return;
+    }
+
+    while (!PQisBusy(c.conn)) {
+        PGresult* result = PQgetResult(c.conn);
+        if (!result) {
+            on_command_complete(c);
+            return;
+        }
+        auto status = PQresultStatus(result);
+        if (status == PGRES_FATAL_ERROR || status == PGRES_BAD_RESPONSE || status == PGRES_NONFATAL_ERROR) {
+            if (c.error.empty()) {
+                c.error = trim_message(PQresultErrorMessage(result));
+            }
+            PQclear(result);
+        } else if (!c.result) {
+            c.result = PgResult(result);
+        } else {
+            PQclear(result);
+        }
+    }
+
+    if (PQstatus(c.conn) == CONNECTION_BAD) {
+        disconnect(c, trim_message(PQerrorMessage(c.conn)));
+    }
+}
+
+void AsyncPool::on_command_complete(PgConnection& c) {
+    if (c.state == ConnState::Preparing) {
+        if (!c.error.empty()) {
+            auto error = std::format("Prepare {} failed: {}", statements::kAll[c.prepared].name, c.error);
+            c.error.clear();
+            disconnect(c, error);
+            return;
+        }
+        c.result = PgResult();
+        c.prepared++;
+        send_next_prepare(c);
+        return;
+    }
+
+    if (c.cancelling) {
+        // タイムアウトで取り消したコマンド（呼び出し元へは完了済み）
+        c.cancelling = false;
+        c.result = PgResult();
+        c.error.clear();
+    } else if (c.error.empty()) {
+        finish_query(c, std::move(c.result));
+    } else {
+        finish_query(c, std::unexpected(std::move(c.error)));
+    }
+
+    // 空いた接続に次のクエリを割り当てる
+    dispatch_pending();
+}
+
+void AsyncPool::finish_query(PgConnection& c, QueryResult result) {
+    QueryOp* op = c.current;
+    c.current = nullptr;
+    c.result = PgResult();
+    c.error.clear();
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    // complete の中で op が破棄されることがあるため、以降は触らない
+    op->complete(op, std::move(result));
+}
+
+void AsyncPool::disconnect(PgConnection& c, const std::string& error) {
+    unwatch(c);
+    if (c.conn) {
+        PQfinish(c.conn);
+        c.conn = nullptr;
+    }
+    c.state = ConnState::Disconnected;
+    c.writing = false;
+    c.cancelling = false;
+    last_error_ = error;
+
+    if (c.current) {
+        finish_query(c, std::unexpected(std::format("Database connection lost: {}", error)));
+    }
+
+    c.reconnect_delay = c.reconnect_delay.count() == 0
+        ? kInitialReconnectDelay
+        : std::min(c.reconnect_delay * 2, kMaxReconnectDelay);
+    c.retry_at = std::chrono::steady_clock::now() + c.reconnect_delay;
+    std::println("⚠️  Async database connection {} lost (retrying in {}ms): {}",
+                 c.index, c.reconnect_delay.count(), error);
+
+    if (!c.started) {
+        c.started = true;
+        report_startup(error);
+    }
+}
+
+void AsyncPool::watch(PgConnection& c, std::uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = c.index;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, c.fd, &event) != 0 && errno == ENOENT) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, c.fd, &event);
+    }
+}
+
+void AsyncPool::unwatch(PgConnection& c) {
+    if (c.fd >= 0) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, c.fd, nullptr);
+        c.fd = -1;
+    }
+}
+
+void AsyncPool::report_startup(const std::string& error) {
+    std::lock_guard<std::mutex> lock(startup_mutex_);
+    if (startup_remaining_ == 0) {
+        return;
+    }
+    if (!error.empty() && startup_error_.empty()) {
+        startup_error_ = error;
+    }
+    startup_remaining_--;
+    startup_cv_.notify_all();
+}
+
+} // namespace database
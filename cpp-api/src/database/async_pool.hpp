@@ -0,0 +1,251 @@
+#pragma once
+#include "database/connection_pool.hpp"
+#include "database/statements.hpp"
+#include <libpq-fe.h>
+#include <stdexec/execution.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace database {
+
+// PGresult の所有者（行・列は 0 始まり）
+class PgResult {
+public:
+    PgResult() = default;
+    explicit PgResult(PGresult* result) noexcept : result_(result) {}
+
+    int rows() const { return result_ ? PQntuples(result_.get()) : 0; }
+    int columns() const { return result_ ? PQnfields(result_.get()) : 0; }
+
+    // 列名から列番号（なければ -1）
+    int column(const char* name) const { return result_ ? PQfnumber(result_.get(), name) : -1; }
+
+    bool is_null(int row, int column) const { return PQgetisnull(result_.get(), row, column) != 0; }
+
+    // テキスト形式の値（PgResult が生きている間だけ有効）
+    std::string_view value(int row, int column) const {
+        return {PQgetvalue(result_.get(), row, column),
+                static_cast<size_t>(PQgetlength(result_.get(), row, column))};
+    }
+
+    // INSERT / UPDATE / DELETE の対象行数
+    size_t affected_rows() const;
+
+    explicit operator bool() const { return result_ != nullptr; }
+
+private:
+    struct Clear {
+        void operator()(PGresult* result) const noexcept { PQclear(result); }
+    };
+    std::unique_ptr<PGresult, Clear> result_;
+};
+
+// クエリの結果（SQL エラー・接続エラーはメッセージ）
+using QueryResult = std::expected<PgResult, std::string>;
+
+// 1次元の text[] をテキスト形式（{a,"b c","d\"e"}）から要素へ分解する（NULL 要素・多次元はエラー）
+std::expected<std::vector<std::string>, std::string> parse_text_array(std::string_view value);
+
+// libpq の非同期 API でクエリを実行する接続群
+// 専用の I/O スレッドが各接続のソケットを epoll で待ち、接続（PQconnectPoll）・
+// 送信（PQsendQueryPrepared / PQflush）・受信（PQconsumeInput / PQgetResult）を進める。
+// 呼び出し側のスレッドは応答を待たないため、少数のスレッドから接続数を超えるクエリを投入でき、
+// 空いている接続がなければ I/O スレッドで到着順に待たせる。
+// 投入から query_timeout を過ぎたクエリは（実行中なら PQcancel で取り消して）kTimeoutError で完了する。
+// 完了は I/O スレッド上で通知されるため、重い処理は continues_on でワーカーへ移すこと
+class AsyncPool {
+public:
+    class QuerySender;
+
+    // タイムアウトしたクエリのエラー（呼び出し側が付けた前置きの後ろに残る）
+    static constexpr std::string_view kTimeoutError = "Query timed out";
+
+    static constexpr std::chrono::milliseconds kDefaultQueryTimeout{5'000};
+
+    // connections 本の接続を開き、statements::kAll を prepare し終えるまで待つ
+    static std::expected<std::unique_ptr<AsyncPool>, std::string> create(
+        const DatabaseConfig& config,
+        size_t connections,
+        std::chrono::milliseconds query_timeout = kDefaultQueryTimeout
+    );
+
+    // 実行中・待機中のクエリは失敗として完了させてから停止する
+    ~AsyncPool();
+
+    // コピー・ムーブ禁止（I/O スレッドが自身のアドレスを参照するため）
+    AsyncPool(const AsyncPool&) = delete;
+    AsyncPool& operator=(const AsyncPool&) = delete;
+
+    // プリペアドステートメントを実行する sender（完了値は QueryResult、stop token によるキャンセルには対応しない）
+    QuerySender query(const PreparedStatement& statement, StatementParams params = {});
+
+    // 統計情報
+    size_t get_connection_count() const { return connections_.size(); }
+    size_t get_in_flight() const { return in_flight_.load(std::memory_order_relaxed); }
+
+private:
+    // 投入されたクエリ（sender のオペレーションステートが継承する侵入型リスト）
+    struct QueryOp {
+        QueryOp* next = nullptr;
+        const char* statement = nullptr;
+        StatementParams params;
+        std::chrono::steady_clock::time_point deadline{};  // submit で設定（接続待ちの時間を含む）
+        void (*complete)(QueryOp*, QueryResult&&) noexcept = nullptr;
+    };
+
+    enum class ConnState : std::uint8_t {
+        Disconnected,  // retry_at に再接続する
+        Connecting,    // PQconnectPoll 中
+        Preparing,     // statements::kAll を順に prepare 中
+        Ready          // クエリを実行できる（current があれば実行中）
+    };
+
+    // I/O スレッドだけが触る接続の状態
+    struct PgConnection {
+        size_t index = 0;
+        PGconn* conn = nullptr;
+        int fd = -1;
+        ConnState state = ConnState::Disconnected;
+        PostgresPollingStatusType poll = PGRES_POLLING_WRITING;
+        bool writing = false;          // 送信しきれずに EPOLLOUT を待っている
+        size_t prepared = 0;           // prepare 済みのステートメント数
+        QueryOp* current = nullptr;    // 実行中のクエリ
+        bool cancelling = false;       // タイムアウトで取り消したコマンドの終了を待っている
+        std::chrono::steady_clock::time_point cancel_deadline{};  // これを過ぎても終わらなければ切断
+        PgResult result;               // current の最初の結果
+        std::string error;             // current の最初のエラー
+        bool started = false;          // 初回の接続結果を create へ報告済み
+        std::chrono::milliseconds reconnect_delay{0};
+        std::chrono::steady_clock::time_point retry_at{};
+    };
+
+    static constexpr std::chrono::milliseconds kInitialReconnectDelay{100};
+    static constexpr std::chrono::milliseconds kMaxReconnectDelay{10'000};
+
+    AsyncPool(std::string connection_string, int epoll_fd, int wake_fd, size_t connections,
+              std::chrono::milliseconds query_timeout);
+
+    // 任意のスレッドから投入（I/O スレッドを起こす）
+    void submit(QueryOp* op) noexcept;
+
+    void run(std::stop_token stop_token);
+
+    // 投入されたクエリを待ち行列の末尾へ移す
+    void take_submissions();
+    // 空いている接続へ待ち行列の先頭から割り当てる
+    void dispatch_pending();
+    // 待ち行列のクエリをすべて失敗させる
+    void fail_pending(const std::string& error);
+    // 期限を過ぎたクエリを失敗させ、次に期限が来るまでの時間（なければ -1）を返す
+    int expire_queries(std::chrono::steady_clock::time_point now);
+    void cancel_query(PgConnection& c, std::chrono::steady_clock::time_point now);
+
+    void start_connect(PgConnection& c);
+    void continue_connect(PgConnection& c);
+    void send_next_prepare(PgConnection& c);
+    void start_query(PgConnection& c, QueryOp* op);
+
+    void on_ready(PgConnection& c, std::uint32_t events);
+    // 送信バッファを書き出し、epoll の監視イベントを更新
+    bool flush(PgConnection& c);
+    // 届いた結果を読み、コマンドが完了していれば次へ進める
+    void read_results(PgConnection& c);
+    void on_command_complete(PgConnection& c);
+    void finish_query(PgConnection& c, QueryResult result);
+    void disconnect(PgConnection& c, const std::string& error);
+
+    void watch(PgConnection& c, std::uint32_t events);
+    void unwatch(PgConnection& c);
+
+    // 起動待ち（create が全接続の準備完了・失敗を待つ）
+    void report_startup(const std::string& error);
+
+    std::string connection_string_;
+    int epoll_fd_;
+    int wake_fd_;
+    std::chrono::milliseconds query_timeout_;
+
+    std::vector<std::unique_ptr<PgConnection>> connections_;
+
+    // 投入されたクエリ（後入れ先出しの lock-free スタック）
+    std::atomic<QueryOp*> incoming_{nullptr};
+    // 接続待ちのクエリ（到着順、I/O スレッドのみ）
+    QueryOp* pending_head_ = nullptr;
+    QueryOp* pending_tail_ = nullptr;
+    std::atomic<size_t> in_flight_{0};
+    std::string last_error_;
+
+    std::mutex startup_mutex_;
+    std::condition_variable startup_cv_;
+    size_t startup_remaining_;
+    std::string startup_error_;
+
+    std::jthread thread_;
+};
+
+// AsyncPool でクエリを実行する sender
+class AsyncPool::QuerySender {
+public:
+    using sender_concept = stdexec::sender_t;
+    using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t(QueryResult)>;
+
+    QuerySender(AsyncPool* pool, const char* statement, StatementParams params)
+        : pool_(pool), statement_(statement), params_(std::move(params)) {}
+
+    template <class Receiver>
+    struct Operation : QueryOp {
+        AsyncPool* pool;
+        Receiver receiver;
+
+        Operation(AsyncPool* p, const char* statement, StatementParams params, Receiver r)
+            : pool(p), receiver(std::move(r)) {
+            this->statement = statement;
+            this->params = std::move(params);
+            this->complete = &Operation::on_complete;
+        }
+
+        Operation(const Operation&) = delete;
+        Operation& operator=(const Operation&) = delete;
+
+        static void on_complete(QueryOp* op, QueryResult&& result) noexcept {
+            auto* self = static_cast<Operation*>(op);
+            stdexec::set_value(std::move(self->receiver), std::move(result));
+        }
+
+        void start() & noexcept {
+            pool->submit(this);
+        }
+    };
+
+    template <stdexec::receiver Receiver>
+    Operation<Receiver> connect(Receiver receiver) && {
+        return Operation<Receiver>(pool_, statement_, std::move(params_), std::move(receiver));
+    }
+
+    template <stdexec::receiver Receiver>
+    Operation<Receiver> connect(Receiver receiver) const& {
+        return Operation<Receiver>(pool_, statement_, params_, std::move(receiver));
+    }
+
+private:
+    AsyncPool* pool_;
+    const char* statement_;
+    StatementParams params_;
+};
+
+inline AsyncPool::QuerySender AsyncPool::query(const PreparedStatement& statement, StatementParams params) {
+    return QuerySender(this, statement.name, std::move(params));
+}
+
+} // namespace database
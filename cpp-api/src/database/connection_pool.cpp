@@ -1,5 +1,8 @@
 #include "database/connection_pool.hpp"
+#include <algorithm>
 #include <cstdlib>
+#include <functional>
+#include <thread>
 #include <format>
 #include <print>
 
@@ -38,28 +41,72 @@ std::string DatabaseConfig::connection_string() const {
     );
 }
 
+// PoolOptions implementation
+PoolOptions PoolOptions::fixed(size_t size) {
+    PoolOptions options;
+    options.min_size = size;
+    options.max_size = size;
+    return options;
+}
+
+PoolOptions PoolOptions::from_env() {
+    PoolOptions options;
+
+    auto read_env = [](const char* name) -> std::optional<int> {
+        const char* value = std::getenv(name);
+        if (!value) {
+            return std::nullopt;
+        }
+        int parsed = std::atoi(value);
+        if (parsed <= 0) {
+            std::println("⚠️  Invalid {} value, using default", name);
+            return std::nullopt;
+        }
+        return parsed;
+    };
+
+    if (auto min_size = read_env("DB_POOL_MIN")) {
+        options.min_size = static_cast<size_t>(*min_size);
+    }
+    if (auto max_size = read_env("DB_POOL_MAX")) {
+        options.max_size = static_cast<size_t>(*max_size);
+    }
+    if (auto idle_timeout = read_env("DB_POOL_IDLE_TIMEOUT")) {
+        options.idle_timeout = std::chrono::seconds(*idle_timeout);
+    }
+    if (auto async_connections = read_env("DB_ASYNC_CONNECTIONS")) {
+        options.async_connections = static_cast<size_t>(*async_connections);
+    }
+    if (auto async_query_timeout = read_env("DB_ASYNC_QUERY_TIMEOUT")) {
+        options.async_query_timeout = std::chrono::seconds(*async_query_timeout);
+    }
+    options.max_size = std::max(options.max_size, options.min_size);
+    return options;
+}
+
 // Connection implementation
-Connection::Connection(std::unique_ptr<pqxx::connection> conn, ConnectionPool* pool)
-    : conn_(std::move(conn)), pool_(pool) {}
+Connection::Connection(std::unique_ptr<pqxx::connection> conn, ConnectionPool* pool, size_t slot)
+    : conn_(std::move(conn)), pool_(pool), slot_(slot) {}
 
 Connection::~Connection() {
     if (conn_ && pool_) {
-        pool_->release(std::move(conn_));
+        pool_->release(slot_, std::move(conn_));
     }
 }
 
 Connection::Connection(Connection&& other) noexcept
-    : conn_(std::move(other.conn_)), pool_(other.pool_) {
+    : conn_(std::move(other.conn_)), pool_(other.pool_), slot_(other.slot_) {
     other.pool_ = nullptr;
 }
 
 Connection& Connection::operator=(Connection&& other) noexcept {
     if (this != &other) {
         if (conn_ && pool_) {
-            pool_->release(std::move(conn_));
+            pool_->release(slot_, std::move(conn_));
         }
         conn_ = std::move(other.conn_);
         pool_ = other.pool_;
+        slot_ = other.slot_;
         other.pool_ = nullptr;
     }
     return *this;
@@ -75,6 +122,55 @@ std::expected<pqxx::result, std::string> Connection::execute(const std::string&
     }
 }
 
+std::expected<pqxx::result, std::string> Connection::execute_prepared(const PreparedStatement& statement) {
+    try {
+        pqxx::nontransaction txn(*conn_);
+        auto result = txn.exec_prepared(statement.name);
+        return result;
+    } catch (const std::exception& e) {
+        return std::unexpected(std::format("Prepared statement {} failed: {}", statement.name, e.what()));
+    }
+}
+
+std::expected<std::vector<pqxx::result>, std::string>
+Connection::execute_batch(std::span<const BatchQuery> queries) {
+    try {
+        pqxx::nontransaction txn(*conn_);
+        pqxx::pipeline pipe(txn);
+
+        // すべて積み終えるまで送信を保留し、1つのクエリ文字列として送る
+        pipe.retain(static_cast<long>(queries.size()));
+
+        // pipeline はパラメータを渡せないため、prepare 済みのステートメントを
+        // EXECUTE で呼び出し、値はリテラルとしてエスケープする
+        std::vector<pqxx::pipeline::query_id> ids;
+        ids.reserve(queries.size());
+        for (const auto& query : queries) {
+            std::string sql = std::format("EXECUTE {}", query.statement.name);
+            for (size_t i = 0; i < query.params.size(); ++i) {
+                const auto& param = query.params[i];
+                sql += i == 0 ? "(" : ", ";
+                sql += param ? txn.quote(*param) : std::string("NULL");
+            }
+            if (!query.params.empty()) {
+                sql += ")";
+            }
+            ids.push_back(pipe.insert(sql));
+        }
+        pipe.resume();
+
+        std::vector<pqxx::result> results;
+        results.reserve(ids.size());
+        for (auto id : ids) {
+            results.push_back(pipe.retrieve(id));
+        }
+        return results;
+
+    } catch (const std::exception& e) {
+        return std::unexpected(std::format("Batch execution failed: {}", e.what()));
+    }
+}
+
 std::expected<std::unique_ptr<pqxx::work>, std::string> Connection::begin_transaction() {
     try {
         auto txn = std::make_unique<pqxx::work>(*conn_);
@@ -93,32 +189,52 @@ pqxx::connection& Connection::raw_connection() {
 }
 
 // ConnectionPool implementation
-ConnectionPool::ConnectionPool(DatabaseConfig config, size_t pool_size)
+namespace {
+
+std::int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// スレッドが前回取得したスロット（別のプールのものなら使わない）
+thread_local const void* affinity_pool = nullptr;
+thread_local size_t affinity_slot = 0;
+
+} // namespace
+
+ConnectionPool::ConnectionPool(DatabaseConfig config, PoolOptions options)
     : config_(std::move(config))
-    , pool_size_(pool_size)
-    , active_connections_(0) {}
+    , options_(options)
+    , slots_(std::make_unique<Slot[]>(options.max_size))
+    , reconnect_delay_ms_(options.reconnect_delay.count()) {}
 
+// 貸し出し中の接続は移動元のアドレスを返却先として持つため、使用中のプールは移動しないこと
+// （保守スレッドも start_maintenance() は移動後に呼び出す）
 ConnectionPool::ConnectionPool(ConnectionPool&& other) noexcept
     : config_(std::move(other.config_))
-    , pool_size_(other.pool_size_)
-    , active_connections_(other.active_connections_.load())
-    , available_connections_(std::move(other.available_connections_)) {
-    other.pool_size_ = 0;
-    other.active_connections_ = 0;
+    , options_(other.options_)
+    , slots_(std::move(other.slots_))
+    , open_connections_(other.open_connections_.load())
+    , reconnect_delay_ms_(other.reconnect_delay_ms_.load())
+    , listener_(std::move(other.listener_)) {
+    contention_.connects = other.contention_.connects.load();
+    other.options_.max_size = 0;
+    other.open_connections_ = 0;
 }
 
 ConnectionPool& ConnectionPool::operator=(ConnectionPool&& other) noexcept {
     if (this != &other) {
-        std::lock_guard<std::mutex> lock1(mutex_, std::adopt_lock);
-        std::lock_guard<std::mutex> lock2(other.mutex_, std::adopt_lock);
-
+        maintenance_thread_ = std::jthread();
         config_ = std::move(other.config_);
-        pool_size_ = other.pool_size_;
-        active_connections_ = other.active_connections_.load();
-        available_connections_ = std::move(other.available_connections_);
-
-        other.pool_size_ = 0;
-        other.active_connections_ = 0;
+        options_ = other.options_;
+        slots_ = std::move(other.slots_);
+        open_connections_ = other.open_connections_.load();
+        reconnect_delay_ms_ = other.reconnect_delay_ms_.load();
+        contention_.connects = other.contention_.connects.load();
+        listener_ = std::move(other.listener_);
+
+        other.options_.max_size = 0;
+        other.open_connections_ = 0;
     }
     return *this;
 }
@@ -127,11 +243,21 @@ std::expected<ConnectionPool, std::string> ConnectionPool::create(
     const DatabaseConfig& config,
     size_t pool_size
 ) {
-    if (pool_size == 0) {
+    return create(config, PoolOptions::fixed(pool_size));
+}
+
+std::expected<ConnectionPool, std::string> ConnectionPool::create(
+    const DatabaseConfig& config,
+    const PoolOptions& options
+) {
+    if (options.max_size == 0) {
         return std::unexpected("Pool size must be greater than 0");
     }
+    if (options.min_size > options.max_size) {
+        return std::unexpected("Pool min size must not exceed max size");
+    }
 
-    ConnectionPool pool(config, pool_size);
+    ConnectionPool pool(config, options);
 
     if (auto init_result = pool.initialize(); !init_result.has_value()) {
         return std::unexpected(init_result.error());
@@ -141,12 +267,16 @@ std::expected<ConnectionPool, std::string> ConnectionPool::create(
 }
 
 ConnectionPool::~ConnectionPool() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // すべての接続を閉じる
-    while (!available_connections_.empty()) {
-        available_connections_.pop();
+    // 保守スレッドとリスナーのハンドラーはプールを使うため先に停止する
+    maintenance_thread_ = std::jthread();
+    listener_.reset();
+
+    if (!slots_) {
+        return;
     }
-    std::println("ConnectionPool destroyed: {} connections cleaned up", pool_size_);
+    // すべての接続を閉じる
+    slots_.reset();
+    std::println("ConnectionPool destroyed: {} connections cleaned up", open_connections_.load());
 }
 
 std::expected<std::unique_ptr<pqxx::connection>, std::string>
@@ -159,6 +289,11 @@ ConnectionPool::create_connection() {
             return std::unexpected("Failed to open database connection");
         }
 
+        // 接続の生存期間中は同じステートメントを名前で再利用する
+        for (const auto& statement : statements::kAll) {
+            conn->prepare(statement.name, statement.sql);
+        }
+
         return conn;
     } catch (const std::exception& e) {
         return std::unexpected(
@@ -168,9 +303,7 @@ ConnectionPool::create_connection() {
 }
 
 std::expected<void, std::string> ConnectionPool::initialize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    for (size_t i = 0; i < pool_size_; ++i) {
+    for (size_t i = 0; i < options_.min_size; ++i) {
         auto conn_result = create_connection();
         if (!conn_result.has_value()) {
             return std::unexpected(
@@ -178,55 +311,380 @@ std::expected<void, std::string> ConnectionPool::initialize() {
                            conn_result.error())
             );
         }
-        available_connections_.push(std::move(conn_result.value()));
+        slots_[i].conn = std::move(conn_result.value());
+        slots_[i].released_at.store(steady_now_ns(), std::memory_order_relaxed);
+        slots_[i].state.store(SlotState::Free, std::memory_order_release);
+        open_connections_.fetch_add(1, std::memory_order_relaxed);
+        contention_.connects.fetch_add(1, std::memory_order_relaxed);
     }
 
-    std::println("ConnectionPool initialized: {} connections created", pool_size_);
+    std::println("ConnectionPool initialized: {} connections created (max {})",
+                 options_.min_size, options_.max_size);
     return {};
 }
 
+std::optional<size_t> ConnectionPool::try_acquire_slot() {
+    const size_t slot_count = options_.max_size;
+    const bool has_hint = affinity_pool == this && affinity_slot < slot_count;
+    // 初めてのスレッドはスレッド ID から開始位置を散らし、同じスロットへの集中を避ける
+    const size_t start = has_hint
+        ? affinity_slot
+        : std::hash<std::thread::id>{}(std::this_thread::get_id()) % slot_count;
+
+    for (size_t i = 0; i < slot_count; ++i) {
+        size_t index = start + i;
+        if (index >= slot_count) {
+            index -= slot_count;
+        }
+        auto& slot = slots_[index];
+
+        // 使用中と分かっているスロットには CAS を発行しない（キャッシュラインの奪い合いを避ける）
+        if (slot.state.load(std::memory_order_relaxed) != SlotState::Free) {
+            continue;
+        }
+        auto expected = SlotState::Free;
+        if (!slot.state.compare_exchange_strong(expected, SlotState::InUse,
+                                                std::memory_order_acquire, std::memory_order_relaxed)) {
+            contention_.cas_failures.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // スロットを保持している間はこのスレッドだけが書き込むため read-modify-write は不要
+        slot.acquired.store(slot.acquired.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (has_hint) {
+            // 前回のスロットが取れなければ、ここで取れたのは他のスレッドが使っていたスロット
+            auto& counter = i == 0 ? slot.affinity_hits : slot.steals;
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        affinity_pool = this;
+        affinity_slot = index;
+        return index;
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> ConnectionPool::try_grow() {
+    if (steady_now_ns() < next_connect_at_.load(std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+
+    for (size_t i = 0; i < options_.max_size; ++i) {
+        auto& slot = slots_[i];
+        auto expected = SlotState::Closed;
+        if (slot.state.load(std::memory_order_relaxed) != SlotState::Closed ||
+            !slot.state.compare_exchange_strong(expected, SlotState::Connecting,
+                                                std::memory_order_acquire, std::memory_order_relaxed)) {
+            continue;
+        }
+
+        auto conn = create_connection();
+        if (!conn.has_value()) {
+            record_connect_failure(conn.error());
+            slot.state.store(SlotState::Closed, std::memory_order_release);
+            // 待機中のスレッドは再接続の時刻まで待つ
+            notify_waiters();
+            return std::nullopt;
+        }
+
+        record_connect_success();
+        slot.conn = std::move(conn.value());
+        open_connections_.fetch_add(1, std::memory_order_relaxed);
+        return i;
+    }
+    return std::nullopt;
+}
+
+std::optional<Connection> ConnectionPool::checkout(size_t slot) {
+    auto conn = std::move(slots_[slot].conn);
+
+    // 切断されていれば捨てる（空いたスロットは次の取得で開き直す）
+    if (!conn || !conn->is_open()) {
+        release(slot, std::move(conn));
+        return std::nullopt;
+    }
+
+    return Connection(std::move(conn), this, slot);
+}
+
+std::optional<Connection> ConnectionPool::try_checkout() {
+    while (auto slot = try_acquire_slot()) {
+        if (auto conn = checkout(*slot)) {
+            return conn;
+        }
+    }
+
+    // 空きがなければ max_size まで接続を増やす
+    if (auto slot = try_grow()) {
+        auto& entry = slots_[*slot];
+        entry.acquired.store(entry.acquired.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        entry.state.store(SlotState::InUse, std::memory_order_relaxed);
+        affinity_pool = this;
+        affinity_slot = *slot;
+        return Connection(std::move(entry.conn), this, *slot);
+    }
+    return std::nullopt;
+}
+
+bool ConnectionPool::can_acquire_now() const {
+    if (count_slots(SlotState::Free) > 0) {
+        return true;
+    }
+    return count_slots(SlotState::Closed) > 0 &&
+           steady_now_ns() >= next_connect_at_.load(std::memory_order_relaxed);
+}
+
 std::expected<Connection, std::string> ConnectionPool::acquire(
     std::chrono::milliseconds timeout
 ) {
-    std::unique_lock<std::mutex> lock(mutex_);
+    // 空きがあればロックを取らずに取得
+    for (int round = 0; round < kSpinRounds; ++round) {
+        if (auto conn = try_checkout()) {
+            return std::move(*conn);
+        }
+        std::this_thread::yield();
+    }
+
+    // すべて使用中なら返却を待つ
+    auto started = std::chrono::steady_clock::now();
+    auto deadline = started + timeout;
+    contention_.waits.fetch_add(1, std::memory_order_relaxed);
+
+    // notify_waiters() はスロットを空けてから waiters_ を読む。こちらは waiters_ を増やしてから
+    // 空きを探すため、フェンスでどちらかが必ず相手の書き込みを観測し、通知の取りこぼしが起きない
+    waiters_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    std::optional<Connection> conn;
+    while (!(conn = try_checkout())) {
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        if (can_acquire_now()) {
+            continue;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        // 再接続を待っている間はその時刻にも起きる
+        auto wake_at = deadline;
+        if (count_slots(SlotState::Closed) > 0) {
+            auto retry_at = std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(next_connect_at_.load(std::memory_order_relaxed)));
+            wake_at = std::min(wake_at, retry_at);
+        }
+        wait_cv_.wait_until(lock, wake_at);
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
 
-    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    contention_.wait_time_us.fetch_add(static_cast<std::uint64_t>(waited.count()), std::memory_order_relaxed);
 
-    // 利用可能な接続を待つ
-    while (available_connections_.empty()) {
-        if (cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
-            return std::unexpected("Connection acquisition timeout");
+    if (!conn) {
+        contention_.timeouts.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (get_pool_size() == 0 && !last_connect_error_.empty()) {
+            return std::unexpected(std::format("Connection acquisition timeout ({})", last_connect_error_));
         }
+        return std::unexpected("Connection acquisition timeout");
     }
+    return std::move(*conn);
+}
 
-    // 接続を取得
-    auto conn = std::move(available_connections_.front());
-    available_connections_.pop();
-    active_connections_++;
+void ConnectionPool::release(size_t slot, std::unique_ptr<pqxx::connection> conn) {
+    auto& entry = slots_[slot];
 
-    // 接続が有効かチェック
-    if (!conn->is_open()) {
-        active_connections_--;
-        return std::unexpected("Retrieved connection is not open");
+    if (conn && conn->is_open()) {
+        entry.conn = std::move(conn);
+        entry.released_at.store(steady_now_ns(), std::memory_order_relaxed);
+        make_available(slot);
+    } else {
+        entry.conn = std::move(conn);
+        close_slot(slot, contention_.closed_dead);
     }
+}
 
-    return Connection(std::move(conn), this);
+void ConnectionPool::make_available(size_t slot) {
+    slots_[slot].state.store(SlotState::Free, std::memory_order_release);
+    notify_waiters();
 }
 
-void ConnectionPool::release(std::unique_ptr<pqxx::connection> conn) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void ConnectionPool::close_slot(size_t slot, std::atomic<std::uint64_t>& reason) {
+    auto& entry = slots_[slot];
+    entry.conn.reset();
+    reason.fetch_add(1, std::memory_order_relaxed);
+    size_t open = open_connections_.fetch_sub(1, std::memory_order_relaxed) - 1;
+    entry.state.store(SlotState::Closed, std::memory_order_release);
 
-    if (conn && conn->is_open()) {
-        available_connections_.push(std::move(conn));
+    // 待機中のスレッドは空いたスロットで接続を開き直せる
+    notify_waiters();
+
+    if (open < options_.min_size && &reason == &contention_.closed_dead) {
+        {
+            std::lock_guard<std::mutex> lock(maintenance_mutex_);
+            replenish_requested_ = true;
+        }
+        maintenance_cv_.notify_one();
+    }
+}
+
+void ConnectionPool::notify_waiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        wait_cv_.notify_one();
     }
+}
+
+void ConnectionPool::record_connect_success() {
+    contention_.connects.fetch_add(1, std::memory_order_relaxed);
+    reconnect_delay_ms_.store(options_.reconnect_delay.count(), std::memory_order_relaxed);
+    next_connect_at_.store(0, std::memory_order_relaxed);
+}
+
+void ConnectionPool::record_connect_failure(const std::string& error) {
+    contention_.connect_failures.fetch_add(1, std::memory_order_relaxed);
+
+    // 失敗が続くほど再接続の間隔を空ける（同時に失敗した場合の更新の競合は許容する）
+    auto delay = std::chrono::milliseconds(reconnect_delay_ms_.load(std::memory_order_relaxed));
+    next_connect_at_.store(steady_now_ns() + std::chrono::nanoseconds(delay).count(), std::memory_order_relaxed);
+    reconnect_delay_ms_.store(std::min(delay * 2, options_.max_reconnect_delay).count(), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (last_connect_error_ != error) {
+        std::println("⚠️  Database connection failed (retrying in {}ms): {}", delay.count(), error);
+        last_connect_error_ = error;
+    }
+}
 
-    active_connections_--;
-    cv_.notify_one();
+void ConnectionPool::start_maintenance() {
+    maintenance_thread_ = std::jthread([this](std::stop_token stop_token) { maintenance_loop(stop_token); });
+}
+
+void ConnectionPool::maintenance_loop(std::stop_token stop_token) {
+    while (!stop_token.stop_requested()) {
+        // 補充が必要なのに再接続待ちなら、その時刻に起きる
+        auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(std::max(
+            std::min(options_.health_check_interval, options_.idle_timeout), std::chrono::milliseconds(1)));
+        if (get_pool_size() < options_.min_size) {
+            auto retry_in = std::chrono::nanoseconds(
+                next_connect_at_.load(std::memory_order_relaxed) - steady_now_ns());
+            interval = std::clamp(retry_in, std::chrono::nanoseconds(std::chrono::milliseconds(1)), interval);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(maintenance_mutex_);
+            if (maintenance_cv_.wait_for(lock, stop_token, interval, [this] { return replenish_requested_; })) {
+                replenish_requested_ = false;
+            }
+        }
+        if (stop_token.stop_requested()) {
+            return;
+        }
+
+        run_maintenance();
+    }
+}
+
+void ConnectionPool::run_maintenance() {
+    const auto now = steady_now_ns();
+    const auto idle_timeout = std::chrono::nanoseconds(options_.idle_timeout).count();
+    const auto health_check_interval = std::chrono::nanoseconds(options_.health_check_interval).count();
+
+    // 空き接続を1つずつ借りて、min_size を超える長時間未使用の接続は閉じ、残りは生存を確認する
+    for (size_t i = 0; i < options_.max_size; ++i) {
+        auto& slot = slots_[i];
+        auto expected = SlotState::Free;
+        if (!slot.state.compare_exchange_strong(expected, SlotState::InUse,
+                                                std::memory_order_acquire, std::memory_order_relaxed)) {
+            continue;
+        }
+
+        auto idle = now - slot.released_at.load(std::memory_order_relaxed);
+        if (idle >= idle_timeout && get_pool_size() > options_.min_size) {
+            close_slot(i, contention_.closed_idle);
+            continue;
+        }
+
+        if (idle >= health_check_interval) {
+            bool alive = false;
+            try {
+                pqxx::nontransaction txn(*slot.conn);
+                txn.exec("SELECT 1");
+                alive = true;
+            } catch (const std::exception& e) {
+                std::println("⚠️  Pooled connection failed health check: {}", e.what());
+            }
+            if (!alive) {
+                close_slot(i, contention_.closed_dead);
+                continue;
+            }
+        }
+        make_available(i);
+    }
+
+    // 切断で減った接続を min_size まで開き直す（失敗したら再接続の時刻まで待つ）
+    while (get_pool_size() < options_.min_size) {
+        auto slot = try_grow();
+        if (!slot) {
+            break;
+        }
+        slots_[*slot].released_at.store(steady_now_ns(), std::memory_order_relaxed);
+        make_available(*slot);
+    }
+}
+
+void ConnectionPool::subscribe_changes(std::string table, ChangeHandler handler) {
+    if (!listener_) {
+        listener_ = std::make_unique<NotificationListener>(config_.connection_string());
+    }
+    listener_->subscribe(std::move(table), std::move(handler));
+}
+
+std::expected<void, std::string> ConnectionPool::start_change_listener() {
+    if (!listener_) {
+        return std::unexpected("No change subscriptions registered");
+    }
+    return listener_->start();
+}
+
+size_t ConnectionPool::count_slots(SlotState state) const {
+    size_t count = 0;
+    for (size_t i = 0; i < options_.max_size; ++i) {
+        if (slots_[i].state.load(std::memory_order_relaxed) == state) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t ConnectionPool::get_active_connections() const {
+    return count_slots(SlotState::InUse);
 }
 
 size_t ConnectionPool::get_available_connections() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return available_connections_.size();
+    return count_slots(SlotState::Free);
+}
+
+PoolMetrics ConnectionPool::metrics() const {
+    PoolMetrics result{
+        .pool_size = get_pool_size(),
+        .max_size = options_.max_size,
+        .active = get_active_connections(),
+        .available = get_available_connections(),
+        .cas_failures = contention_.cas_failures.load(std::memory_order_relaxed),
+        .waits = contention_.waits.load(std::memory_order_relaxed),
+        .timeouts = contention_.timeouts.load(std::memory_order_relaxed),
+        .wait_time_us = contention_.wait_time_us.load(std::memory_order_relaxed),
+        .connects = contention_.connects.load(std::memory_order_relaxed),
+        .connect_failures = contention_.connect_failures.load(std::memory_order_relaxed),
+        .closed_idle = contention_.closed_idle.load(std::memory_order_relaxed),
+        .closed_dead = contention_.closed_dead.load(std::memory_order_relaxed),
+    };
+    for (size_t i = 0; i < options_.max_size; ++i) {
+        result.acquired += slots_[i].acquired.load(std::memory_order_relaxed);
+        result.affinity_hits += slots_[i].affinity_hits.load(std::memory_order_relaxed);
+        result.steals += slots_[i].steals.load(std::memory_order_relaxed);
+    }
+    return result;
 }
 
 } // namespace database
@@ -1,13 +1,20 @@
 #pragma once
 #include <string>
 #include <memory>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <cstdint>
 #include <expected>
 #include <optional>
+#include <span>
+#include <vector>
 #include <chrono>
+#include <thread>
+#include <stop_token>
 #include <pqxx/pqxx>
+#include "database/notification_listener.hpp"
+#include "database/statements.hpp"
 
 namespace database {
 
@@ -26,13 +33,40 @@ struct DatabaseConfig {
     std::string connection_string() const;
 };
 
+// プールの大きさと保守の設定
+struct PoolOptions {
+    size_t min_size = 2;    // 常に開いておく接続数（作成時にすべて接続する）
+    size_t max_size = 10;   // 需要に応じて増やす上限
+    std::chrono::milliseconds idle_timeout{60'000};          // min_size を超える接続を閉じるまでの未使用時間
+    std::chrono::milliseconds health_check_interval{15'000}; // 空き接続の生存確認の間隔
+    std::chrono::milliseconds reconnect_delay{100};          // 接続失敗後の待ち時間（失敗のたびに倍）
+    std::chrono::milliseconds max_reconnect_delay{10'000};
+    size_t async_connections = 0; // 非同期クエリ（AsyncPool）の接続数（0 なら作成しない）
+    std::chrono::milliseconds async_query_timeout{5'000};    // 非同期クエリの期限（投入から、接続待ちを含む）
+
+    // 大きさが固定のプール
+    static PoolOptions fixed(size_t size);
+
+    // 環境変数 DB_POOL_MIN / DB_POOL_MAX / DB_POOL_IDLE_TIMEOUT（秒）/ DB_ASYNC_CONNECTIONS /
+    // DB_ASYNC_QUERY_TIMEOUT（秒）から読み込む
+    // （未設定・不正な値は既定値）
+    static PoolOptions from_env();
+};
+
+// まとめて実行するプリペアドステートメントとそのパラメータ
+struct BatchQuery {
+    PreparedStatement statement;
+    StatementParams params;
+};
+
 // Forward declaration
 class ConnectionPool;
 
 // RAII ラッパーでPostgreSQL接続を管理
 class Connection {
 public:
-    Connection(std::unique_ptr<pqxx::connection> conn, ConnectionPool* pool);
+    // slot は接続を借りたプール内の位置（返却先）
+    Connection(std::unique_ptr<pqxx::connection> conn, ConnectionPool* pool, size_t slot);
     ~Connection();
 
     // コピー禁止、ムーブ可能
@@ -44,6 +78,13 @@ public:
     // クエリ実行
     std::expected<pqxx::result, std::string> execute(const std::string& query);
 
+    // プリペアドステートメントの実行（パラメータなし）
+    std::expected<pqxx::result, std::string> execute_prepared(const PreparedStatement& statement);
+
+    // 互いに依存しない複数のステートメントを pqxx::pipeline で1回の往復にまとめて実行
+    // （結果は queries と同じ順、どれかが失敗すれば全体をエラーとして返す）
+    std::expected<std::vector<pqxx::result>, std::string> execute_batch(std::span<const BatchQuery> queries);
+
     // トランザクション開始
     std::expected<std::unique_ptr<pqxx::work>, std::string> begin_transaction();
 
@@ -56,17 +97,50 @@ public:
 private:
     std::unique_ptr<pqxx::connection> conn_;
     ConnectionPool* pool_;
+    size_t slot_;
+};
+
+// プールの統計（各値は取得時点の概算）
+struct PoolMetrics {
+    size_t pool_size = 0;             // 開いている接続数
+    size_t max_size = 0;
+    size_t active = 0;                // 貸し出し中の接続数
+    size_t available = 0;             // 空いている接続数
+    std::uint64_t acquired = 0;       // 取得に成功した回数
+    std::uint64_t affinity_hits = 0;  // スレッドが前回使った接続をそのまま取得できた回数
+    std::uint64_t steals = 0;         // 前回使った接続が使用中のため、他の空き接続を取得した回数
+    std::uint64_t cas_failures = 0;   // 他スレッドと同じ接続を取り合って負けた回数
+    std::uint64_t waits = 0;          // 空きがなく待機に入った回数
+    std::uint64_t timeouts = 0;       // 待機がタイムアウトした回数
+    std::uint64_t wait_time_us = 0;   // 待機時間の合計
+    std::uint64_t connects = 0;           // 新しく開いた接続数（初期化時を含む）
+    std::uint64_t connect_failures = 0;
+    std::uint64_t closed_idle = 0;        // 未使用のため閉じた接続数
+    std::uint64_t closed_dead = 0;        // 切断を検知して捨てた接続数
 };
 
 // コネクションプール
+// 接続ごとのスロットを状態の CAS だけで貸し借りし、空きがあるときはロックを取らない。
+// 各スレッドは前回使ったスロットから探し始めるため、スレッド数が接続数以下なら
+// 同じ接続を使い続け、足りなければ他のスロットの空きを取りにいく。
+// すべて使用中なら max_size まで接続を増やし、それも無理なときだけミューテックスと
+// 条件変数で返却を待つ。
+// 切断された接続は返却時・取得時・生存確認で捨て、空いたスロットは次の取得か
+// 保守スレッドが再接続して埋める（失敗が続く間は間隔を倍にしながら再試行する）
 class ConnectionPool {
 public:
-    // プールの作成
+    // プールの作成（大きさ固定）
     static std::expected<ConnectionPool, std::string> create(
         const DatabaseConfig& config,
         size_t pool_size
     );
 
+    // プールの作成（min_size の接続を開き、max_size まで必要に応じて増やす）
+    static std::expected<ConnectionPool, std::string> create(
+        const DatabaseConfig& config,
+        const PoolOptions& options
+    );
+
     ~ConnectionPool();
 
     // コピー禁止、ムーブ可能
@@ -80,30 +154,131 @@ public:
         std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)
     );
 
+    // テーブルの変更通知を購読（start_change_listener() より前に呼び出すこと）
+    void subscribe_changes(std::string table, ChangeHandler handler);
+
+    // LISTEN 専用の接続で変更通知の受信を開始（プールの接続は使わない）
+    std::expected<void, std::string> start_change_listener();
+
+    // 保守スレッドを開始（未使用接続の縮小・生存確認・min_size までの補充）
+    // スレッドはプールのアドレスを参照するため、プールを移動し終えてから呼び出すこと
+    void start_maintenance();
+
+    // 保守を1回実行（通常は保守スレッドが呼び出す）
+    void run_maintenance();
+
     // 統計情報
-    size_t get_pool_size() const { return pool_size_; }
-    size_t get_active_connections() const { return active_connections_; }
+    size_t get_pool_size() const { return open_connections_.load(std::memory_order_relaxed); }
+    size_t get_max_size() const { return options_.max_size; }
+    size_t get_active_connections() const;
     size_t get_available_connections() const;
+    PoolMetrics metrics() const;
 
 private:
-    ConnectionPool(DatabaseConfig config, size_t pool_size);
+    enum class SlotState : std::uint8_t {
+        Free,        // 空き
+        InUse,       // 貸し出し中
+        Connecting,  // 新しい接続を開いている
+        Closed       // 接続がない（開けば使える）
+    };
+
+    // 隣のスロットと同じキャッシュラインに載らないよう揃える
+    struct alignas(64) Slot {
+        std::atomic<SlotState> state{SlotState::Closed};
+        // state を InUse にしたスレッドだけが触れる
+        std::unique_ptr<pqxx::connection> conn;
+        // 最後に返却された時刻（steady_clock のナノ秒）
+        std::atomic<std::int64_t> released_at{0};
+        // 接続を借りているスレッドだけが書き込む（読み取りは metrics()）
+        std::atomic<std::uint64_t> acquired{0};
+        std::atomic<std::uint64_t> affinity_hits{0};
+        std::atomic<std::uint64_t> steals{0};
+    };
 
-    // 新しい接続を作成
+    // 取得に失敗したときだけ更新するカウンタ
+    struct alignas(64) ContentionCounters {
+        std::atomic<std::uint64_t> cas_failures{0};
+        std::atomic<std::uint64_t> waits{0};
+        std::atomic<std::uint64_t> timeouts{0};
+        std::atomic<std::uint64_t> wait_time_us{0};
+        std::atomic<std::uint64_t> connects{0};
+        std::atomic<std::uint64_t> connect_failures{0};
+        std::atomic<std::uint64_t> closed_idle{0};
+        std::atomic<std::uint64_t> closed_dead{0};
+    };
+
+    // 待機に入る前に空きを探し直す回数
+    static constexpr int kSpinRounds = 16;
+
+    ConnectionPool(DatabaseConfig config, PoolOptions options);
+
+    // 空いている接続 → 新しい接続の順に取得を試す（ブロックしないが、接続を開く間は待つ）
+    std::optional<Connection> try_checkout();
+
+    // 空いているスロットを InUse にしてその位置を返す（なければ nullopt）
+    std::optional<size_t> try_acquire_slot();
+
+    // 接続のないスロットを Connecting にして新しい接続を開く（上限・再接続待ちの間は nullopt）
+    std::optional<size_t> try_grow();
+
+    // 取得したスロットの接続を Connection として貸し出す（切断されていれば捨てて nullopt）
+    std::optional<Connection> checkout(size_t slot);
+
+    // 待たずに取得できる見込みがあるか（空き接続、または今すぐ開ける空きスロット）
+    bool can_acquire_now() const;
+
+    // 新しい接続を作成（statements::kAll をすべて prepare する）
     std::expected<std::unique_ptr<pqxx::connection>, std::string> create_connection();
 
     // プールを初期化
     std::expected<void, std::string> initialize();
 
     // 接続を返却（RAIIパターンで自動）
-    void release(std::unique_ptr<pqxx::connection> conn);
+    void release(size_t slot, std::unique_ptr<pqxx::connection> conn);
+
+    // 保持しているスロットを空きに戻す
+    void make_available(size_t slot);
+
+    // 保持しているスロットの接続を閉じる
+    void close_slot(size_t slot, std::atomic<std::uint64_t>& reason);
+
+    // 待機中のスレッドへ空き（または空きスロット）ができたことを知らせる
+    void notify_waiters();
+
+    // 接続の成否を記録して再接続の間隔を調整
+    void record_connect_success();
+    void record_connect_failure(const std::string& error);
+
+    size_t count_slots(SlotState state) const;
+
+    void maintenance_loop(std::stop_token stop_token);
 
     DatabaseConfig config_;
-    size_t pool_size_;
-    std::atomic<size_t> active_connections_;
+    PoolOptions options_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> open_connections_{0};
+
+    ContentionCounters contention_;
+
+    // 次に接続を試してよい時刻（steady_clock のナノ秒）と、失敗時に待つ時間
+    std::atomic<std::int64_t> next_connect_at_{0};
+    std::atomic<std::int64_t> reconnect_delay_ms_{0};
+    mutable std::mutex error_mutex_;
+    std::string last_connect_error_;
+
+    // 空きを待っているスレッド数（0 なら返却時に通知しない）
+    std::atomic<size_t> waiters_{0};
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+
+    // 変更通知のリスナー（ムーブしてもアドレスが変わらないようヒープに置く）
+    std::unique_ptr<NotificationListener> listener_;
 
-    mutable std::mutex mutex_;
-    std::condition_variable cv_;
-    std::queue<std::unique_ptr<pqxx::connection>> available_connections_;
+    // 保守スレッド（接続が捨てられると補充のため起こす）
+    std::mutex maintenance_mutex_;
+    std::condition_variable_any maintenance_cv_;
+    bool replenish_requested_ = false;
+    std::jthread maintenance_thread_;
 
     friend class Connection;
 };
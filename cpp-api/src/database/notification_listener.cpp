@@ -0,0 +1,161 @@
+#include "database/notification_listener.hpp"
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <print>
+#include <pqxx/pqxx>
+
+namespace database {
+
+namespace {
+
+// await_notification のタイムアウト（停止要求の確認間隔）
+constexpr long kPollIntervalSec = 1;
+
+// 再接続の待ち時間（指数バックオフの上限）
+constexpr auto kMaxReconnectDelay = std::chrono::seconds(30);
+
+// チャネルの通知を受け取り、キューへ積むレシーバー
+class ChangeReceiver : public pqxx::notification_receiver {
+public:
+    ChangeReceiver(pqxx::connection& conn, std::string table, std::vector<ChangeEvent>& queue)
+        : pqxx::notification_receiver(conn, NotificationListener::channel_for(table))
+        , table_(std::move(table))
+        , queue_(queue) {}
+
+    void operator()(const std::string& payload, int) override {
+        queue_.push_back(NotificationListener::parse_payload(table_, payload));
+    }
+
+private:
+    std::string table_;
+    std::vector<ChangeEvent>& queue_;
+};
+
+} // namespace
+
+NotificationListener::NotificationListener(std::string connection_string)
+    : connection_string_(std::move(connection_string)) {}
+
+std::string NotificationListener::channel_for(std::string_view table) {
+    return std::format("{}_changed", table);
+}
+
+ChangeEvent NotificationListener::parse_payload(std::string_view table, std::string_view payload) {
+    auto separator = payload.find(':');
+    if (separator == std::string_view::npos) {
+        return ChangeEvent{std::string(table), std::string(payload), ""};
+    }
+    return ChangeEvent{
+        std::string(table),
+        std::string(payload.substr(0, separator)),
+        std::string(payload.substr(separator + 1))
+    };
+}
+
+void NotificationListener::subscribe(std::string table, ChangeHandler handler) {
+    if (std::find(tables_.begin(), tables_.end(), table) == tables_.end()) {
+        tables_.push_back(table);
+    }
+    subscriptions_.push_back(Subscription{std::move(table), std::move(handler)});
+}
+
+std::expected<void, std::string> NotificationListener::start() {
+    if (tables_.empty()) {
+        return std::unexpected("No change subscriptions registered");
+    }
+
+    // 起動時に接続できることを確認してからスレッドを開始
+    try {
+        pqxx::connection probe(connection_string_);
+    } catch (const std::exception& e) {
+        return std::unexpected(std::format("Listener connection failed: {}", e.what()));
+    }
+
+    thread_ = std::jthread([this](std::stop_token stop_token) { run(stop_token); });
+    return {};
+}
+
+void NotificationListener::dispatch(std::vector<ChangeEvent>& events) {
+    if (events.empty()) {
+        return;
+    }
+
+    for (const auto& table : tables_) {
+        std::vector<ChangeEvent> table_events;
+        for (const auto& event : events) {
+            if (event.table == table) {
+                table_events.push_back(event);
+            }
+        }
+        if (table_events.empty()) {
+            continue;
+        }
+
+        for (const auto& subscription : subscriptions_) {
+            if (subscription.table != table) {
+                continue;
+            }
+            try {
+                subscription.handler(table_events);
+            } catch (const std::exception& e) {
+                std::println("⚠️  Change handler for {} failed: {}", table, e.what());
+            }
+        }
+    }
+
+    events.clear();
+}
+
+void NotificationListener::run(std::stop_token stop_token) {
+    auto reconnect_delay = std::chrono::seconds(1);
+    bool first_connection = true;
+
+    while (!stop_token.stop_requested()) {
+        std::vector<ChangeEvent> events;
+
+        try {
+            pqxx::connection conn(connection_string_);
+
+            std::vector<std::unique_ptr<ChangeReceiver>> receivers;
+            for (const auto& table : tables_) {
+                receivers.push_back(std::make_unique<ChangeReceiver>(conn, table, events));
+            }
+
+            std::println("👂 Listening for changes on {} table(s)", tables_.size());
+            reconnect_delay = std::chrono::seconds(1);
+
+            // 切断中の変更は届かないため、再接続時はテーブル全体を無効化する
+            if (!first_connection) {
+                for (const auto& table : tables_) {
+                    events.push_back(ChangeEvent{table, "RESYNC", ""});
+                }
+                dispatch(events);
+            }
+            first_connection = false;
+
+            while (!stop_token.stop_requested()) {
+                if (conn.await_notification(kPollIntervalSec, 0) == 0) {
+                    continue;
+                }
+                // 続けて届いている通知もまとめて処理する（一括更新時の再構築回数を抑える）
+                while (conn.get_notifs() > 0) {}
+                dispatch(events);
+            }
+            return;
+
+        } catch (const std::exception& e) {
+            std::println("⚠️  Change listener disconnected: {} (retrying in {}s)",
+                         e.what(), reconnect_delay.count());
+        }
+
+        // 停止要求で即座に起きられるよう、短い間隔でスリープする
+        auto deadline = std::chrono::steady_clock::now() + reconnect_delay;
+        while (!stop_token.stop_requested() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        reconnect_delay = std::min(reconnect_delay * 2, kMaxReconnectDelay);
+    }
+}
+
+} // namespace database
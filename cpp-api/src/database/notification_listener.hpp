@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace database {
+
+// テーブルの行変更イベント（schema.sql のトリガーが NOTIFY する）
+struct ChangeEvent {
+    std::string table;      // "shops" / "users"
+    std::string operation;  // INSERT / UPDATE / DELETE / TRUNCATE / RESYNC
+    std::string id;         // 空の場合はテーブル全体の無効化
+
+    bool is_whole_table() const { return id.empty(); }
+};
+
+// 変更された行の ID（テーブル全体の無効化を含む場合は空）
+inline std::vector<std::string> changed_row_ids(const std::vector<ChangeEvent>& events) {
+    std::vector<std::string> ids;
+    for (const auto& event : events) {
+        if (event.is_whole_table()) {
+            return {};
+        }
+        ids.push_back(event.id);
+    }
+    return ids;
+}
+
+// 同じテーブルの変更イベントをまとめて受け取るハンドラー（リスナースレッドで呼ばれる）
+using ChangeHandler = std::function<void(const std::vector<ChangeEvent>&)>;
+
+// LISTEN 専用の接続で変更通知を受け取り、購読者へ配信する
+// 通知チャネルは "<table>_changed"、ペイロードは "<operation>:<id>"。
+// 接続が切れた場合は再接続し、取りこぼした可能性があるため
+// 全購読テーブルへ RESYNC（テーブル全体の無効化）を配信する
+class NotificationListener {
+public:
+    explicit NotificationListener(std::string connection_string);
+
+    NotificationListener(const NotificationListener&) = delete;
+    NotificationListener& operator=(const NotificationListener&) = delete;
+
+    // 購読の登録（start() より前に呼び出すこと）
+    void subscribe(std::string table, ChangeHandler handler);
+
+    // LISTEN 接続を確立してリスナースレッドを開始
+    std::expected<void, std::string> start();
+
+    // 通知チャネル名
+    static std::string channel_for(std::string_view table);
+
+    // ペイロードの解析（"<operation>:<id>"）
+    static ChangeEvent parse_payload(std::string_view table, std::string_view payload);
+
+private:
+    struct Subscription {
+        std::string table;
+        ChangeHandler handler;
+    };
+
+    // 受信したイベントを購読者へテーブル単位でまとめて配信
+    void dispatch(std::vector<ChangeEvent>& events);
+
+    void run(std::stop_token stop_token);
+
+    std::string connection_string_;
+    std::vector<Subscription> subscriptions_;
+    std::vector<std::string> tables_;
+
+    // 破棄時に停止要求と join が行われる（await_notification のタイムアウトで検知）
+    std::jthread thread_;
+};
+
+} // namespace database
@@ -0,0 +1,173 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace database {
+
+// 名前付きプリペアドステートメント
+struct PreparedStatement {
+    const char* name;
+    const char* sql;
+};
+
+// ステートメントのパラメータ（テキスト形式、nullopt は NULL）
+using StatementParams = std::vector<std::optional<std::string>>;
+
+// リポジトリが使用するステートメントの一覧
+// ConnectionPool::create_connection で接続ごとに一度だけ prepare され、
+// リポジトリは名前で実行する（毎回の構文解析・実行計画作成を省く）
+namespace statements {
+
+#define SPICE_SHOP_COLUMNS \
+    "id, name, address, latitude, longitude, region, " \
+    "spiciness, stimulation, aroma, rating, description, created_at, updated_at"
+
+#define SPICE_USER_COLUMNS \
+    "id, username, email, display_name, bio, " \
+    "pref_spiciness, pref_stimulation, pref_aroma, is_public, created_at, updated_at"
+
+// 動的に組み立てるクエリ用の列リスト
+inline constexpr const char* kShopColumns = SPICE_SHOP_COLUMNS;
+inline constexpr const char* kUserColumns = SPICE_USER_COLUMNS;
+
+// shops
+inline constexpr PreparedStatement kShopFindAll{
+    "shop_find_all",
+    "SELECT " SPICE_SHOP_COLUMNS " FROM shops ORDER BY id"
+};
+inline constexpr PreparedStatement kShopFindById{
+    "shop_find_by_id",
+    "SELECT " SPICE_SHOP_COLUMNS " FROM shops WHERE id = $1"
+};
+inline constexpr PreparedStatement kShopInsert{
+    "shop_insert",
+    "INSERT INTO shops (name, address, latitude, longitude, region, "
+    "spiciness, stimulation, aroma, rating, description) "
+    "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10) "
+    "RETURNING " SPICE_SHOP_COLUMNS
+};
+inline constexpr PreparedStatement kShopUpdate{
+    "shop_update",
+    "UPDATE shops SET name = $2, address = $3, latitude = $4, longitude = $5, region = $6, "
+    "spiciness = $7, stimulation = $8, aroma = $9, rating = $10, description = $11, "
+    "updated_at = CURRENT_TIMESTAMP "
+    "WHERE id = $1 "
+    "RETURNING " SPICE_SHOP_COLUMNS
+};
+inline constexpr PreparedStatement kShopDelete{
+    "shop_delete",
+    "DELETE FROM shops WHERE id = $1"
+};
+inline constexpr PreparedStatement kShopFindByRegion{
+    "shop_find_by_region",
+    "SELECT " SPICE_SHOP_COLUMNS " FROM shops WHERE region = $1 ORDER BY rating DESC"
+};
+inline constexpr PreparedStatement kShopFindAllByRating{
+    "shop_find_all_by_rating",
+    "SELECT " SPICE_SHOP_COLUMNS " FROM shops ORDER BY rating DESC, id ASC"
+};
+inline constexpr PreparedStatement kShopFindBySpiceRange{
+    "shop_find_by_spice_range",
+    "SELECT " SPICE_SHOP_COLUMNS " FROM shops WHERE spiciness BETWEEN $1 AND $2 "
+    "ORDER BY spiciness DESC, rating DESC"
+};
+
+// users
+inline constexpr PreparedStatement kUserFindAll{
+    "user_find_all",
+    "SELECT " SPICE_USER_COLUMNS " FROM users ORDER BY id"
+};
+inline constexpr PreparedStatement kUserFindFirstPage{
+    "user_find_first_page",
+    "SELECT " SPICE_USER_COLUMNS " FROM users ORDER BY id LIMIT $1"
+};
+inline constexpr PreparedStatement kUserFindPageAfter{
+    "user_find_page_after",
+    "SELECT " SPICE_USER_COLUMNS " FROM users WHERE id > $1 ORDER BY id LIMIT $2"
+};
+inline constexpr PreparedStatement kUserFindById{
+    "user_find_by_id",
+    "SELECT " SPICE_USER_COLUMNS " FROM users WHERE id = $1"
+};
+inline constexpr PreparedStatement kUserFindByUsername{
+    "user_find_by_username",
+    "SELECT " SPICE_USER_COLUMNS " FROM users WHERE username = $1"
+};
+inline constexpr PreparedStatement kUserFindByEmail{
+    "user_find_by_email",
+    "SELECT " SPICE_USER_COLUMNS " FROM users WHERE email = $1"
+};
+inline constexpr PreparedStatement kUserInsert{
+    "user_insert",
+    "INSERT INTO users (username, email, display_name, bio, "
+    "pref_spiciness, pref_stimulation, pref_aroma, is_public) "
+    "VALUES ($1, $2, $3, $4, $5, $6, $7, $8) "
+    "RETURNING id, created_at, updated_at"
+};
+// 複数行の一括登録（配列で受け取り、入力順に挿入）
+// UNIQUE 制約に触れる行は ON CONFLICT DO NOTHING で飛ばし、RETURNING に含まれない行を重複とみなす
+inline constexpr PreparedStatement kUserInsertBatch{
+    "user_insert_batch",
+    "INSERT INTO users (username, email, display_name, bio, "
+    "pref_spiciness, pref_stimulation, pref_aroma, is_public) "
+    "SELECT username, email, display_name, bio, "
+    "pref_spiciness, pref_stimulation, pref_aroma, is_public "
+    "FROM unnest($1::text[], $2::text[], $3::text[], $4::text[], "
+    "$5::int[], $6::int[], $7::int[], $8::boolean[]) "
+    "WITH ORDINALITY AS t(username, email, display_name, bio, "
+    "pref_spiciness, pref_stimulation, pref_aroma, is_public, ord) "
+    "ORDER BY ord "
+    "ON CONFLICT DO NOTHING "
+    "RETURNING id, username, email"
+};
+inline constexpr PreparedStatement kUserUpdate{
+    "user_update",
+    "UPDATE users SET username = $2, email = $3, display_name = $4, bio = $5, "
+    "pref_spiciness = $6, pref_stimulation = $7, pref_aroma = $8, "
+    "is_public = $9, updated_at = CURRENT_TIMESTAMP "
+    "WHERE id = $1 "
+    "RETURNING " SPICE_USER_COLUMNS
+};
+inline constexpr PreparedStatement kUserDelete{
+    "user_delete",
+    "DELETE FROM users WHERE id = $1"
+};
+
+// お気に入り・苦手な店舗（user_id の索引だけで引ける）
+inline constexpr PreparedStatement kUserFavoriteShopIds{
+    "user_favorite_shop_ids",
+    "SELECT shop_id FROM user_favorite_shops WHERE user_id = $1 ORDER BY created_at, shop_id"
+};
+inline constexpr PreparedStatement kUserDislikedShopIds{
+    "user_disliked_shop_ids",
+    "SELECT shop_id FROM user_disliked_shops WHERE user_id = $1 ORDER BY created_at, shop_id"
+};
+// ユーザーとお気に入り・苦手な店舗の ID 配列を1文で取得（AsyncPool は1往復に1文しか送らない）
+inline constexpr PreparedStatement kUserFindProfileById{
+    "user_find_profile_by_id",
+    "SELECT " SPICE_USER_COLUMNS ", "
+    "ARRAY(SELECT f.shop_id FROM user_favorite_shops f WHERE f.user_id = users.id "
+    "ORDER BY f.created_at, f.shop_id) AS favorite_shop_ids, "
+    "ARRAY(SELECT d.shop_id FROM user_disliked_shops d WHERE d.user_id = users.id "
+    "ORDER BY d.created_at, d.shop_id) AS disliked_shop_ids "
+    "FROM users WHERE id = $1"
+};
+
+#undef SPICE_SHOP_COLUMNS
+#undef SPICE_USER_COLUMNS
+
+// 接続作成時に prepare するステートメント
+inline constexpr std::array kAll{
+    kShopFindAll, kShopFindById, kShopInsert, kShopUpdate, kShopDelete,
+    kShopFindByRegion, kShopFindAllByRating, kShopFindBySpiceRange,
+    kUserFindAll, kUserFindFirstPage, kUserFindPageAfter,
+    kUserFindById, kUserFindByUsername, kUserFindByEmail,
+    kUserInsert, kUserInsertBatch, kUserUpdate, kUserDelete,
+    kUserFavoriteShopIds, kUserDislikedShopIds, kUserFindProfileById,
+};
+
+} // namespace statements
+
+} // namespace database
@@ -0,0 +1,135 @@
+#pragma once
+#include "shop.hpp"
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace domain {
+
+// 店舗一覧の並び順
+enum class ShopSort {
+    Id,              // id 昇順（デフォルト）
+    RatingDesc,      // 評価の高い順
+    SpicinessDesc,   // 辛い順
+    Name             // 店名順
+};
+
+// 範囲条件（未指定の端は制限なし、両端を含む）
+template <typename T>
+struct Range {
+    std::optional<T> min;
+    std::optional<T> max;
+
+    bool is_set() const { return min.has_value() || max.has_value(); }
+
+    bool contains(T value) const {
+        return (!min || value >= *min) && (!max || value <= *max);
+    }
+};
+
+// 緯度経度の矩形
+struct BoundingBox {
+    double min_latitude;
+    double min_longitude;
+    double max_latitude;
+    double max_longitude;
+
+    bool contains(double latitude, double longitude) const {
+        return latitude >= min_latitude && latitude <= max_latitude &&
+               longitude >= min_longitude && longitude <= max_longitude;
+    }
+};
+
+// キーセットページングの位置（直前のページの最後の店舗の並び替えキー）
+struct ShopCursor {
+    ShopSort sort = ShopSort::Id;
+    double rating = 0.0;      // RatingDesc のとき
+    int spiciness = 0;        // SpicinessDesc のとき
+    std::string name;         // Name のとき
+    std::string id;
+
+    static ShopCursor from(const Shop& shop, ShopSort sort) {
+        ShopCursor cursor;
+        cursor.sort = sort;
+        cursor.id = shop.id;
+        switch (sort) {
+        case ShopSort::RatingDesc: cursor.rating = shop.rating; break;
+        case ShopSort::SpicinessDesc: cursor.spiciness = shop.spice_params.spiciness; break;
+        case ShopSort::Name: cursor.name = shop.name; break;
+        case ShopSort::Id: break;
+        }
+        return cursor;
+    }
+};
+
+// 店舗一覧の検索条件
+// スナップショットでは matches() / before() で評価し、
+// PostgreSQL では PostgresShopRepository::compile_query() で1つの SQL に変換する
+struct ShopQuery {
+    std::optional<std::string> region;
+    Range<double> rating;
+    Range<int> spiciness;
+    Range<int> stimulation;
+    Range<int> aroma;
+    std::optional<BoundingBox> bounds;
+    ShopSort sort = ShopSort::Id;
+    std::optional<size_t> limit;
+    std::optional<ShopCursor> after;   // この位置より後ろだけを返す（sort と同じ並び順であること）
+
+    // 絞り込み条件が1つもないか（並び順・件数は含まない）
+    bool has_filters() const {
+        return region || rating.is_set() || spiciness.is_set() || stimulation.is_set() ||
+               aroma.is_set() || bounds || after;
+    }
+
+    bool matches(const Shop& shop) const {
+        return (!region || shop.region == *region) &&
+               rating.contains(shop.rating) &&
+               spiciness.contains(shop.spice_params.spiciness) &&
+               stimulation.contains(shop.spice_params.stimulation) &&
+               aroma.contains(shop.spice_params.aroma) &&
+               (!bounds || bounds->contains(shop.latitude, shop.longitude)) &&
+               (!after || is_after_cursor(shop));
+    }
+
+    // sort の順で after の位置より後ろか
+    bool is_after_cursor(const Shop& shop) const {
+        const auto& cursor = *after;
+        switch (sort) {
+        case ShopSort::RatingDesc:
+            if (shop.rating != cursor.rating) return shop.rating < cursor.rating;
+            break;
+        case ShopSort::SpicinessDesc:
+            if (shop.spice_params.spiciness != cursor.spiciness) return shop.spice_params.spiciness < cursor.spiciness;
+            break;
+        case ShopSort::Name:
+            if (shop.name != cursor.name) return shop.name > cursor.name;
+            break;
+        case ShopSort::Id:
+            break;
+        }
+        return shop.id > cursor.id;
+    }
+
+    // sort の順で a が b より前か（同順位は id 昇順）
+    bool before(const Shop& a, const Shop& b) const {
+        switch (sort) {
+        case ShopSort::RatingDesc:
+            if (a.rating != b.rating) return a.rating > b.rating;
+            break;
+        case ShopSort::SpicinessDesc:
+            if (a.spice_params.spiciness != b.spice_params.spiciness) {
+                return a.spice_params.spiciness > b.spice_params.spiciness;
+            }
+            break;
+        case ShopSort::Name:
+            if (a.name != b.name) return a.name < b.name;
+            break;
+        case ShopSort::Id:
+            break;
+        }
+        return a.id < b.id;
+    }
+};
+
+} // namespace domain
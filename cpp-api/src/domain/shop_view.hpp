@@ -0,0 +1,59 @@
+#pragma once
+#include "shop.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace domain {
+
+// 文字列を所有しない Shop のビュー
+// 参照先（Shop、リクエストアリーナ、データベースから読み込み中の行など）より長く保持しないこと
+struct ShopView {
+    std::string_view id;
+    std::string_view name;
+    std::string_view address;
+    std::optional<std::string_view> phone;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    std::string_view region;
+    SpiceParameters spice_params;
+    double rating = 0.0;
+    std::optional<std::string_view> description;
+    std::optional<std::string_view> image_url;
+
+    static ShopView of(const Shop& shop) {
+        auto optional_view = [](const std::optional<std::string>& value) -> std::optional<std::string_view> {
+            if (!value) return std::nullopt;
+            return std::string_view(*value);
+        };
+        return ShopView{shop.id, shop.name, shop.address, optional_view(shop.phone),
+                        shop.latitude, shop.longitude, shop.region, shop.spice_params, shop.rating,
+                        optional_view(shop.description), optional_view(shop.image_url)};
+    }
+
+    // shop へ書き写す（既存の文字列のバッファを再利用するため、使い回すとヒープ確保が起きにくい）
+    void assign_to(Shop& shop) const {
+        auto assign_optional = [](std::optional<std::string>& to, std::optional<std::string_view> from) {
+            if (!from) {
+                to.reset();
+            } else if (to) {
+                to->assign(*from);
+            } else {
+                to.emplace(*from);
+            }
+        };
+        shop.id.assign(id);
+        shop.name.assign(name);
+        shop.address.assign(address);
+        assign_optional(shop.phone, phone);
+        shop.latitude = latitude;
+        shop.longitude = longitude;
+        shop.region.assign(region);
+        shop.spice_params = spice_params;
+        shop.rating = rating;
+        assign_optional(shop.description, description);
+        assign_optional(shop.image_url, image_url);
+    }
+};
+
+} // namespace domain
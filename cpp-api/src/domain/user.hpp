@@ -48,4 +48,11 @@ struct User {
         , updated_at(std::chrono::system_clock::now()) {}
 };
 
+// ユーザーと、お気に入り・苦手な店舗の ID（GET /api/users/{id} のレスポンス）
+struct UserProfile {
+    User user;
+    std::vector<std::string> favorite_shop_ids;
+    std::vector<std::string> disliked_shop_ids;
+};
+
 } // namespace domain
@@ -0,0 +1,64 @@
+#include "http/chunked_writer.hpp"
+#include <format>
+#include <iterator>
+
+namespace http {
+
+ChunkedWriter::ChunkedWriter(OutputBuffer& output, FlushHandler flush, bool chunked)
+    : output_(output)
+    , flush_(std::move(flush))
+    , chunked_(chunked) {
+    pending_.reserve(kChunkSize);
+}
+
+bool ChunkedWriter::write(std::string_view data) {
+    if (failed_) {
+        return false;
+    }
+
+    pending_.append(data);
+    if (pending_.size() < kChunkSize) {
+        return true;
+    }
+
+    emit_chunk();
+    if (flush_ && output_.size() >= kFlushThreshold) {
+        failed_ = !flush_(output_);
+    }
+    return !failed_;
+}
+
+bool ChunkedWriter::finish() {
+    if (failed_) {
+        return false;
+    }
+
+    emit_chunk();
+    if (chunked_) {
+        output_.append(std::string("0\r\n\r\n"));
+    }
+    return true;
+}
+
+void ChunkedWriter::emit_chunk() {
+    if (pending_.empty()) {
+        return;
+    }
+
+    if (chunked_) {
+        // サイズ行 + データ + CRLF を1つのセグメントにまとめる
+        std::string chunk;
+        chunk.reserve(pending_.size() + 16);
+        std::format_to(std::back_inserter(chunk), "{:x}\r\n", pending_.size());
+        chunk += pending_;
+        chunk += "\r\n";
+        output_.append(std::move(chunk));
+        pending_.clear();
+    } else {
+        output_.append(std::move(pending_));
+        pending_ = std::string();
+        pending_.reserve(kChunkSize);
+    }
+}
+
+} // namespace http
@@ -0,0 +1,48 @@
+#pragma once
+#include "http/output_buffer.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace http {
+
+// output にたまったデータを送信する（送信済み分は output から取り除く、失敗時は false）
+using FlushHandler = std::function<bool(OutputBuffer&)>;
+
+// 長さの分からないボディを少しずつ output へ書き出す
+// chunked = true ではチャンク転送エンコーディングで、false（HTTP/1.0）では
+// そのままのバイト列として書き出す（接続を閉じてボディの終わりを示す）。
+// flush を渡すと output が一定量を超えるたびに送信するため、
+// ボディ全体をメモリに保持せずに済む
+class ChunkedWriter {
+public:
+    // チャンク1つの目安のサイズ
+    static constexpr size_t kChunkSize = 16 * 1024;
+
+    // output がこのサイズを超えたら flush する
+    static constexpr size_t kFlushThreshold = 64 * 1024;
+
+    explicit ChunkedWriter(OutputBuffer& output, FlushHandler flush = {}, bool chunked = true);
+
+    // ボディの一部を追記する（送信に失敗していれば false）
+    bool write(std::string_view data);
+
+    // 残りを書き出してボディを終端する（chunked なら終端チャンクを追加）
+    bool finish();
+
+    // 送信に失敗したか（以降の書き込みは捨てられる）
+    bool failed() const { return failed_; }
+
+private:
+    OutputBuffer& output_;
+    FlushHandler flush_;
+    bool chunked_;
+    bool failed_ = false;
+    std::string pending_;
+
+    // pending_ をチャンクとして output へ移す
+    void emit_chunk();
+};
+
+} // namespace http
@@ -0,0 +1,90 @@
+#include "http/output_buffer.hpp"
+
+namespace http {
+
+namespace {
+
+// この長さ未満の所有データ同士は連結する
+// （ヘッダーと小さなボディを1つの iovec にまとめ、大きなボディはコピーしない）
+constexpr size_t kCoalesceLimit = 4 * 1024;
+
+} // namespace
+
+void OutputBuffer::append(std::string data) {
+    if (data.empty()) {
+        return;
+    }
+    size_ += data.size();
+
+    if (data.size() < kCoalesceLimit && !segments_.empty()) {
+        auto& last = segments_.back();
+        if (!last.shared && last.owned.size() < kCoalesceLimit) {
+            last.owned += data;
+            return;
+        }
+    }
+
+    segments_.push_back(Segment{std::move(data), nullptr});
+}
+
+void OutputBuffer::append(std::shared_ptr<const std::string> data) {
+    if (!data || data->empty()) {
+        return;
+    }
+    size_ += data->size();
+    segments_.push_back(Segment{std::string(), std::move(data)});
+}
+
+size_t OutputBuffer::fill_iovecs(iovec* iov, size_t max_iov) const {
+    size_t count = 0;
+    size_t offset = front_offset_;
+
+    for (const auto& segment : segments_) {
+        if (count == max_iov) {
+            break;
+        }
+        auto data = segment.view().substr(offset);
+        iov[count].iov_base = const_cast<char*>(data.data());
+        iov[count].iov_len = data.size();
+        ++count;
+        offset = 0;
+    }
+
+    return count;
+}
+
+void OutputBuffer::consume(size_t n) {
+    size_ -= n;
+
+    while (n > 0 && !segments_.empty()) {
+        size_t remaining = segments_.front().view().size() - front_offset_;
+        if (n < remaining) {
+            front_offset_ += n;
+            return;
+        }
+        n -= remaining;
+        segments_.pop_front();
+        front_offset_ = 0;
+    }
+}
+
+void OutputBuffer::clear() {
+    segments_.clear();
+    front_offset_ = 0;
+    size_ = 0;
+}
+
+std::string OutputBuffer::to_string() const {
+    std::string result;
+    result.reserve(size_);
+
+    size_t offset = front_offset_;
+    for (const auto& segment : segments_) {
+        result += segment.view().substr(offset);
+        offset = 0;
+    }
+
+    return result;
+}
+
+} // namespace http
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+
+namespace http {
+
+// 送信待ちデータのキュー（scatter/gather 送信用）
+// ヘッダーや小さなボディは所有文字列として連結し、大きなボディや
+// 事前レンダリング済みの共有バッファはコピーせずセグメントとして保持する。
+// writev/sendmsg にはセグメントをそのまま iovec として渡す
+class OutputBuffer {
+public:
+    // 所有文字列を追加（末尾が小さな所有セグメントなら連結する）
+    void append(std::string data);
+
+    // 共有バッファを参照として追加（コピーしない）
+    void append(std::shared_ptr<const std::string> data);
+
+    bool empty() const { return segments_.empty(); }
+
+    // 未送信のバイト数
+    size_t size() const { return size_; }
+
+    // 未送信のセグメント数
+    size_t segment_count() const { return segments_.size(); }
+
+    // 未送信データを iovec に詰める（詰めた数を返す）
+    size_t fill_iovecs(iovec* iov, size_t max_iov) const;
+
+    // 送信済みの n バイトを取り除く（部分書き込みに対応）
+    void consume(size_t n);
+
+    void clear();
+
+    // 連結された未送信データ（テスト・デバッグ用）
+    std::string to_string() const;
+
+private:
+    struct Segment {
+        std::string owned;
+        std::shared_ptr<const std::string> shared;
+
+        std::string_view view() const {
+            return shared ? std::string_view(*shared) : std::string_view(owned);
+        }
+    };
+
+    std::deque<Segment> segments_;
+    size_t front_offset_ = 0;   // 先頭セグメントの送信済みバイト数
+    size_t size_ = 0;
+};
+
+} // namespace http
@@ -0,0 +1,72 @@
+#include "http/query_params.hpp"
+#include <algorithm>
+
+namespace http {
+
+namespace {
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool needs_decode(std::string_view value) {
+    return value.find_first_of("%+") != std::string_view::npos;
+}
+
+} // namespace
+
+std::string_view percent_decode(std::string_view value, RequestArena& arena) {
+    if (!needs_decode(value)) {
+        return value;
+    }
+
+    // デコード後は元の長さ以下になる
+    auto out = arena.allocate(value.size());
+    size_t n = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '%' && i + 2 < value.size() &&
+            hex_value(value[i + 1]) >= 0 && hex_value(value[i + 2]) >= 0) {
+            out[n++] = static_cast<char>(hex_value(value[i + 1]) * 16 + hex_value(value[i + 2]));
+            i += 2;
+        } else if (value[i] == '+') {
+            out[n++] = ' ';
+        } else {
+            out[n++] = value[i];
+        }
+    }
+    return {out.data(), n};
+}
+
+void QueryParams::iterator::advance() {
+    // 空のパラメータ（"a=1&&b=2" の間など）は飛ばす
+    while (!rest_.empty()) {
+        size_t amp = rest_.find('&');
+        std::string_view pair = rest_.substr(0, amp);
+        rest_ = amp == std::string_view::npos ? std::string_view(rest_.data() + rest_.size(), 0)
+                                              : rest_.substr(amp + 1);
+        if (pair.empty()) {
+            continue;
+        }
+
+        size_t eq = pair.find('=');
+        std::string_view name = pair.substr(0, eq);
+        std::string_view value = eq == std::string_view::npos ? std::string_view() : pair.substr(eq + 1);
+        current_ = QueryParam{percent_decode(name, *arena_), percent_decode(value, *arena_)};
+        done_ = false;
+        return;
+    }
+    done_ = true;
+}
+
+std::optional<std::string_view> QueryParams::find(std::string_view name) const {
+    auto it = std::ranges::find_if(*this, [name](const QueryParam& param) { return param.name == name; });
+    if (it == end()) {
+        return std::nullopt;
+    }
+    return it->value;
+}
+
+} // namespace http
@@ -0,0 +1,69 @@
+#pragma once
+#include "http/request_arena.hpp"
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+namespace http {
+
+// クエリ文字列の1パラメータ（デコード済み）
+struct QueryParam {
+    std::string_view name;
+    std::string_view value;
+};
+
+// パーセントエンコードされた値をデコードする（'+' は空白、不正な %xx はそのまま）
+// エンコードを含まなければ入力をそのまま返し、含む場合だけ arena に書き出す
+std::string_view percent_decode(std::string_view value, RequestArena& arena);
+
+// クエリ文字列（'?' 以降）を走査するビュー
+// 受信バッファを参照したまま '&' 区切りで順に取り出し、パーセントデコードが
+// 必要な名前・値だけをリクエストアリーナへ書き出す（コピー・ヒープ確保をしない）。
+// '=' のないパラメータの値は空文字列になる
+class QueryParams {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = QueryParam;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(std::string_view rest, RequestArena* arena) : rest_(rest), arena_(arena) { advance(); }
+
+        const QueryParam& operator*() const { return current_; }
+        const QueryParam* operator->() const { return &current_; }
+        iterator& operator++() { advance(); return *this; }
+        iterator operator++(int) { auto copy = *this; advance(); return copy; }
+
+        bool operator==(const iterator& other) const { return done_ == other.done_ && (done_ || rest_.data() == other.rest_.data()); }
+
+    private:
+        std::string_view rest_;
+        RequestArena* arena_ = nullptr;
+        QueryParam current_;
+        bool done_ = true;
+
+        void advance();
+    };
+
+    QueryParams() = default;
+    QueryParams(std::string_view query, RequestArena& arena) : query_(query), arena_(&arena) {}
+
+    iterator begin() const { return arena_ ? iterator(query_, arena_) : iterator(); }
+    iterator end() const { return {}; }
+
+    // 最初に現れた name の値
+    std::optional<std::string_view> find(std::string_view name) const;
+
+    bool contains(std::string_view name) const { return find(name).has_value(); }
+
+    bool empty() const { return query_.empty(); }
+
+private:
+    std::string_view query_;
+    RequestArena* arena_ = nullptr;
+};
+
+} // namespace http
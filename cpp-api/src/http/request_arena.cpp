@@ -0,0 +1,29 @@
+#include "http/request_arena.hpp"
+#include <algorithm>
+
+namespace http {
+
+namespace {
+
+// アリーナのブロックをすべてプールで保持できるようにする
+// （これより大きなブロックは毎回ヒープから確保される）
+constexpr size_t kLargestPooledBlock = 4 * 1024 * 1024;
+
+} // namespace
+
+RequestArena::RequestArena()
+    : pool_(std::pmr::pool_options{0, kLargestPooledBlock})
+    , resource_(kInitialSize, &pool_) {}
+
+std::string_view RequestArena::copy(std::string_view s) {
+    auto out = allocate(s.size());
+    std::ranges::copy(s, out.begin());
+    return {out.data(), out.size()};
+}
+
+RequestArena& RequestArena::for_this_thread() {
+    thread_local RequestArena arena;
+    return arena;
+}
+
+} // namespace http
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+
+namespace http {
+
+// 1リクエストの処理中だけ使うメモリ領域（リクエストアリーナ）
+// std::pmr::monotonic_buffer_resource で切り出して個別には解放せず、reset() でまとめて捨てる。
+// 捨てたブロックは上流のプールに残って次のリクエストで再利用されるため、
+// ウォームアップ後はヒープを確保しない。スレッドをまたいで共有しない
+class RequestArena {
+public:
+    // 最初に確保するブロックのサイズ（足りなければ倍々に追加する）
+    static constexpr size_t kInitialSize = 16 * 1024;
+
+    RequestArena();
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    // n バイトの書き込み領域
+    std::span<char> allocate(size_t n) {
+        return {static_cast<char*>(resource_.allocate(n, 1)), n};
+    }
+
+    // 文字列をアリーナへコピー
+    std::string_view copy(std::string_view s);
+
+    // std::pmr コンテナ用のメモリリソース
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+    // このリクエストで確保したメモリをすべて捨てる
+    void reset() { resource_.release(); }
+
+    // 呼び出しスレッドのアリーナ
+    static RequestArena& for_this_thread();
+
+    // スコープを抜けるときに reset する
+    class Scope {
+    public:
+        explicit Scope(RequestArena& arena) : arena_(arena) {}
+        ~Scope() { arena_.reset(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RequestArena& arena_;
+    };
+
+private:
+    std::pmr::unsynchronized_pool_resource pool_;   // 捨てたブロックを保持する
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+} // namespace http
@@ -0,0 +1,384 @@
+#include "http/request_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+namespace http {
+
+namespace {
+
+// ヘッダー数の上限
+constexpr size_t kMaxHeaders = 100;
+
+// チャンクサイズ行の長さの上限（拡張を含む）
+constexpr size_t kMaxChunkLineBytes = 1024;
+
+bool iequals(std::string_view a, std::string_view b) {
+    return std::ranges::equal(a, b, [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// カンマ区切りのトークンリストに token が含まれるか
+bool contains_token(std::string_view list, std::string_view token) {
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        if (iequals(trim(list.substr(0, comma)), token)) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+// RFC 9110 の token 文字か
+bool is_token_char(char c) {
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+        return true;
+    }
+    return std::string_view("!#$%&'*+-.^_`|~").find(c) != std::string_view::npos;
+}
+
+} // namespace
+
+std::optional<std::string_view> Request::header(std::string_view name) const {
+    std::string_view rest = header_block;
+    while (!rest.empty()) {
+        size_t line_end = rest.find("\r\n");
+        std::string_view line = rest.substr(0, line_end);
+        rest = line_end == std::string_view::npos ? std::string_view() : rest.substr(line_end + 2);
+
+        size_t colon = line.find(':');
+        if (colon != std::string_view::npos && iequals(line.substr(0, colon), name)) {
+            return trim(line.substr(colon + 1));
+        }
+    }
+    return std::nullopt;
+}
+
+RequestParser::RequestParser(size_t max_header_bytes, size_t max_body_bytes)
+    : max_header_bytes_(max_header_bytes)
+    , max_body_bytes_(max_body_bytes) {
+    reset();
+}
+
+void RequestParser::reset() {
+    state_ = State::Head;
+    head_start_ = 0;
+    scan_ = 0;
+    body_start_ = 0;
+    body_end_ = 0;
+    content_length_ = 0;
+    chunk_remaining_ = 0;
+    trailers_start_ = 0;
+    chunked_ = false;
+    keep_alive_ = true;
+    version_minor_ = 1;
+    method_ = {};
+    target_ = {};
+    headers_ = {};
+    consumed_ = 0;
+    error_status_ = 0;
+    error_message_ = {};
+}
+
+ParseStatus RequestParser::fail(int status, std::string_view message) {
+    error_status_ = status;
+    error_message_ = message;
+    return ParseStatus::Error;
+}
+
+ParseStatus RequestParser::parse(std::string& buffer, size_t offset) {
+    if (error_status_ != 0) {
+        return ParseStatus::Error;
+    }
+
+    char* base = buffer.data() + offset;
+    const size_t available = buffer.size() - offset;
+    std::string_view data(base, available);
+
+    while (true) {
+        switch (state_) {
+        case State::Head: {
+            // パイプライン間の余分な空行は無視する（RFC 9112 2.2）
+            while (head_start_ + 1 < available &&
+                   data[head_start_] == '\r' && data[head_start_ + 1] == '\n') {
+                head_start_ += 2;
+                scan_ = std::max(scan_, head_start_);
+            }
+
+            // 前回探索済みの位置から再開
+            size_t from = std::max(head_start_, scan_ >= 3 ? scan_ - 3 : 0);
+            size_t end = data.find("\r\n\r\n", from);
+            if (end == std::string_view::npos) {
+                if (available - head_start_ > max_header_bytes_) {
+                    return fail(431, "Request header fields too large");
+                }
+                scan_ = available;
+                return ParseStatus::Incomplete;
+            }
+            if (end - head_start_ > max_header_bytes_) {
+                return fail(431, "Request header fields too large");
+            }
+
+            if (auto status = parse_head(data.substr(0, end)); status != ParseStatus::Complete) {
+                return status;
+            }
+
+            scan_ = end + 4;
+            body_start_ = scan_;
+            body_end_ = scan_;
+
+            if (chunked_) {
+                state_ = State::ChunkSize;
+            } else if (content_length_ > 0) {
+                state_ = State::Body;
+            } else {
+                state_ = State::Done;
+            }
+            break;
+        }
+
+        case State::Body: {
+            if (available - body_start_ < content_length_) {
+                return ParseStatus::Incomplete;
+            }
+            body_end_ = body_start_ + content_length_;
+            scan_ = body_end_;
+            state_ = State::Done;
+            break;
+        }
+
+        case State::ChunkSize: {
+            size_t line_end = data.find("\r\n", scan_);
+            if (line_end == std::string_view::npos) {
+                if (available - scan_ > kMaxChunkLineBytes) {
+                    return fail(400, "Chunk size line too long");
+                }
+                return ParseStatus::Incomplete;
+            }
+
+            // チャンク拡張（';' 以降）は無視
+            std::string_view line = data.substr(scan_, line_end - scan_);
+            line = trim(line.substr(0, line.find(';')));
+
+            size_t size = 0;
+            auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+            if (line.empty() || ec != std::errc{} || ptr != line.data() + line.size()) {
+                return fail(400, "Invalid chunk size");
+            }
+
+            scan_ = line_end + 2;
+            if (size == 0) {
+                trailers_start_ = scan_;
+                state_ = State::Trailers;
+                break;
+            }
+            // size は 16 進数の任意の値なので、足し算で桁あふれしないよう残りと比べる
+            if (size > max_body_bytes_ - (body_end_ - body_start_)) {
+                return fail(413, "Request body too large");
+            }
+
+            chunk_remaining_ = size;
+            state_ = State::ChunkData;
+            break;
+        }
+
+        case State::ChunkData: {
+            // 届いている分だけデコード済み領域の末尾へ詰める（チャンクヘッダーを上書き）
+            size_t n = std::min(chunk_remaining_, available - scan_);
+            if (n > 0 && body_end_ != scan_) {
+                std::memmove(base + body_end_, base + scan_, n);
+            }
+            body_end_ += n;
+            scan_ += n;
+            chunk_remaining_ -= n;
+
+            if (chunk_remaining_ > 0) {
+                return ParseStatus::Incomplete;
+            }
+            state_ = State::ChunkDataEnd;
+            break;
+        }
+
+        case State::ChunkDataEnd: {
+            if (available - scan_ < 2) {
+                return ParseStatus::Incomplete;
+            }
+            if (data[scan_] != '\r' || data[scan_ + 1] != '\n') {
+                return fail(400, "Invalid chunk terminator");
+            }
+            scan_ += 2;
+            state_ = State::ChunkSize;
+            break;
+        }
+
+        case State::Trailers: {
+            // トレーラーは読み飛ばし、空行で終了
+            // 行数に関係なくトレーラー部全体をヘッダーと同じ上限で制限する
+            size_t line_end = data.find("\r\n", scan_);
+            size_t trailers_end = (line_end == std::string_view::npos) ? available : line_end;
+            if (trailers_end - trailers_start_ > max_header_bytes_) {
+                return fail(431, "Request trailer fields too large");
+            }
+            if (line_end == std::string_view::npos) {
+                return ParseStatus::Incomplete;
+            }
+            bool last = (line_end == scan_);
+            scan_ = line_end + 2;
+            if (last) {
+                state_ = State::Done;
+            }
+            break;
+        }
+
+        case State::Done:
+            consumed_ = scan_;
+            build_request(base);
+            return ParseStatus::Complete;
+        }
+    }
+}
+
+ParseStatus RequestParser::parse_head(std::string_view data) {
+    std::string_view head = data.substr(head_start_);
+
+    // リクエストライン: METHOD SP request-target SP HTTP-version
+    size_t line_end = head.find("\r\n");
+    std::string_view request_line = head.substr(0, line_end);
+
+    size_t sp1 = request_line.find(' ');
+    size_t sp2 = (sp1 == std::string_view::npos) ? sp1 : request_line.find(' ', sp1 + 1);
+    if (sp1 == std::string_view::npos || sp2 == std::string_view::npos || sp1 == 0 || sp2 == sp1 + 1) {
+        return fail(400, "Malformed request line");
+    }
+
+    std::string_view method = request_line.substr(0, sp1);
+    std::string_view version = request_line.substr(sp2 + 1);
+
+    if (!std::ranges::all_of(method, is_token_char)) {
+        return fail(400, "Malformed request method");
+    }
+    if (version == "HTTP/1.1") {
+        version_minor_ = 1;
+    } else if (version == "HTTP/1.0") {
+        version_minor_ = 0;
+    } else {
+        return fail(505, "HTTP version not supported");
+    }
+
+    // HTTP/1.1 はデフォルトで keep-alive、HTTP/1.0 は明示された場合のみ
+    keep_alive_ = (version_minor_ == 1);
+
+    method_ = {static_cast<uint32_t>(head_start_), static_cast<uint32_t>(sp1)};
+    target_ = {static_cast<uint32_t>(head_start_ + sp1 + 1), static_cast<uint32_t>(sp2 - sp1 - 1)};
+
+    // ヘッダー行の範囲だけを記録し、個々のヘッダーは Request::header() で必要になってから取り出す
+    if (line_end != std::string_view::npos) {
+        headers_ = {static_cast<uint32_t>(head_start_ + line_end + 2),
+                    static_cast<uint32_t>(head.size() - line_end - 2)};
+    }
+
+    bool has_content_length = false;
+    bool has_transfer_encoding = false;
+    size_t header_count = 0;
+
+    while (line_end != std::string_view::npos) {
+        size_t line_start = line_end + 2;
+        line_end = head.find("\r\n", line_start);
+        std::string_view line = head.substr(line_start, line_end == std::string_view::npos
+                                                            ? std::string_view::npos
+                                                            : line_end - line_start);
+
+        // obs-fold は受け付けない（RFC 9112 5.2）
+        if (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+            return fail(400, "Obsolete header line folding");
+        }
+
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0 ||
+            !std::ranges::all_of(line.substr(0, colon), is_token_char)) {
+            return fail(400, "Malformed header field");
+        }
+
+        if (++header_count > kMaxHeaders) {
+            return fail(431, "Too many header fields");
+        }
+
+        std::string_view name = line.substr(0, colon);
+        std::string_view value = trim(line.substr(colon + 1));
+
+        if (iequals(name, "Content-Length")) {
+            size_t length = 0;
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), length);
+            if (value.empty() || ec != std::errc{} || ptr != value.data() + value.size()) {
+                return fail(400, "Invalid Content-Length");
+            }
+            if (has_content_length && length != content_length_) {
+                return fail(400, "Conflicting Content-Length");
+            }
+            has_content_length = true;
+            content_length_ = length;
+        } else if (iequals(name, "Transfer-Encoding")) {
+            has_transfer_encoding = true;
+            // chunked 以外のコーディング（gzip 等）には対応しない
+            if (!iequals(value, "chunked")) {
+                return fail(501, "Unsupported transfer encoding");
+            }
+            chunked_ = true;
+        } else if (iequals(name, "Connection")) {
+            if (contains_token(value, "close")) {
+                keep_alive_ = false;
+            } else if (contains_token(value, "keep-alive")) {
+                keep_alive_ = true;
+            }
+        }
+    }
+
+    // Content-Length と Transfer-Encoding の併用はリクエストスマグリング対策で拒否
+    if (has_content_length && has_transfer_encoding) {
+        return fail(400, "Both Content-Length and Transfer-Encoding present");
+    }
+    if (content_length_ > max_body_bytes_) {
+        return fail(413, "Request body too large");
+    }
+
+    return ParseStatus::Complete;
+}
+
+void RequestParser::build_request(const char* base) {
+    auto view = [base](Span span) {
+        return std::string_view(base + span.pos, span.len);
+    };
+
+    request_.method = view(method_);
+    request_.target = view(target_);
+
+    auto query_pos = request_.target.find('?');
+    if (query_pos == std::string_view::npos) {
+        request_.path = request_.target;
+        request_.query = {};
+    } else {
+        request_.path = request_.target.substr(0, query_pos);
+        request_.query = request_.target.substr(query_pos + 1);
+    }
+
+    request_.version_minor = version_minor_;
+
+    request_.header_block = view(headers_);
+
+    request_.body = std::string_view(base + body_start_, body_end_ - body_start_);
+    request_.keep_alive = keep_alive_;
+}
+
+} // namespace http
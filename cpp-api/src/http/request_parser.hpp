@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace http {
+
+// パース済みHTTPリクエスト
+// すべてのフィールドは接続バッファへの string_view で、
+// バッファが変更されるまで（次の parse 呼び出しまで）有効
+struct Request {
+    std::string_view method;
+    std::string_view target;  // パス + クエリ文字列
+    std::string_view path;
+    std::string_view query;   // '?' 以降（'?' は含まない）
+    int version_minor = 1;    // HTTP/1.x の x
+    std::string_view header_block;  // リクエストライン以降のヘッダー行（解析時に検証済み）
+    std::string_view body;    // チャンク形式の場合はデコード済み
+    bool keep_alive = true;
+
+    // ヘッダーの検索（名前は大文字小文字を区別しない）
+    // header_block を呼び出しのたびに走査する（ヘッダーを一覧として保持しない）
+    std::optional<std::string_view> header(std::string_view name) const;
+};
+
+// パース結果
+enum class ParseStatus {
+    Complete,   // 1リクエスト分の解析が完了
+    Incomplete, // データ不足（受信後に再度呼び出す）
+    Error       // 不正なリクエスト
+};
+
+// 再開可能な HTTP/1.1 リクエストパーサー（接続ごとに1つ保持する）
+// 読み込みのたびに parse() を呼ぶと前回の続きから解析を再開する。
+// Content-Length とチャンク転送エンコーディングに対応し、
+// チャンクはバッファ内でその場でデコードするためボディをコピーしない
+class RequestParser {
+public:
+    explicit RequestParser(size_t max_header_bytes = 16 * 1024,
+                           size_t max_body_bytes = 1024 * 1024);
+
+    // buffer[offset..] から1リクエストを解析する
+    // Incomplete の場合、同じリクエストの先頭位置を offset に渡して再度呼び出す
+    // （その間にバッファ先頭の処理済みデータを削除して offset が変わっても構わない）
+    ParseStatus parse(std::string& buffer, size_t offset);
+
+    // 解析結果（Complete の場合のみ有効）
+    const Request& request() const { return request_; }
+
+    // 完了したリクエストが占めていたバイト数（offset からの相対）
+    size_t consumed() const { return consumed_; }
+
+    // エラー時のHTTPステータスコードとメッセージ
+    int error_status() const { return error_status_; }
+    std::string_view error_message() const { return error_message_; }
+
+    // 次のリクエストに備えて状態を初期化
+    void reset();
+
+private:
+    enum class State {
+        Head,          // リクエストライン + ヘッダー
+        Body,          // Content-Length のボディ
+        ChunkSize,     // チャンクサイズ行
+        ChunkData,     // チャンクデータ
+        ChunkDataEnd,  // チャンクデータ末尾の CRLF
+        Trailers,      // トレーラー
+        Done
+    };
+
+    // バッファ内の位置（リクエスト先頭からの相対オフセット）
+    struct Span {
+        uint32_t pos = 0;
+        uint32_t len = 0;
+    };
+
+    ParseStatus parse_head(std::string_view head);
+    ParseStatus fail(int status, std::string_view message);
+    void build_request(const char* base);
+
+    size_t max_header_bytes_;
+    size_t max_body_bytes_;
+
+    State state_;
+    size_t head_start_;       // 先頭の空行をスキップした位置
+    size_t scan_;             // 次に解析する位置
+    size_t body_start_;
+    size_t body_end_;         // デコード済みボディの末尾
+    size_t content_length_;
+    size_t chunk_remaining_;
+    size_t trailers_start_;   // トレーラー部の先頭（全体の大きさを制限する）
+    bool chunked_;
+    bool keep_alive_;
+    int version_minor_;
+
+    Span method_;
+    Span target_;
+    Span headers_;
+
+    Request request_;
+    size_t consumed_;
+    int error_status_;
+    std::string_view error_message_;
+};
+
+} // namespace http
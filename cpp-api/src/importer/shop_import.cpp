@@ -0,0 +1,514 @@
+#include "importer/shop_import.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <format>
+#include <limits>
+#include <mutex>
+#include <print>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+
+namespace importer {
+
+using json = nlohmann::json;
+
+namespace {
+
+// UTF-8 の文字数（VARCHAR(n) の n と比べる）
+size_t utf8_length(std::string_view s) {
+    return static_cast<size_t>(std::count_if(s.begin(), s.end(), [](char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+    }));
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// 前後の空白を除いた全体が数値のときだけ値を返す
+template <class T>
+std::optional<T> parse_number(std::string_view s) {
+    s = trim(s);
+    T value{};
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (s.empty() || ec != std::errc() || end != s.data() + s.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// 空文字列は NULL として扱う
+std::optional<std::string> optional_text(std::string_view s) {
+    if (s.empty()) {
+        return std::nullopt;
+    }
+    return std::string(s);
+}
+
+// 検証を通った店舗だけを追加（同じ id は最初の1件）
+void accept(ParsedShops& parsed, std::unordered_set<std::string>& ids,
+            domain::Shop shop, const std::string& location) {
+    if (auto valid = validate_shop(shop); !valid) {
+        parsed.rejected.push_back(std::format("{}: {}", location, valid.error()));
+        return;
+    }
+    if (!ids.insert(shop.id).second) {
+        parsed.rejected.push_back(std::format("{}: duplicate id {}", location, shop.id));
+        return;
+    }
+    parsed.shops.push_back(std::move(shop));
+}
+
+// JSON の任意の文字列項目（欠落・null・空文字列は nullopt）
+std::optional<std::string> json_text(const json& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end() || it->is_null()) {
+        return std::nullopt;
+    }
+    return optional_text(it->get<std::string>());
+}
+
+domain::Shop shop_from_json(const json& object) {
+    domain::Shop shop;
+
+    // id は文字列・数値のどちらも受け付ける
+    const auto& id = object.at("id");
+    shop.id = id.is_string() ? id.get<std::string>() : id.dump();
+    shop.name = object.at("name").get<std::string>();
+    shop.address = object.at("address").get<std::string>();
+    shop.phone = json_text(object, "phone");
+    shop.latitude = object.at("latitude").get<double>();
+    shop.longitude = object.at("longitude").get<double>();
+    shop.region = object.value("region", std::string());
+
+    if (auto it = object.find("spiceParameters"); it != object.end()) {
+        shop.spice_params.spiciness = it->at("spiciness").get<int>();
+        shop.spice_params.stimulation = it->at("stimulation").get<int>();
+        shop.spice_params.aroma = it->at("aroma").get<int>();
+    }
+
+    shop.rating = object.value("rating", 0.0);
+    shop.description = json_text(object, "description");
+    shop.image_url = json_text(object, "imageUrl");
+    if (!shop.image_url) {
+        shop.image_url = json_text(object, "image_url");
+    }
+
+    return shop;
+}
+
+// RFC 4180 の1レコードを fields に読む（引用符内の改行と "" に対応）
+// 入力の終わりなら false、閉じられていない引用符はエラー
+std::expected<bool, std::string> read_csv_record(std::string_view input, size_t& pos,
+                                                 std::vector<std::string>& fields) {
+    fields.clear();
+    if (pos >= input.size()) {
+        return false;
+    }
+
+    std::string field;
+    bool quoted = false;
+    while (pos < input.size()) {
+        char c = input[pos++];
+        if (quoted) {
+            if (c != '"') {
+                field += c;
+            } else if (pos < input.size() && input[pos] == '"') {
+                field += '"';
+                ++pos;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(std::move(field));
+            field.clear();
+        } else if (c == '\n') {
+            break;
+        } else if (c != '\r') {
+            field += c;
+        }
+    }
+    if (quoted) {
+        return std::unexpected("unterminated quoted field");
+    }
+
+    fields.push_back(std::move(field));
+    return true;
+}
+
+constexpr std::string_view kCsvRequiredColumns[] = {
+    "id", "name", "address", "latitude", "longitude", "region"
+};
+
+std::expected<void, std::string> copy_chunk(database::Connection& conn, std::string_view table,
+                                           std::span<const domain::Shop> chunk) {
+    try {
+        pqxx::work txn(conn.raw_connection());
+        // created_at / updated_at は既定値
+        auto stream = pqxx::stream_to::table(txn, {table}, {
+            "id", "name", "address", "phone", "latitude", "longitude", "region",
+            "spiciness", "stimulation", "aroma", "rating", "description", "image_url"
+        });
+
+        for (const auto& shop : chunk) {
+            stream.write_values(
+                shop.id, shop.name, shop.address, shop.phone,
+                shop.latitude, shop.longitude, shop.region,
+                shop.spice_params.spiciness, shop.spice_params.stimulation, shop.spice_params.aroma,
+                shop.rating, shop.description, shop.image_url
+            );
+        }
+
+        stream.complete();
+        txn.commit();
+        return {};
+
+    } catch (const std::exception& e) {
+        return std::unexpected(std::string(e.what()));
+    }
+}
+
+// replace 用の作業テーブル（並列の COPY が別々の接続から書き込むため一時テーブルにはしない）
+// 制約は shops と同じ CHECK・NOT NULL を持ち、インデックスは作らない
+std::expected<void, std::string> create_staging_table(database::Connection& conn, const std::string& staging) {
+    try {
+        pqxx::work txn(conn.raw_connection());
+        txn.exec(std::format("CREATE UNLOGGED TABLE {} (LIKE shops INCLUDING DEFAULTS INCLUDING CONSTRAINTS)",
+                             txn.quote_name(staging)));
+        txn.commit();
+        return {};
+    } catch (const std::exception& e) {
+        return std::unexpected(std::format("Failed to create staging table: {}", e.what()));
+    }
+}
+
+void drop_staging_table(database::Connection& conn, const std::string& staging) {
+    try {
+        pqxx::work txn(conn.raw_connection());
+        txn.exec(std::format("DROP TABLE IF EXISTS {}", txn.quote_name(staging)));
+        txn.commit();
+    } catch (const std::exception& e) {
+        std::println("⚠️  Failed to drop staging table {}: {}", staging, e.what());
+    }
+}
+
+// 作業テーブルの内容で shops を1トランザクションで置き換え、削除した店舗数を返す
+// 入力にない店舗だけを削除するため、残る店舗のお気に入り・苦手の登録は消えない
+// （API サーバーはコミット後に行ごとの通知を受け取り、置き換え後の状態だけを読む）
+std::expected<size_t, std::string> swap_in_staging(database::Connection& conn, const std::string& staging) {
+    try {
+        pqxx::work txn(conn.raw_connection());
+        const auto table = txn.quote_name(staging);
+
+        // 置き換え中の他の書き込みを待たせる（読み込みは置き換え前の状態を見続ける）
+        txn.exec("LOCK TABLE shops IN EXCLUSIVE MODE");
+        auto removed = txn.exec(std::format(
+            "DELETE FROM shops s WHERE NOT EXISTS (SELECT 1 FROM {} n WHERE n.id = s.id)", table));
+        txn.exec(std::format(
+            "INSERT INTO shops (id, name, address, phone, latitude, longitude, region, "
+            "spiciness, stimulation, aroma, rating, description, image_url) "
+            "SELECT id, name, address, phone, latitude, longitude, region, "
+            "spiciness, stimulation, aroma, rating, description, image_url FROM {} "
+            "ON CONFLICT (id) DO UPDATE SET "
+            "name = EXCLUDED.name, address = EXCLUDED.address, phone = EXCLUDED.phone, "
+            "latitude = EXCLUDED.latitude, longitude = EXCLUDED.longitude, region = EXCLUDED.region, "
+            "spiciness = EXCLUDED.spiciness, stimulation = EXCLUDED.stimulation, aroma = EXCLUDED.aroma, "
+            "rating = EXCLUDED.rating, description = EXCLUDED.description, image_url = EXCLUDED.image_url, "
+            "updated_at = CURRENT_TIMESTAMP", table));
+        txn.exec(std::format("DROP TABLE {}", table));
+        txn.commit();
+        return static_cast<size_t>(removed.affected_rows());
+    } catch (const std::exception& e) {
+        return std::unexpected(std::format("Failed to replace shops: {}", e.what()));
+    }
+}
+
+} // namespace
+
+std::optional<InputFormat> format_from_path(std::string_view path) {
+    if (path.ends_with(".json")) {
+        return InputFormat::Json;
+    }
+    if (path.ends_with(".csv")) {
+        return InputFormat::Csv;
+    }
+    return std::nullopt;
+}
+
+std::expected<void, std::string> validate_shop(const domain::Shop& shop) {
+    if (shop.id.empty() || utf8_length(shop.id) > 255) {
+        return std::unexpected("id must be 1-255 characters");
+    }
+    if (shop.name.empty() || utf8_length(shop.name) > 255) {
+        return std::unexpected("name must be 1-255 characters");
+    }
+    if (shop.address.empty()) {
+        return std::unexpected("address is required");
+    }
+    if (shop.region.empty() || utf8_length(shop.region) > 100) {
+        return std::unexpected("region must be 1-100 characters");
+    }
+    if (shop.phone && utf8_length(*shop.phone) > 50) {
+        return std::unexpected("phone must not exceed 50 characters");
+    }
+    if (!(shop.latitude >= -90.0 && shop.latitude <= 90.0) ||
+        !(shop.longitude >= -180.0 && shop.longitude <= 180.0)) {
+        return std::unexpected("latitude/longitude out of range");
+    }
+
+    const auto& spice = shop.spice_params;
+    for (int value : {spice.spiciness, spice.stimulation, spice.aroma}) {
+        if (value < 0 || value > 100) {
+            return std::unexpected("spice parameters must be between 0 and 100");
+        }
+    }
+    if (!(shop.rating >= 0.0 && shop.rating <= 5.0)) {
+        return std::unexpected("rating must be between 0 and 5");
+    }
+
+    return {};
+}
+
+std::expected<ParsedShops, std::string> parse_shops_json(std::string_view input) {
+    json document;
+    try {
+        document = json::parse(input.begin(), input.end());
+    } catch (const json::exception& e) {
+        return std::unexpected(std::format("Invalid JSON: {}", e.what()));
+    }
+    if (!document.is_array()) {
+        return std::unexpected("Invalid JSON: expected an array of shops");
+    }
+
+    ParsedShops parsed;
+    parsed.shops.reserve(document.size());
+    std::unordered_set<std::string> ids;
+
+    for (size_t i = 0; i < document.size(); ++i) {
+        auto location = std::format("shop[{}]", i);
+        try {
+            accept(parsed, ids, shop_from_json(document[i]), location);
+        } catch (const json::exception& e) {
+            parsed.rejected.push_back(std::format("{}: {}", location, e.what()));
+        }
+    }
+
+    return parsed;
+}
+
+std::expected<ParsedShops, std::string> parse_shops_csv(std::string_view input) {
+    // Excel などが付ける BOM
+    if (input.starts_with("\xEF\xBB\xBF")) {
+        input.remove_prefix(3);
+    }
+
+    size_t pos = 0;
+    std::vector<std::string> fields;
+
+    auto header = read_csv_record(input, pos, fields);
+    if (!header) {
+        return std::unexpected(std::format("Invalid CSV header: {}", header.error()));
+    }
+    if (!header.value()) {
+        return std::unexpected("Invalid CSV: empty input");
+    }
+
+    // 列名 → 位置（不要な列は無視）
+    auto column_of = [header_fields = fields](std::string_view name) -> std::optional<size_t> {
+        for (size_t i = 0; i < header_fields.size(); ++i) {
+            if (trim(header_fields[i]) == name) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    };
+    for (auto name : kCsvRequiredColumns) {
+        if (!column_of(name)) {
+            return std::unexpected(std::format("Invalid CSV: missing column {}", name));
+        }
+    }
+
+    const size_t id = *column_of("id");
+    const size_t name = *column_of("name");
+    const size_t address = *column_of("address");
+    const size_t latitude = *column_of("latitude");
+    const size_t longitude = *column_of("longitude");
+    const size_t region = *column_of("region");
+    const auto phone = column_of("phone");
+    const auto spiciness = column_of("spiciness");
+    const auto stimulation = column_of("stimulation");
+    const auto aroma = column_of("aroma");
+    const auto rating = column_of("rating");
+    const auto description = column_of("description");
+    const auto image_url = column_of("image_url");
+
+    ParsedShops parsed;
+    std::unordered_set<std::string> ids;
+
+    for (size_t line = 2;; ++line) {
+        auto record = read_csv_record(input, pos, fields);
+        if (!record) {
+            parsed.rejected.push_back(std::format("line {}: {}", line, record.error()));
+            break;
+        }
+        if (!record.value()) {
+            break;
+        }
+        if (fields.size() == 1 && fields[0].empty()) {
+            continue;  // 空行
+        }
+
+        auto location = std::format("line {}", line);
+        auto field = [&fields](std::optional<size_t> column) -> std::string_view {
+            return column && *column < fields.size() ? std::string_view(fields[*column]) : std::string_view();
+        };
+
+        // 数値の列（空欄は既定値、数値でなければ行ごと取り込まない）
+        std::optional<std::string> error;
+        auto number = [&]<class T>(std::optional<size_t> column, const char* label, T fallback) -> T {
+            auto text = field(column);
+            if (trim(text).empty()) {
+                return fallback;
+            }
+            auto value = parse_number<T>(text);
+            if (!value) {
+                error = std::format("{} is not a number", label);
+                return fallback;
+            }
+            return *value;
+        };
+
+        domain::Shop shop(
+            std::string(field(id)), std::string(field(name)), std::string(field(address)),
+            optional_text(field(phone))
+        );
+        shop.latitude = number(latitude, "latitude", std::numeric_limits<double>::quiet_NaN());
+        shop.longitude = number(longitude, "longitude", std::numeric_limits<double>::quiet_NaN());
+        shop.region = std::string(field(region));
+        shop.spice_params.spiciness = number(spiciness, "spiciness", 50);
+        shop.spice_params.stimulation = number(stimulation, "stimulation", 50);
+        shop.spice_params.aroma = number(aroma, "aroma", 50);
+        shop.rating = number(rating, "rating", 0.0);
+        shop.description = optional_text(field(description));
+        shop.image_url = optional_text(field(image_url));
+
+        if (error) {
+            parsed.rejected.push_back(std::format("{}: {}", location, *error));
+            continue;
+        }
+        accept(parsed, ids, std::move(shop), location);
+    }
+
+    return parsed;
+}
+
+std::expected<ImportReport, std::string> import_shops(
+    database::ConnectionPool& pool,
+    std::span<const domain::Shop> shops,
+    const ImportOptions& options
+) {
+    const auto started = std::chrono::steady_clock::now();
+
+    // replace は作業テーブルへ取り込み、すべてのチャンクが成功したときだけ shops と入れ替える
+    std::string target = "shops";
+    if (options.replace) {
+        auto conn = pool.acquire();
+        if (!conn) {
+            return std::unexpected(conn.error());
+        }
+        target = std::format("shops_import_{}_{:x}", getpid(), std::random_device{}());
+        if (auto created = create_staging_table(*conn, target); !created) {
+            return std::unexpected(created.error());
+        }
+    }
+
+    const size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+    const size_t chunk_count = (shops.size() + chunk_size - 1) / chunk_size;
+    const size_t workers = std::clamp<size_t>(options.workers, 1, std::max<size_t>(chunk_count, 1));
+
+    ImportReport report;
+    report.chunks = chunk_count;
+
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<size_t> imported{0};
+    std::atomic<bool> aborted{false};
+    std::mutex failures_mutex;
+
+    // 各ワーカーが次のチャンクを取りにいく（遅いチャンクがあっても他の接続は止まらない）
+    // replace は最初の失敗で残りのチャンクを取りにいかない
+    auto worker = [&] {
+        auto conn = pool.acquire(std::chrono::seconds(30));
+        for (size_t chunk = next_chunk.fetch_add(1); chunk < chunk_count && !aborted.load();
+             chunk = next_chunk.fetch_add(1)) {
+            const size_t begin = chunk * chunk_size;
+            const size_t end = std::min(begin + chunk_size, shops.size());
+
+            auto result = conn ? copy_chunk(*conn, target, shops.subspan(begin, end - begin))
+                               : std::expected<void, std::string>(std::unexpected(conn.error()));
+            if (result) {
+                imported.fetch_add(end - begin);
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(failures_mutex);
+                report.failed_chunks.push_back(std::format(
+                    "rows {}-{} ({} to {}): {}", begin, end - 1, shops[begin].id, shops[end - 1].id, result.error()));
+            }
+            if (options.replace) {
+                aborted.store(true);
+                break;
+            }
+
+            // 接続が切れていれば取り直して残りのチャンクを続ける
+            if (!conn || !conn->is_connected()) {
+                conn = pool.acquire(std::chrono::seconds(30));
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            threads.emplace_back(worker);
+        }
+    }
+
+    report.imported = imported.load();
+
+    if (options.replace) {
+        auto conn = pool.acquire(std::chrono::seconds(30));
+        if (!conn) {
+            return std::unexpected(std::format("{} (staging table {} was left behind)", conn.error(), target));
+        }
+        if (aborted.load()) {
+            // shops には触れていない
+            drop_staging_table(*conn, target);
+            report.imported = 0;
+        } else if (auto removed = swap_in_staging(*conn, target); removed) {
+            report.removed = removed.value();
+        } else {
+            drop_staging_table(*conn, target);
+            return std::unexpected(removed.error());
+        }
+    }
+
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started);
+    return report;
+}
+
+} // namespace importer
@@ -0,0 +1,61 @@
+#pragma once
+#include "domain/shop.hpp"
+#include "database/connection_pool.hpp"
+#include <chrono>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace importer {
+
+// 入力ファイルの形式
+enum class InputFormat {
+    Json,  // shops.json と同じ形（Shop オブジェクトの配列）
+    Csv    // 1行目がヘッダー（列名は shops テーブルと同じ）
+};
+
+// 拡張子（.json / .csv）から形式を判定
+std::optional<InputFormat> format_from_path(std::string_view path);
+
+// 読み込んだ店舗と、取り込まない行の理由（"<位置>: <理由>"）
+struct ParsedShops {
+    std::vector<domain::Shop> shops;
+    std::vector<std::string> rejected;
+};
+
+// 入力全体を解析し、検証に通った行だけを shops に入れる（同じ id は最初の行だけ）
+// 入力全体が読めないときだけエラーを返す
+std::expected<ParsedShops, std::string> parse_shops_json(std::string_view input);
+std::expected<ParsedShops, std::string> parse_shops_csv(std::string_view input);
+
+// shops テーブルの制約（NOT NULL・CHECK・文字数）を満たすか
+std::expected<void, std::string> validate_shop(const domain::Shop& shop);
+
+struct ImportOptions {
+    size_t chunk_size = 5'000;  // 1回の COPY（1トランザクション）で書き込む行数
+    size_t workers = 4;         // 並列に COPY する接続数
+    bool replace = false;       // 入力にない店舗を削除して shops を入力と同じ内容にする（すべて成功したときだけ）
+};
+
+struct ImportReport {
+    size_t imported = 0;                     // コミットできた行数（replace は置き換えた行数）
+    size_t removed = 0;                      // replace で削除した店舗数
+    size_t chunks = 0;
+    std::vector<std::string> failed_chunks;  // 失敗したチャンクの範囲と理由
+    std::chrono::milliseconds elapsed{0};
+};
+
+// 店舗をチャンクに分け、workers 本の接続から並列に COPY（pqxx::stream_to）で書き込む
+// チャンクごとにコミットするため、失敗したチャンクだけが取り込まれない
+// replace は作業テーブルへ同じように取り込んでから1トランザクションで shops と入れ替え、
+// チャンクが1つでも失敗すればその時点で打ち切って shops を変更しない
+std::expected<ImportReport, std::string> import_shops(
+    database::ConnectionPool& pool,
+    std::span<const domain::Shop> shops,
+    const ImportOptions& options
+);
+
+} // namespace importer
@@ -3,13 +3,13 @@
 #include <chrono>
 #include <csignal>
 #include <atomic>
-#include <sys/socket.h>
-#include <netinet/in.h>
 #include <unistd.h>
-#include <fcntl.h>
 #include <memory>
 #include <cstdlib>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <algorithm>
 
 // stdexec headers
 #include <stdexec/execution.hpp>
@@ -22,43 +22,150 @@
 #include "repository/postgres_shop_repository.hpp"
 #include "repository/postgres_user_repository.hpp"
 #include "database/connection_pool.hpp"
-
-std::atomic<bool> running{true};
+#include "database/async_pool.hpp"
+#include "server/reactor.hpp"
+#include "server/connection_handler.hpp"
+#include "server/listener.hpp"
+#include "server/sharded_server.hpp"
+#ifdef SPICE_HAS_IO_URING
+#include "server/uring_server.hpp"
+#endif
+
+// シグナルハンドラーから停止させるリアクター
+std::atomic<server::Reactor*> active_reactor{nullptr};
+std::atomic<server::ShardedServer*> active_sharded_server{nullptr};
+#ifdef SPICE_HAS_IO_URING
+std::atomic<server::UringServer*> active_uring_server{nullptr};
+#endif
 
 void signal_handler(int signal) {
     std::println("Received signal {}, shutting down server gracefully...", signal);
-    running = false;
+    if (auto* reactor = active_reactor.load()) {
+        reactor->stop();
+    }
+    if (auto* sharded_server = active_sharded_server.load()) {
+        sharded_server->stop();
+    }
+#ifdef SPICE_HAS_IO_URING
+    if (auto* uring_server = active_uring_server.load()) {
+        uring_server->stop();
+    }
+#endif
+}
+
+// 処理結果に応じてセッションを epoll に再登録するか閉じる
+void finish_session(server::Reactor& reactor, server::Session& session, server::SessionState state) {
+    switch (state) {
+    case server::SessionState::KeepAlive:
+        reactor.resume(session);
+        break;
+    case server::SessionState::WaitWritable:
+        reactor.wait_writable(session);
+        break;
+    case server::SessionState::Suspended:
+        // 応答待ちのセッションは再開する側が改めて finish_session を呼ぶ
+        break;
+    case server::SessionState::Close:
+        reactor.close_session(session);
+        break;
+    }
+}
+
+void run_session(exec::static_thread_pool& pool, server::Reactor& reactor,
+                 server::Session& session, std::shared_ptr<router::Router> router);
+
+// 止めたリクエストの応答を AsyncPool・登録の書き込みスレッドで作り、ワーカーへ戻ってから
+// セッションの続きを処理する（DB の往復を待つ間はどのスレッドも占有しない）
+void resume_deferred(exec::static_thread_pool& pool, server::Reactor& reactor, server::Session& session,
+                     std::shared_ptr<router::Router> router, router::DeferredRequest request) {
+    bool keep_alive = request.keep_alive;
+
+    router->respond_async(std::move(request), [&pool, &reactor, &session, router, keep_alive](auto response_sender) {
+        stdexec::start_detached(
+            std::move(response_sender)
+            | stdexec::continues_on(pool.get_scheduler())
+            | stdexec::then([&pool, &reactor, &session, router, keep_alive](router::Response response) {
+                  if (!router->write_deferred_response(std::move(response), keep_alive, session.output)) {
+                      session.close_after_send = true;
+                  }
+                  run_session(pool, reactor, session, router);
+              })
+        );
+    });
+}
+
+// セッションを処理し、応答待ちなら非同期に再開、それ以外は epoll に再登録するか閉じる
+void run_session(exec::static_thread_pool& pool, server::Reactor& reactor,
+                 server::Session& session, std::shared_ptr<router::Router> router) {
+    std::optional<router::DeferredRequest> deferred;
+    auto state = server::handle_session(session, *router, router->has_deferred_routes() ? &deferred : nullptr);
+
+    if (state == server::SessionState::Suspended) {
+        resume_deferred(pool, reactor, session, router, std::move(*deferred));
+        return;
+    }
+    finish_session(reactor, session, state);
+}
+
+// REUSEPORT のシャードで止めたリクエストの応答を追記し、送信可能の通知でシャードのスレッドへ戻す
+// （完了したスレッドでは送信もリクエスト処理もしない）
+void resume_deferred_on_shard(server::Reactor& reactor, server::Session& session,
+                              std::shared_ptr<router::Router> router, router::DeferredRequest request) {
+    bool keep_alive = request.keep_alive;
+
+    router->respond_async(std::move(request), [&reactor, &session, router, keep_alive](auto response_sender) {
+        stdexec::start_detached(
+            std::move(response_sender)
+            | stdexec::then([&reactor, &session, router, keep_alive](router::Response response) {
+                  if (!router->write_deferred_response(std::move(response), keep_alive, session.output)) {
+                      session.close_after_send = true;
+                  }
+                  reactor.wait_writable(session);
+              })
+        );
+    });
 }
 
 // Async request handling using sender/receiver pattern
-auto async_handle_request(exec::static_thread_pool& pool, int client_socket,
-                          std::shared_ptr<router::Router> router) {
+// セッションのリクエストをスレッドプールで処理し、keep-alive なら epoll に再登録する
+auto async_handle_request(exec::static_thread_pool& pool, server::Reactor& reactor,
+                          server::Session& session, std::shared_ptr<router::Router> router) {
     auto sched = pool.get_scheduler();
 
-    return stdexec::starts_on(sched, stdexec::just(client_socket))
-         | stdexec::then([router](int sock) -> std::pair<int, std::string> {
-               char buffer[4096];
-               ssize_t bytes_read = recv(sock, buffer, sizeof(buffer) - 1, 0);
-
-               std::string http_response;
+    return stdexec::starts_on(sched, stdexec::just(&session))
+         | stdexec::then([&pool, &reactor, router](server::Session* s) {
+               // Routerを使ってリクエスト処理
+               run_session(pool, reactor, *s, router);
+           });
+}
 
-               if (bytes_read > 0) {
-                   buffer[bytes_read] = '\0';
-                   std::string request(buffer);
+#ifdef SPICE_HAS_IO_URING
+// io_uring バックエンド: リクエスト処理はスレッドプール、送受信はリングスレッドで行う
+auto async_handle_uring_request(exec::static_thread_pool& pool, server::UringServer& uring_server,
+                                server::UringSession& session, std::shared_ptr<router::Router> router) {
+    auto sched = pool.get_scheduler();
 
-                   // Routerを使ってリクエスト処理
-                   http_response = router->route(request);
+    return stdexec::starts_on(sched, stdexec::just(&session))
+         | stdexec::then([router](server::UringSession* s) {
+               auto state = server::SessionState::Close;
+               try {
+                   // 送受信はリングスレッドが行うが、ストリーミング中は送信中の SQE がないため
+                   // 溜まった分をこのスレッドから直接送信する
+                   state = server::process_requests(*s, *router, s->output, [s](http::OutputBuffer& pending) {
+                       return server::flush_stream(*s, pending);
+                   });
+               } catch (const std::exception& e) {
+                   std::println("⚠️  Request handling failed: {}", e.what());
                }
-
-               return std::make_pair(sock, http_response);
+               return std::make_pair(s, state);
            })
-         | stdexec::then([](std::pair<int, std::string> result) {
-               auto [sock, response] = result;
-               send(sock, response.c_str(), response.length(), 0);
-               close(sock);
-               return sock;
+         | stdexec::continues_on(uring_server.get_scheduler())
+         | stdexec::then([&uring_server](std::pair<server::UringSession*, server::SessionState> result) {
+               auto [s, state] = result;
+               uring_server.complete(*s, state);
            });
 }
+#endif
 
 int main() {
     try {
@@ -68,15 +175,6 @@ int main() {
         signal(SIGINT, signal_handler);
         signal(SIGTERM, signal_handler);
 
-        // Create thread pool with hardware concurrency threads
-        const auto num_threads = std::thread::hardware_concurrency();
-        std::println("🔧 Creating thread pool with {} threads...", num_threads);
-        std::fflush(stdout);
-
-        exec::static_thread_pool pool(num_threads);
-        std::println("🔧 Thread pool initialized successfully");
-        std::fflush(stdout);
-
         // Initialize PostgreSQL connection pool
         std::println("🗄️  Initializing PostgreSQL connection pool...");
         std::fflush(stdout);
@@ -93,14 +191,18 @@ int main() {
             return 1;
         }
 
-        auto connection_pool_result = database::ConnectionPool::create(db_config.value(), 10);
+        // DB_POOL_MIN の接続を開き、負荷に応じて DB_POOL_MAX まで増やす
+        auto pool_options = database::PoolOptions::from_env();
+        auto connection_pool_result = database::ConnectionPool::create(db_config.value(), pool_options);
         if (!connection_pool_result.has_value()) {
             std::println("❌ Failed to create connection pool: {}", connection_pool_result.error());
             return 1;
         }
 
         auto connection_pool = std::move(connection_pool_result.value());
-        std::println("✅ PostgreSQL connection pool initialized (size: {})", connection_pool.get_pool_size());
+        connection_pool.start_maintenance();
+        std::println("✅ PostgreSQL connection pool initialized (size: {}, max: {})",
+                     connection_pool.get_pool_size(), connection_pool.get_max_size());
         std::fflush(stdout);
 
         // Initialize application layers (DI)
@@ -108,36 +210,90 @@ int main() {
         std::fflush(stdout);
 
         auto shop_repository = std::make_shared<repository::PostgresShopRepository>(connection_pool);
-        auto shop_service = std::make_shared<service::ShopService>(shop_repository);
+        auto shop_service = std::make_shared<service::ShopService>(shop_repository, shop_repository);
+
+        // 店舗スナップショットの初回ロードと定期更新（SHOP_SNAPSHOT_REFRESH 秒、0 で無効）
+        if (auto snapshot_result = shop_service->refresh_snapshot(); !snapshot_result) {
+            std::println("⚠️  Initial shop snapshot load failed (will retry on demand): {}", snapshot_result.error());
+        }
+        auto snapshot_refresh = std::chrono::seconds(30);
+        if (const char* refresh_env = std::getenv("SHOP_SNAPSHOT_REFRESH")) {
+            try {
+                snapshot_refresh = std::chrono::seconds(std::max(0, std::stoi(std::string(refresh_env))));
+            } catch (...) {
+                std::println("⚠️  Invalid SHOP_SNAPSHOT_REFRESH value, using 30s");
+            }
+        }
+        if (snapshot_refresh.count() > 0) {
+            shop_service->start_snapshot_refresh(snapshot_refresh);
+        }
+
+        // 他インスタンスや手動 SQL による変更を LISTEN/NOTIFY で検知してスナップショットを更新
+        connection_pool.subscribe_changes("shops", [shop_service](const std::vector<database::ChangeEvent>& events) {
+            // 行単位のイベントは該当店舗だけ読み直し、テーブル全体の無効化なら全件を読み直す
+            if (auto result = shop_service->refresh_shops(database::changed_row_ids(events)); !result) {
+                std::println("⚠️  Shop snapshot refresh after {} change(s) failed: {}", events.size(), result.error());
+            }
+        });
 
         // PostgreSQL User Repository and Service
         auto user_repository = std::make_shared<repository::PostgresUserRepository>(connection_pool);
         auto user_service = std::make_shared<service::UserService>(user_repository);
 
+        // 登録の集中時に fsync 待ちで頭打ちにならないよう、同時の登録を1回のコミットにまとめる
+        auto write_combiner_options = repository::WriteCombinerOptions::from_env();
+        user_service->enable_write_combining(write_combiner_options);
+        std::println("✅ User registration batching enabled (max: {} rows)", write_combiner_options.max_batch);
+
+        // 推薦用にキャッシュしたユーザーの好みを変更時に破棄
+        connection_pool.subscribe_changes("users", [user_service](const std::vector<database::ChangeEvent>& events) {
+            user_service->invalidate_preferences(database::changed_row_ids(events));
+        });
+
+        if (auto listener_result = connection_pool.start_change_listener(); !listener_result) {
+            std::println("⚠️  Change listener unavailable, relying on periodic shop refresh and a {}s preference cache TTL: {}",
+                         service::UserService::kPreferencesTtl.count(), listener_result.error());
+        }
+
         auto router = std::make_shared<router::Router>(
             shop_service, user_service, "", ""
         );
 
-        std::println("✅ Application layers initialized (Clean Architecture + PostgreSQL)");
-        std::fflush(stdout);
+        // 接続プールの取得状況（競合・待機・再接続の回数）を /metrics に出力
+        router->add_metrics_section("connectionPool", [&connection_pool](serialization::JsonWriter& writer) {
+            auto metrics = connection_pool.metrics();
+            writer.begin_object()
+                .key("size").value(static_cast<std::int64_t>(metrics.pool_size))
+                .key("maxSize").value(static_cast<std::int64_t>(metrics.max_size))
+                .key("active").value(static_cast<std::int64_t>(metrics.active))
+                .key("available").value(static_cast<std::int64_t>(metrics.available))
+                .key("acquired").value(static_cast<std::int64_t>(metrics.acquired))
+                .key("affinityHits").value(static_cast<std::int64_t>(metrics.affinity_hits))
+                .key("steals").value(static_cast<std::int64_t>(metrics.steals))
+                .key("casFailures").value(static_cast<std::int64_t>(metrics.cas_failures))
+                .key("waits").value(static_cast<std::int64_t>(metrics.waits))
+                .key("timeouts").value(static_cast<std::int64_t>(metrics.timeouts))
+                .key("waitTimeUs").value(static_cast<std::int64_t>(metrics.wait_time_us))
+                .key("connects").value(static_cast<std::int64_t>(metrics.connects))
+                .key("connectFailures").value(static_cast<std::int64_t>(metrics.connect_failures))
+                .key("closedIdle").value(static_cast<std::int64_t>(metrics.closed_idle))
+                .key("closedDead").value(static_cast<std::int64_t>(metrics.closed_dead))
+                .end_object();
+        });
+
+        // ユーザー登録のバッチ（平均の大きさ = rows / batches）
+        router->add_metrics_section("userRegistrationBatching", [user_service](serialization::JsonWriter& writer) {
+            auto metrics = user_service->write_combiner_metrics().value_or(repository::WriteCombinerMetrics{});
+            writer.begin_object()
+                .key("batches").value(static_cast<std::int64_t>(metrics.batches))
+                .key("rows").value(static_cast<std::int64_t>(metrics.rows))
+                .key("maxBatch").value(static_cast<std::int64_t>(metrics.max_batch))
+                .end_object();
+        });
 
-        // Socket setup
-        std::println("🔌 Creating socket...");
+        std::println("✅ Application layers initialized (Clean Architecture + PostgreSQL)");
         std::fflush(stdout);
 
-        int server_socket = socket(AF_INET, SOCK_STREAM, 0);
-        if (server_socket < 0) {
-            std::println("❌ Failed to create socket");
-            return 1;
-        }
-
-        int opt = 1;
-        setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-
-        // Set socket to non-blocking mode
-        int flags = fcntl(server_socket, F_GETFL, 0);
-        fcntl(server_socket, F_SETFL, flags | O_NONBLOCK);
-
         // Read port from environment variable (Cloud Run requirement)
         // Priority: PORT > API_PORT > default 8080
         int port = 8080;
@@ -153,24 +309,32 @@ int main() {
             }
         }
 
-        sockaddr_in server_addr{};
-        server_addr.sin_family = AF_INET;
-        server_addr.sin_addr.s_addr = INADDR_ANY;
-        server_addr.sin_port = htons(port);
-
-        std::println("🔌 Binding to port {}...", port);
-        std::fflush(stdout);
-
-        if (bind(server_socket, (sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-            std::println("❌ Failed to bind to port {}", port);
-            close(server_socket);
-            return 1;
+        // SO_REUSEPORT のシャード数（0 で無効、"auto" で利用可能なコア数）
+        size_t reuseport_shards = 0;
+        if (const char* shards_env = std::getenv("REUSEPORT_SHARDS")) {
+            if (std::string_view(shards_env) == "auto") {
+                reuseport_shards = std::max(1u, std::thread::hardware_concurrency());
+            } else {
+                try {
+                    reuseport_shards = static_cast<size_t>(std::max(0, std::stoi(std::string(shards_env))));
+                } catch (...) {
+                    std::println("⚠️  Invalid REUSEPORT_SHARDS value, using single listener");
+                }
+            }
         }
 
-        if (listen(server_socket, 128) < 0) {
-            std::println("❌ Failed to listen on socket");
-            close(server_socket);
-            return 1;
+        // Socket setup
+        int server_socket = -1;
+        if (reuseport_shards == 0) {
+            std::println("🔌 Binding to port {}...", port);
+            std::fflush(stdout);
+
+            auto socket_result = server::create_listen_socket(port);
+            if (!socket_result.has_value()) {
+                std::println("❌ {}", socket_result.error());
+                return 1;
+            }
+            server_socket = socket_result.value();
         }
 
         std::println("🚀 C++26 API Server running on 0.0.0.0:{}", port);
@@ -183,20 +347,150 @@ int main() {
         std::println("🏗️  Architecture: Clean Architecture (Domain/Repository/Service/Router)");
         std::println("🗄️  Database: PostgreSQL with connection pool");
 
-        while (running) {
-            sockaddr_in client_addr{};
-            socklen_t client_len = sizeof(client_addr);
+        // リアクタースレッド数（デフォルト1、REACTOR_THREADS で変更可能）
+        size_t reactor_threads = 1;
+        if (const char* reactor_env = std::getenv("REACTOR_THREADS")) {
+            try {
+                reactor_threads = std::max(1, std::stoi(std::string(reactor_env)));
+            } catch (...) {
+                std::println("⚠️  Invalid REACTOR_THREADS value, using 1");
+            }
+        }
+
+        // keep-alive のアイドルタイムアウト（nginx の upstream keepalive_timeout より長くする）
+        auto idle_timeout = std::chrono::seconds(75);
+        if (const char* timeout_env = std::getenv("KEEPALIVE_TIMEOUT")) {
+            try {
+                idle_timeout = std::chrono::seconds(std::max(1, std::stoi(std::string(timeout_env))));
+            } catch (...) {
+                std::println("⚠️  Invalid KEEPALIVE_TIMEOUT value, using 75s");
+            }
+        }
 
-            int client_socket = accept(server_socket, (sockaddr*)&client_addr, &client_len);
-            if (client_socket >= 0) {
-                // Launch async request handling using sender/receiver
-                auto request_sender = async_handle_request(pool, client_socket, router);
-                stdexec::start_detached(std::move(request_sender));
+        if (reuseport_shards > 0) {
+            // シャードのリアクタースレッド上でそのまま処理し、リクエスト処理をコア内で完結させる
+            // 登録の書き込みを待つリクエストはシャードを止めずに応答待ちにする
+            auto on_ready_inline = [router](server::Reactor& reactor, server::Session& session) {
+                std::optional<router::DeferredRequest> deferred;
+                auto state = server::handle_session(session, *router,
+                                                    router->has_deferred_routes() ? &deferred : nullptr);
+                if (state == server::SessionState::Suspended) {
+                    resume_deferred_on_shard(reactor, session, router, std::move(*deferred));
+                    return;
+                }
+                finish_session(reactor, session, state);
+            };
+
+            std::println("🔌 Binding {} SO_REUSEPORT listeners to port {}...", reuseport_shards, port);
+            std::fflush(stdout);
+
+            auto sharded_result = server::ShardedServer::create(
+                port, reuseport_shards, on_ready_inline, idle_timeout
+            );
+            if (!sharded_result.has_value()) {
+                std::println("❌ Failed to create sharded server: {}", sharded_result.error());
+                return 1;
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            auto sharded_server = std::move(sharded_result.value());
+            active_sharded_server = sharded_server.get();
+            std::println("⚡ {} core-pinned reactor shard(s) running, keep-alive timeout {}s",
+                         sharded_server->get_shard_count(), idle_timeout.count());
+            std::fflush(stdout);
+
+            sharded_server->run();
+
+            active_sharded_server = nullptr;
+            // 書き込み待ちの登録を完了させ、シャードのリアクターがあるうちに再開させる
+            user_service->stop_write_combining();
+            std::println("✅ Server stopped gracefully");
+            return 0;
         }
 
+        // epoll / io_uring ではリクエスト処理をスレッドプールで行う
+        // （REUSEPORT ではシャードのスレッドで処理するため作成しない）
+        const auto num_threads = std::thread::hardware_concurrency();
+        std::println("🔧 Creating thread pool with {} threads...", num_threads);
+        std::fflush(stdout);
+
+        exec::static_thread_pool pool(num_threads);
+        std::println("🔧 Thread pool initialized successfully");
+        std::fflush(stdout);
+
+#ifdef SPICE_HAS_IO_URING
+        // IO_BACKEND=io_uring で io_uring バックエンドを使用（デフォルトは epoll）
+        const char* backend_env = std::getenv("IO_BACKEND");
+        if (backend_env && std::string_view(backend_env) == "io_uring") {
+            auto on_requests = [&pool, router](server::UringServer& uring_server, server::UringSession& session) {
+                stdexec::start_detached(async_handle_uring_request(pool, uring_server, session, router));
+            };
+
+            auto uring_result = server::UringServer::create(
+                server_socket, on_requests, server::UringOptions{.idle_timeout = idle_timeout}
+            );
+            if (!uring_result.has_value()) {
+                std::println("❌ Failed to create io_uring server: {}", uring_result.error());
+                close(server_socket);
+                return 1;
+            }
+
+            auto uring_server = std::move(uring_result.value());
+            active_uring_server = uring_server.get();
+            std::println("⚡ io_uring backend running, keep-alive timeout {}s", idle_timeout.count());
+            std::fflush(stdout);
+
+            uring_server->run();
+
+            active_uring_server = nullptr;
+            uring_server.reset();
+            close(server_socket);
+            std::println("✅ Server stopped gracefully");
+            return 0;
+        }
+#endif
+
+        // DB_ASYNC_CONNECTIONS > 0 なら GET /api/users/{id} を非同期の接続群で処理し、
+        // DB の往復中にワーカーを占有しない（epoll バックエンドのみ）
+        std::unique_ptr<database::AsyncPool> async_pool;
+        if (pool_options.async_connections > 0) {
+            auto async_pool_result = database::AsyncPool::create(
+                db_config.value(), pool_options.async_connections, pool_options.async_query_timeout);
+            if (async_pool_result.has_value()) {
+                async_pool = std::move(async_pool_result.value());
+                router->enable_async_queries(*async_pool);
+                std::println("✅ Async query pool initialized ({} connections)", async_pool->get_connection_count());
+            } else {
+                std::println("⚠️  Async query pool unavailable, serving user lookups synchronously: {}",
+                             async_pool_result.error());
+            }
+        }
+
+        // 読み込み可能になったセッションをスレッドプールへディスパッチ
+        auto on_ready = [&pool, router](server::Reactor& reactor, server::Session& session) {
+            // Launch async request handling using sender/receiver
+            auto request_sender = async_handle_request(pool, reactor, session, router);
+            stdexec::start_detached(std::move(request_sender));
+        };
+
+        auto reactor_result = server::Reactor::create(server_socket, on_ready, idle_timeout);
+        if (!reactor_result.has_value()) {
+            std::println("❌ Failed to create reactor: {}", reactor_result.error());
+            close(server_socket);
+            return 1;
+        }
+
+        auto reactor = std::move(reactor_result.value());
+        active_reactor = reactor.get();
+        std::println("⚡ epoll reactor running with {} thread(s), keep-alive timeout {}s",
+                     reactor_threads, idle_timeout.count());
+        std::fflush(stdout);
+
+        reactor->run(reactor_threads);
+
+        active_reactor = nullptr;
+        // 応答待ちの登録・クエリを完了させ、スレッドプールとリアクターがあるうちに再開させる
+        user_service->stop_write_combining();
+        async_pool.reset();
         close(server_socket);
         std::println("✅ Server stopped gracefully");
 
@@ -3,6 +3,7 @@
 #include <vector>
 #include <optional>
 #include <expected>
+#include <functional>
 
 namespace repository {
 
@@ -15,6 +16,21 @@ public:
     // 全データ取得
     virtual std::expected<std::vector<T>, std::string> find_all() = 0;
 
+    // 全データを1件ずつ visit へ渡す（visit が false を返したら打ち切る）
+    // 既定では find_all() の結果を順に渡す。全件を保持せずに読める実装はオーバーライドする
+    virtual std::expected<void, std::string> for_each(const std::function<bool(const T&)>& visit) {
+        auto all = find_all();
+        if (!all) {
+            return std::unexpected(all.error());
+        }
+        for (const auto& entity : all.value()) {
+            if (!visit(entity)) {
+                break;
+            }
+        }
+        return {};
+    }
+
     // ID検索
     virtual std::expected<std::optional<T>, std::string> find_by_id(const std::string& id) = 0;
 
@@ -0,0 +1,20 @@
+#pragma once
+#include "domain/shop.hpp"
+#include "domain/shop_query.hpp"
+#include <expected>
+#include <string>
+#include <vector>
+
+namespace repository {
+
+// 検索条件（絞り込み・並び順・カーソル・件数）をデータベース側で評価できるリポジトリ
+// ShopService はスナップショットを読み込めないときの店舗一覧にこれを使う
+class IShopQueryRepository {
+public:
+    virtual ~IShopQueryRepository() = default;
+
+    // 条件に合う店舗を query.sort の順に最大 query.limit 件
+    virtual std::expected<std::vector<domain::Shop>, std::string> find_matching(const domain::ShopQuery& query) = 0;
+};
+
+} // namespace repository
@@ -1,5 +1,6 @@
 #include "repository/postgres_shop_repository.hpp"
 #include <format>
+#include <type_traits>
 #include <print>
 
 namespace repository {
@@ -34,6 +35,31 @@ domain::Shop PostgresShopRepository::row_to_shop(const pqxx::row& row) {
 
 std::expected<std::vector<domain::Shop>, std::string>
 PostgresShopRepository::find_all() {
+    std::vector<domain::Shop> shops;
+
+    // pqxx::result を経由せず、デコードした行を直接 vector へ移す
+    auto result = for_each([&shops](const domain::Shop& shop) {
+        shops.push_back(shop);
+        return true;
+    });
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+
+    return shops;
+}
+
+std::expected<void, std::string>
+PostgresShopRepository::for_each(const std::function<bool(const domain::Shop&)>& visit) {
+    domain::Shop shop;
+    return for_each_view([&](const domain::ShopView& view) {
+        view.assign_to(shop);
+        return visit(shop);
+    });
+}
+
+std::expected<void, std::string>
+PostgresShopRepository::for_each_view(const std::function<bool(const domain::ShopView&)>& visit) {
     auto conn_result = pool_.acquire();
     if (!conn_result.has_value()) {
         return std::unexpected(conn_result.error());
@@ -41,27 +67,47 @@ PostgresShopRepository::find_all() {
 
     auto& conn = conn_result.value();
 
-    const std::string query = R"(
-        SELECT id, name, address, latitude, longitude, region,
-               spiciness, stimulation, aroma, rating, description,
-               created_at, updated_at
-        FROM shops
-        ORDER BY id
-    )";
-
-    auto result = conn.execute(query);
-    if (!result.has_value()) {
-        return std::unexpected(result.error());
-    }
+    try {
+        pqxx::read_transaction txn(conn.raw_connection());
+
+        // COPY はプリペアドステートメントを使えないため、同じ SQL を直接渡す
+        auto stream = pqxx::stream_from::query(txn, database::statements::kShopFindAll.sql);
+
+        // 文字列の列は次の行を読むまで有効な string_view として受け取る
+        bool visiting = true;
+        for (auto [id, name, address, latitude, longitude, region,
+                   spiciness, stimulation, aroma, rating, description, created_at, updated_at] :
+             stream.iter<std::string_view, std::string_view, std::string_view, double, double, std::string_view,
+                         int, int, int, double, std::optional<std::string_view>,
+                         std::optional<std::string_view>, std::optional<std::string_view>>()) {
+            // COPY は途中で止めると接続を再利用できないため、打ち切り後も残りの行は読み捨てる
+            if (!visiting) {
+                continue;
+            }
+
+            domain::ShopView view;
+            view.id = id;
+            view.name = name;
+            view.address = address;
+            view.latitude = latitude;
+            view.longitude = longitude;
+            view.region = region;
+            view.spice_params = domain::SpiceParameters(spiciness, stimulation, aroma);
+            view.rating = rating;
+            view.description = description;
+
+            visiting = visit(view);
+        }
+        stream.complete();
+        txn.commit();
 
-    std::vector<domain::Shop> shops;
-    shops.reserve(result.value().size());
+        return {};
 
-    for (const auto& row : result.value()) {
-        shops.push_back(row_to_shop(row));
+    } catch (const std::exception& e) {
+        return std::unexpected(
+            std::format("Failed to stream shops: {}", e.what())
+        );
     }
-
-    return shops;
 }
 
 std::expected<std::optional<domain::Shop>, std::string>
@@ -74,17 +120,10 @@ PostgresShopRepository::find_by_id(const std::string& id) {
     auto& conn = conn_result.value();
 
     try {
-        pqxx::work txn(conn.raw_connection());
-
-        const std::string query = R"(
-            SELECT id, name, address, latitude, longitude, region,
-                   spiciness, stimulation, aroma, rating, description,
-                   created_at, updated_at
-            FROM shops
-            WHERE id = $1
-        )";
+        // 単一の SELECT なので BEGIN/ROLLBACK の往復を省く
+        pqxx::nontransaction txn(conn.raw_connection());
 
-        auto result = txn.exec_params(query, id);
+        auto result = txn.exec_prepared(database::statements::kShopFindById.name, id);
 
         if (result.empty()) {
             return std::optional<domain::Shop>{};
@@ -111,17 +150,8 @@ PostgresShopRepository::add(const domain::Shop& entity) {
     try {
         pqxx::work txn(conn.raw_connection());
 
-        const std::string query = R"(
-            INSERT INTO shops (name, address, latitude, longitude, region,
-                             spiciness, stimulation, aroma, rating, description)
-            VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10)
-            RETURNING id, name, address, latitude, longitude, region,
-                     spiciness, stimulation, aroma, rating, description,
-                     created_at, updated_at
-        )";
-
-        auto result = txn.exec_params(
-            query,
+        auto result = txn.exec_prepared(
+            database::statements::kShopInsert.name,
             entity.name,
             entity.address,
             entity.latitude,
@@ -161,27 +191,8 @@ PostgresShopRepository::update(const domain::Shop& entity) {
     try {
         pqxx::work txn(conn.raw_connection());
 
-        const std::string query = R"(
-            UPDATE shops
-            SET name = $2,
-                address = $3,
-                latitude = $4,
-                longitude = $5,
-                region = $6,
-                spiciness = $7,
-                stimulation = $8,
-                aroma = $9,
-                rating = $10,
-                description = $11,
-                updated_at = CURRENT_TIMESTAMP
-            WHERE id = $1
-            RETURNING id, name, address, latitude, longitude, region,
-                     spiciness, stimulation, aroma, rating, description,
-                     created_at, updated_at
-        )";
-
-        auto result = txn.exec_params(
-            query,
+        auto result = txn.exec_prepared(
+            database::statements::kShopUpdate.name,
             entity.id,
             entity.name,
             entity.address,
@@ -224,9 +235,7 @@ PostgresShopRepository::remove(const std::string& id) {
     try {
         pqxx::work txn(conn.raw_connection());
 
-        const std::string query = "DELETE FROM shops WHERE id = $1";
-
-        auto result = txn.exec_params(query, id);
+        auto result = txn.exec_prepared(database::statements::kShopDelete.name, id);
 
         txn.commit();
 
@@ -251,18 +260,9 @@ PostgresShopRepository::find_by_region(const std::string& region) {
     auto& conn = conn_result.value();
 
     try {
-        pqxx::work txn(conn.raw_connection());
-
-        const std::string query = R"(
-            SELECT id, name, address, latitude, longitude, region,
-                   spiciness, stimulation, aroma, rating, description,
-                   created_at, updated_at
-            FROM shops
-            WHERE region = $1
-            ORDER BY rating DESC
-        )";
+        pqxx::nontransaction txn(conn.raw_connection());
 
-        auto result = txn.exec_params(query, region);
+        auto result = txn.exec_prepared(database::statements::kShopFindByRegion.name, region);
 
         std::vector<domain::Shop> shops;
         shops.reserve(result.size());
@@ -289,15 +289,7 @@ PostgresShopRepository::find_all_ordered_by_rating() {
 
     auto& conn = conn_result.value();
 
-    const std::string query = R"(
-        SELECT id, name, address, latitude, longitude, region,
-               spiciness, stimulation, aroma, rating, description,
-               created_at, updated_at
-        FROM shops
-        ORDER BY rating DESC, id ASC
-    )";
-
-    auto result = conn.execute(query);
+    auto result = conn.execute_prepared(database::statements::kShopFindAllByRating);
     if (!result.has_value()) {
         return std::unexpected(result.error());
     }
@@ -322,18 +314,9 @@ PostgresShopRepository::find_by_spice_range(int min_spiciness, int max_spiciness
     auto& conn = conn_result.value();
 
     try {
-        pqxx::work txn(conn.raw_connection());
-
-        const std::string query = R"(
-            SELECT id, name, address, latitude, longitude, region,
-                   spiciness, stimulation, aroma, rating, description,
-                   created_at, updated_at
-            FROM shops
-            WHERE spiciness BETWEEN $1 AND $2
-            ORDER BY spiciness DESC, rating DESC
-        )";
+        pqxx::nontransaction txn(conn.raw_connection());
 
-        auto result = txn.exec_params(query, min_spiciness, max_spiciness);
+        auto result = txn.exec_prepared(database::statements::kShopFindBySpiceRange.name, min_spiciness, max_spiciness);
 
         std::vector<domain::Shop> shops;
         shops.reserve(result.size());
@@ -351,4 +334,134 @@ PostgresShopRepository::find_by_spice_range(int min_spiciness, int max_spiciness
     }
 }
 
+CompiledShopQuery PostgresShopRepository::compile_query(const domain::ShopQuery& query) {
+    CompiledShopQuery compiled;
+    std::vector<std::string> conditions;
+
+    auto bind = [&compiled](auto value) {
+        if constexpr (std::is_convertible_v<decltype(value), std::string>) {
+            compiled.params.push_back(std::move(value));
+        } else {
+            compiled.params.push_back(std::format("{}", value));
+        }
+        return std::format("${}", compiled.params.size());
+    };
+
+    auto add_range = [&](const char* column, const auto& range) {
+        if (range.min) {
+            conditions.push_back(std::format("{} >= {}", column, bind(*range.min)));
+        }
+        if (range.max) {
+            conditions.push_back(std::format("{} <= {}", column, bind(*range.max)));
+        }
+    };
+
+    // 各条件は単純な列比較にしてインデックス（region / rating / spiciness / location）を使えるようにする
+    if (query.region) {
+        conditions.push_back(std::format("region = {}", bind(*query.region)));
+    }
+    add_range("rating", query.rating);
+    add_range("spiciness", query.spiciness);
+    add_range("stimulation", query.stimulation);
+    add_range("aroma", query.aroma);
+    if (query.bounds) {
+        const auto& box = *query.bounds;
+        conditions.push_back(std::format("latitude BETWEEN {} AND {}", bind(box.min_latitude), bind(box.max_latitude)));
+        conditions.push_back(std::format("longitude BETWEEN {} AND {}", bind(box.min_longitude), bind(box.max_longitude)));
+    }
+
+    // キーセットページング: 並び替えキーがカーソルより後ろの行だけ（OFFSET を使わない）
+    // shops.id は COLLATE "C"（schema.sql）なので、id の比較・並び順は主キーと
+    // (rating DESC, id) / (spiciness DESC, id) のインデックスにそのまま一致する。
+    // 降順キーは "<= カーソル" をインデックスの開始位置にし、同値の行だけを id で絞る
+    if (query.after) {
+        const auto& cursor = *query.after;
+        std::string id = bind(cursor.id);
+        switch (query.sort) {
+        case domain::ShopSort::RatingDesc: {
+            std::string key = bind(cursor.rating);
+            conditions.push_back(std::format(
+                "rating <= {0} AND (rating < {0} OR id > {1})", key, id));
+            break;
+        }
+        case domain::ShopSort::SpicinessDesc: {
+            std::string key = bind(cursor.spiciness);
+            conditions.push_back(std::format(
+                "spiciness <= {0} AND (spiciness < {0} OR id > {1})", key, id));
+            break;
+        }
+        case domain::ShopSort::Name:
+            conditions.push_back(std::format(
+                "(name COLLATE \"C\", id) > ({}, {})", bind(cursor.name), id));
+            break;
+        case domain::ShopSort::Id:
+            conditions.push_back(std::format("id > {}", id));
+            break;
+        }
+    }
+
+    compiled.sql = std::format("SELECT {} FROM shops", database::statements::kShopColumns);
+    for (size_t i = 0; i < conditions.size(); ++i) {
+        compiled.sql += i == 0 ? " WHERE " : " AND ";
+        compiled.sql += conditions[i];
+    }
+
+    // 同順位は id で決定的に並べる（バイト順なのでスナップショットの std::string 比較と同じ）
+    switch (query.sort) {
+    case domain::ShopSort::RatingDesc:
+        compiled.sql += " ORDER BY rating DESC, id";
+        break;
+    case domain::ShopSort::SpicinessDesc:
+        compiled.sql += " ORDER BY spiciness DESC, id";
+        break;
+    case domain::ShopSort::Name:
+        compiled.sql += " ORDER BY name COLLATE \"C\", id";
+        break;
+    case domain::ShopSort::Id:
+        compiled.sql += " ORDER BY id";
+        break;
+    }
+
+    if (query.limit) {
+        compiled.sql += std::format(" LIMIT {}", bind(*query.limit));
+    }
+
+    return compiled;
+}
+
+std::expected<std::vector<domain::Shop>, std::string>
+PostgresShopRepository::find_matching(const domain::ShopQuery& query) {
+    auto conn_result = pool_.acquire();
+    if (!conn_result.has_value()) {
+        return std::unexpected(conn_result.error());
+    }
+
+    auto& conn = conn_result.value();
+    auto compiled = compile_query(query);
+
+    try {
+        pqxx::nontransaction txn(conn.raw_connection());
+
+        pqxx::params params;
+        for (const auto& param : compiled.params) {
+            params.append(param);
+        }
+        auto result = txn.exec_params(compiled.sql, params);
+
+        std::vector<domain::Shop> shops;
+        shops.reserve(result.size());
+
+        for (const auto& row : result) {
+            shops.push_back(row_to_shop(row));
+        }
+
+        return shops;
+
+    } catch (const std::exception& e) {
+        return std::unexpected(
+            std::format("Failed to find matching shops: {}", e.what())
+        );
+    }
+}
+
 } // namespace repository
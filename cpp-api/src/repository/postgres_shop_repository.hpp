@@ -1,13 +1,24 @@
 #pragma once
 #include "repository/i_repository.hpp"
+#include "repository/i_shop_query_repository.hpp"
 #include "domain/shop.hpp"
+#include "domain/shop_query.hpp"
+#include "domain/shop_view.hpp"
 #include "database/connection_pool.hpp"
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace repository {
 
+// ShopQuery から組み立てた SQL とパラメータ（$1, $2, ... の順）
+struct CompiledShopQuery {
+    std::string sql;
+    std::vector<std::string> params;
+};
+
 // PostgreSQL実装のShopリポジトリ
-class PostgresShopRepository : public IRepository<domain::Shop> {
+class PostgresShopRepository : public IRepository<domain::Shop>, public IShopQueryRepository {
 public:
     explicit PostgresShopRepository(database::ConnectionPool& pool);
     ~PostgresShopRepository() override = default;
@@ -19,6 +30,14 @@ public:
     std::expected<domain::Shop, std::string> update(const domain::Shop& entity) override;
     std::expected<bool, std::string> remove(const std::string& id) override;
 
+    // COPY (pqxx::stream_from) で1行ずつデコードして渡す（結果セット全体を保持しない）
+    // 1行分の Shop を使い回すため、文字列のバッファも行をまたいで再利用される
+    std::expected<void, std::string> for_each(const std::function<bool(const domain::Shop&)>& visit) override;
+
+    // for_each と同じ順で、受信した行を直接参照するビューを渡す（行ごとのコピーなし）
+    // ビューは visit の呼び出し中だけ有効
+    std::expected<void, std::string> for_each_view(const std::function<bool(const domain::ShopView&)>& visit);
+
     // 拡張メソッド（PostgreSQL固有）
     std::expected<std::vector<domain::Shop>, std::string> find_by_region(const std::string& region);
     std::expected<std::vector<domain::Shop>, std::string> find_all_ordered_by_rating();
@@ -26,6 +45,12 @@ public:
         int min_spiciness, int max_spiciness
     );
 
+    // 検索条件で絞り込み・並べ替え（1回の SQL で実行）
+    std::expected<std::vector<domain::Shop>, std::string> find_matching(const domain::ShopQuery& query) override;
+
+    // 検索条件をパラメータ化した SELECT 文へ変換
+    static CompiledShopQuery compile_query(const domain::ShopQuery& query);
+
 private:
     database::ConnectionPool& pool_;
 
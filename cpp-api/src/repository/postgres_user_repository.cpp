@@ -1,4 +1,6 @@
 #include "repository/postgres_user_repository.hpp"
+#include <array>
+#include <charconv>
 #include <format>
 #include <print>
 #include <iostream>
@@ -40,6 +42,70 @@ domain::User PostgresUserRepository::row_to_user(const pqxx::row& row) {
     return user;
 }
 
+domain::User PostgresUserRepository::result_to_user(const database::PgResult& result, int row) {
+    auto text = [&](const char* name) -> std::optional<std::string> {
+        int column = result.column(name);
+        if (column < 0 || result.is_null(row, column)) {
+            return std::nullopt;
+        }
+        return std::string(result.value(row, column));
+    };
+    auto number = [&](const char* name, int fallback) {
+        int column = result.column(name);
+        if (column < 0 || result.is_null(row, column)) {
+            return fallback;
+        }
+        auto value = result.value(row, column);
+        int parsed = fallback;
+        std::from_chars(value.data(), value.data() + value.size(), parsed);
+        return parsed;
+    };
+
+    domain::User user;
+
+    user.id = text("id").value_or("");
+    user.username = text("username").value_or("");
+    user.email = text("email").value_or("");
+    user.display_name = text("display_name");
+    user.bio = text("bio");
+
+    user.preferences.spiciness = number("pref_spiciness", user.preferences.spiciness);
+    user.preferences.stimulation = number("pref_stimulation", user.preferences.stimulation);
+    user.preferences.aroma = number("pref_aroma", user.preferences.aroma);
+
+    // boolean はテキスト形式で "t" / "f"
+    user.is_public = text("is_public").value_or("t") == "t";
+
+    return user;
+}
+
+std::expected<std::optional<domain::UserProfile>, std::string>
+PostgresUserRepository::first_profile(database::QueryResult result) {
+    if (!result.has_value()) {
+        return std::unexpected(std::format("Failed to find user profile: {}", result.error()));
+    }
+    if (result->rows() == 0) {
+        return std::optional<domain::UserProfile>{};
+    }
+
+    domain::UserProfile profile;
+    profile.user = result_to_user(*result, 0);
+
+    for (auto [name, ids] : {std::pair{"favorite_shop_ids", &profile.favorite_shop_ids},
+                             std::pair{"disliked_shop_ids", &profile.disliked_shop_ids}}) {
+        int column = result->column(name);
+        if (column < 0 || result->is_null(0, column)) {
+            continue;
+        }
+        auto parsed = database::parse_text_array(result->value(0, column));
+        if (!parsed) {
+            return std::unexpected(std::format("Failed to find user profile: {}", parsed.error()));
+        }
+        *ids = std::move(*parsed);
+    }
+    return profile;
+}
+
 std::expected<std::vector<domain::User>, std::string>
 PostgresUserRepository::find_all() {
     auto conn_result = pool_.acquire();
@@ -49,15 +115,7 @@ PostgresUserRepository::find_all() {
 
     auto& conn = conn_result.value();
 
-    const std::string query = R"(
-        SELECT id, username, email, display_name, bio,
-               pref_spiciness, pref_stimulation, pref_aroma,
-               is_public, created_at, updated_at
-        FROM users
-        ORDER BY id
-    )";
-
-    auto result = conn.execute(query);
+    auto result = conn.execute_prepared(database::statements::kUserFindAll);
     if (!result.has_value()) {
         return std::unexpected(result.error());
     }
@@ -72,6 +130,39 @@ PostgresUserRepository::find_all() {
     return users;
 }
 
+std::expected<std::vector<domain::User>, std::string>
+PostgresUserRepository::find_page(size_t limit, const std::optional<std::string>& after_id) {
+    auto conn_result = pool_.acquire();
+    if (!conn_result.has_value()) {
+        return std::unexpected(conn_result.error());
+    }
+
+    auto& conn = conn_result.value();
+
+    try {
+        pqxx::nontransaction txn(conn.raw_connection());
+
+        // 主キーのインデックスを辿るだけで OFFSET による読み飛ばしは発生しない
+        auto result = after_id
+            ? txn.exec_prepared(database::statements::kUserFindPageAfter.name, *after_id, limit)
+            : txn.exec_prepared(database::statements::kUserFindFirstPage.name, limit);
+
+        std::vector<domain::User> users;
+        users.reserve(result.size());
+
+        for (const auto& row : result) {
+            users.push_back(row_to_user(row));
+        }
+
+        return users;
+
+    } catch (const std::exception& e) {
+        return std::unexpected(
+            std::format("Failed to find user page: {}", e.what())
+        );
+    }
+}
+
 std::expected<std::optional<domain::User>, std::string>
 PostgresUserRepository::find_by_id(const std::string& id) {
     auto conn_result = pool_.acquire();
@@ -82,17 +173,10 @@ PostgresUserRepository::find_by_id(const std::string& id) {
     auto& conn = conn_result.value();
 
     try {
-        pqxx::work txn(conn.raw_connection());
+        // 単一の SELECT なので BEGIN/ROLLBACK の往復を省く
+        pqxx::nontransaction txn(conn.raw_connection());
 
-        const std::string query = R"(
-            SELECT id, username, email, display_name, bio,
-                   pref_spiciness, pref_stimulation, pref_aroma,
-                   is_public, created_at, updated_at
-            FROM users
-            WHERE id = $1
-        )";
-
-        auto result = txn.exec_params(query, id);
+        auto result = txn.exec_prepared(database::statements::kUserFindById.name, id);
 
         if (result.empty()) {
             return std::optional<domain::User>{};
@@ -107,6 +191,50 @@ PostgresUserRepository::find_by_id(const std::string& id) {
     }
 }
 
+std::expected<std::optional<domain::UserProfile>, std::string>
+PostgresUserRepository::find_profile_by_id(const std::string& id) {
+    auto conn_result = pool_.acquire();
+    if (!conn_result.has_value()) {
+        return std::unexpected(conn_result.error());
+    }
+
+    auto& conn = conn_result.value();
+
+    // 3つの SELECT は互いに依存しないため、往復を1回にまとめる
+    const std::array<database::BatchQuery, 3> queries{{
+        {database::statements::kUserFindById, {id}},
+        {database::statements::kUserFavoriteShopIds, {id}},
+        {database::statements::kUserDislikedShopIds, {id}},
+    }};
+
+    auto results = conn.execute_batch(queries);
+    if (!results.has_value()) {
+        return std::unexpected(
+            std::format("Failed to find user profile: {}", results.error())
+        );
+    }
+
+    const auto& user_result = results.value()[0];
+    if (user_result.empty()) {
+        return std::optional<domain::UserProfile>{};
+    }
+
+    auto shop_ids = [](const pqxx::result& result) {
+        std::vector<std::string> ids;
+        ids.reserve(result.size());
+        for (const auto& row : result) {
+            ids.push_back(row["shop_id"].as<std::string>());
+        }
+        return ids;
+    };
+
+    domain::UserProfile profile;
+    profile.user = row_to_user(user_result[0]);
+    profile.favorite_shop_ids = shop_ids(results.value()[1]);
+    profile.disliked_shop_ids = shop_ids(results.value()[2]);
+    return profile;
+}
+
 std::expected<domain::User, std::string>
 PostgresUserRepository::add(const domain::User& user) {
     auto conn_result = pool_.acquire();
@@ -120,15 +248,8 @@ PostgresUserRepository::add(const domain::User& user) {
         pqxx::work txn(conn.raw_connection());
 
         // プリペアドステートメント（SQLインジェクション対策）
-        const std::string query = R"(
-            INSERT INTO users (username, email, display_name, bio,
-                             pref_spiciness, pref_stimulation, pref_aroma, is_public)
-            VALUES ($1, $2, $3, $4, $5, $6, $7, $8)
-            RETURNING id, created_at, updated_at
-        )";
-
-        auto result = txn.exec_params(
-            query,
+        auto result = txn.exec_prepared(
+            database::statements::kUserInsert.name,
             user.username,
             user.email,
             user.display_name.value_or(""),
@@ -173,6 +294,95 @@ PostgresUserRepository::add(const domain::User& user) {
     }
 }
 
+std::vector<std::expected<domain::User, std::string>>
+PostgresUserRepository::add_batch(std::span<const domain::User> users) {
+    std::vector<std::expected<domain::User, std::string>> results;
+    results.reserve(users.size());
+
+    if (users.size() == 1) {
+        results.push_back(add(users[0]));
+        return results;
+    }
+
+    {
+        auto conn_result = pool_.acquire();
+        if (!conn_result.has_value()) {
+            results.assign(users.size(), std::unexpected(conn_result.error()));
+            return results;
+        }
+
+        auto& conn = conn_result.value();
+
+        // 列ごとの配列（unnest で行に戻す）
+        std::vector<std::string> usernames, emails, display_names, bios, is_public;
+        std::vector<int> spiciness, stimulation, aroma;
+        for (auto* column : {&usernames, &emails, &display_names, &bios, &is_public}) {
+            column->reserve(users.size());
+        }
+        for (auto* column : {&spiciness, &stimulation, &aroma}) {
+            column->reserve(users.size());
+        }
+        for (const auto& user : users) {
+            usernames.push_back(user.username);
+            emails.push_back(user.email);
+            display_names.push_back(user.display_name.value_or(""));
+            bios.push_back(user.bio.value_or(""));
+            spiciness.push_back(user.preferences.spiciness);
+            stimulation.push_back(user.preferences.stimulation);
+            aroma.push_back(user.preferences.aroma);
+            is_public.push_back(user.is_public ? "t" : "f");
+        }
+
+        try {
+            pqxx::work txn(conn.raw_connection());
+
+            auto inserted = txn.exec_prepared(
+                database::statements::kUserInsertBatch.name,
+                usernames, emails, display_names, bios,
+                spiciness, stimulation, aroma, is_public
+            );
+
+            txn.commit();
+
+            // RETURNING の行を入力に対応付ける（同じ username / email が複数あれば先の行が登録される）
+            std::vector<std::optional<std::string>> ids(users.size());
+            for (const auto& row : inserted) {
+                auto username = row["username"].as<std::string>();
+                auto email = row["email"].as<std::string>();
+                for (size_t i = 0; i < users.size(); ++i) {
+                    if (!ids[i] && users[i].username == username && users[i].email == email) {
+                        ids[i] = row["id"].as<std::string>();
+                        break;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < users.size(); ++i) {
+                if (!ids[i]) {
+                    results.push_back(std::unexpected("User already exists"));
+                    continue;
+                }
+                domain::User inserted_user = users[i];
+                inserted_user.id = std::move(*ids[i]);
+                results.push_back(std::move(inserted_user));
+            }
+
+            return results;
+
+        } catch (const std::exception& e) {
+            // CHECK 制約違反などで文全体が失敗したときは、原因の行だけが失敗するよう1件ずつ登録し直す
+            std::cerr << "Batch insert failed, retrying row by row: " << e.what() << std::endl;
+        }
+    }
+
+    // バッチの接続を返却してから1件ずつ登録し直す
+    results.clear();
+    for (const auto& user : users) {
+        results.push_back(add(user));
+    }
+    return results;
+}
+
 std::expected<domain::User, std::string>
 PostgresUserRepository::update(const domain::User& user) {
     auto conn_result = pool_.acquire();
@@ -185,19 +395,8 @@ PostgresUserRepository::update(const domain::User& user) {
     try {
         pqxx::work txn(conn.raw_connection());
 
-        const std::string query = R"(
-            UPDATE users
-            SET username = $2, email = $3, display_name = $4, bio = $5,
-                pref_spiciness = $6, pref_stimulation = $7, pref_aroma = $8,
-                is_public = $9, updated_at = CURRENT_TIMESTAMP
-            WHERE id = $1
-            RETURNING id, username, email, display_name, bio,
-                      pref_spiciness, pref_stimulation, pref_aroma,
-                      is_public, created_at, updated_at
-        )";
-
-        auto result = txn.exec_params(
-            query,
+        auto result = txn.exec_prepared(
+            database::statements::kUserUpdate.name,
             user.id,
             user.username,
             user.email,
@@ -243,8 +442,7 @@ PostgresUserRepository::remove(const std::string& id) {
     try {
         pqxx::work txn(conn.raw_connection());
 
-        const std::string query = "DELETE FROM users WHERE id = $1";
-        auto result = txn.exec_params(query, id);
+        auto result = txn.exec_prepared(database::statements::kUserDelete.name, id);
 
         txn.commit();
 
@@ -267,17 +465,9 @@ PostgresUserRepository::find_by_username(const std::string& username) {
     auto& conn = conn_result.value();
 
     try {
-        pqxx::work txn(conn.raw_connection());
-
-        const std::string query = R"(
-            SELECT id, username, email, display_name, bio,
-                   pref_spiciness, pref_stimulation, pref_aroma,
-                   is_public, created_at, updated_at
-            FROM users
-            WHERE username = $1
-        )";
+        pqxx::nontransaction txn(conn.raw_connection());
 
-        auto result = txn.exec_params(query, username);
+        auto result = txn.exec_prepared(database::statements::kUserFindByUsername.name, username);
 
         if (result.empty()) {
             return std::optional<domain::User>{};
@@ -302,17 +492,9 @@ PostgresUserRepository::find_by_email(const std::string& email) {
     auto& conn = conn_result.value();
 
     try {
-        pqxx::work txn(conn.raw_connection());
-
-        const std::string query = R"(
-            SELECT id, username, email, display_name, bio,
-                   pref_spiciness, pref_stimulation, pref_aroma,
-                   is_public, created_at, updated_at
-            FROM users
-            WHERE email = $1
-        )";
+        pqxx::nontransaction txn(conn.raw_connection());
 
-        auto result = txn.exec_params(query, email);
+        auto result = txn.exec_prepared(database::statements::kUserFindByEmail.name, email);
 
         if (result.empty()) {
             return std::optional<domain::User>{};
@@ -2,7 +2,10 @@
 #include "repository/i_repository.hpp"
 #include "domain/user.hpp"
 #include "database/connection_pool.hpp"
+#include "database/async_pool.hpp"
+#include <stdexec/execution.hpp>
 #include <memory>
+#include <span>
 
 namespace repository {
 
@@ -19,15 +22,40 @@ public:
     std::expected<domain::User, std::string> update(const domain::User& entity) override;
     std::expected<bool, std::string> remove(const std::string& id) override;
 
+    // 複数ユーザーを1回の INSERT・コミットで登録し、users と同じ順に行ごとの結果を返す
+    // （重複した行は "User already exists"、それ以外の失敗時は1件ずつ add で登録し直す）
+    std::vector<std::expected<domain::User, std::string>> add_batch(std::span<const domain::User> users);
+
     // 拡張メソッド（PostgreSQL固有）
     std::expected<std::optional<domain::User>, std::string> find_by_username(const std::string& username);
     std::expected<std::optional<domain::User>, std::string> find_by_email(const std::string& email);
 
+    // ユーザーとお気に入り・苦手な店舗を1回の往復で取得（ユーザーがいなければ nullopt）
+    std::expected<std::optional<domain::UserProfile>, std::string> find_profile_by_id(const std::string& id);
+
+    // id 順に最大 limit 件（after_id を指定するとその次から、キーセットページング）
+    std::expected<std::vector<domain::User>, std::string> find_page(
+        size_t limit, const std::optional<std::string>& after_id
+    );
+
+    // 非同期版（AsyncPool の I/O スレッドで完了する sender、待っている間ワーカーを占有しない）
+    // find_profile_by_id と同じ内容を1文（kUserFindProfileById）で取得する
+    static auto async_find_profile_by_id(database::AsyncPool& pool, std::string id) {
+        return pool.query(database::statements::kUserFindProfileById, {std::move(id)})
+             | stdexec::then(&PostgresUserRepository::first_profile);
+    }
+
+    // クエリ結果の先頭行を UserProfile に変換（0 行なら nullopt）
+    static std::expected<std::optional<domain::UserProfile>, std::string> first_profile(database::QueryResult result);
+
 private:
     database::ConnectionPool& pool_;
 
     // pqxx::row から User エンティティへの変換
     domain::User row_to_user(const pqxx::row& row);
+
+    // libpq の結果（テキスト形式）から User エンティティへの変換
+    static domain::User result_to_user(const database::PgResult& result, int row);
 };
 
 } // namespace repository
@@ -0,0 +1,129 @@
+#include "repository/user_write_combiner.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <optional>
+#include <print>
+
+namespace repository {
+
+WriteCombinerOptions WriteCombinerOptions::from_env() {
+    WriteCombinerOptions options;
+
+    auto read_env = [](const char* name) -> std::optional<int> {
+        const char* value = std::getenv(name);
+        if (!value) {
+            return std::nullopt;
+        }
+        int parsed = std::atoi(value);
+        if (parsed < 0 || (parsed == 0 && std::string(value) != "0")) {
+            std::println("⚠️  Invalid {} value, using default", name);
+            return std::nullopt;
+        }
+        return parsed;
+    };
+
+    if (auto max_batch = read_env("USER_INSERT_BATCH_MAX"); max_batch && *max_batch > 0) {
+        options.max_batch = static_cast<size_t>(*max_batch);
+    }
+    return options;
+}
+
+UserWriteCombiner::UserWriteCombiner(BatchInsert insert_batch, WriteCombinerOptions options)
+    : insert_batch_(std::move(insert_batch))
+    , options_(options) {
+    options_.max_batch = std::max<size_t>(options_.max_batch, 1);
+    thread_ = std::jthread([this](std::stop_token stop_token) { run(stop_token); });
+}
+
+UserWriteCombiner::~UserWriteCombiner() {
+    stop();
+}
+
+std::expected<domain::User, std::string> UserWriteCombiner::add(const domain::User& user) {
+    auto [result] = stdexec::sync_wait(insert(user)).value();
+    return result;
+}
+
+void UserWriteCombiner::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    thread_.request_stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+WriteCombinerMetrics UserWriteCombiner::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_;
+}
+
+void UserWriteCombiner::submit(PendingInsert* pending) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopped_) {
+            pending_.push_back(pending);
+            // 書き込みスレッドが待っているのは空のときだけ
+            if (pending_.size() == 1) {
+                cv_.notify_one();
+            }
+            return;
+        }
+    }
+    pending->complete(pending, std::unexpected(std::string("User registration is shutting down")));
+}
+
+void UserWriteCombiner::run(std::stop_token stop_token) {
+    while (true) {
+        std::vector<PendingInsert*> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, stop_token, [this] { return !pending_.empty(); });
+            if (pending_.empty()) {
+                return;  // 停止要求があり、ためている登録もない
+            }
+
+            // 待たずに届いている分を書き込む（前のバッチの書き込み中に届いた分がまとまる）
+            size_t count = std::min(pending_.size(), options_.max_batch);
+            batch.assign(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+            pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+        }
+
+        write(batch);
+    }
+}
+
+void UserWriteCombiner::write(std::vector<PendingInsert*>& batch) {
+    std::vector<domain::User> users;
+    users.reserve(batch.size());
+    for (auto* pending : batch) {
+        users.push_back(std::move(pending->user));
+    }
+
+    std::vector<std::expected<domain::User, std::string>> results;
+    try {
+        results = insert_batch_(users);
+    } catch (const std::exception& e) {
+        std::println("⚠️  User batch insert failed: {}", e.what());
+    }
+    if (results.size() != batch.size()) {
+        results.assign(batch.size(), std::unexpected(std::string("Internal server error")));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metrics_.batches += 1;
+        metrics_.rows += batch.size();
+        metrics_.max_batch = std::max<std::uint64_t>(metrics_.max_batch, batch.size());
+    }
+
+    // complete の後はオペレーションステートが破棄されうるため、その要素には触れない
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch[i]->complete(batch[i], std::move(results[i]));
+    }
+}
+
+} // namespace repository
@@ -0,0 +1,157 @@
+#pragma once
+#include "domain/user.hpp"
+#include <stdexec/execution.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace repository {
+
+// 書き込みをまとめる単位
+struct WriteCombinerOptions {
+    size_t max_batch = 64;  // 1回の INSERT に含める最大件数（残りは次のバッチ）
+
+    // 環境変数 USER_INSERT_BATCH_MAX から読み込む（未設定・不正な値は既定値）
+    static WriteCombinerOptions from_env();
+};
+
+// 統計（各値は取得時点の概算）
+struct WriteCombinerMetrics {
+    std::uint64_t batches = 0;    // 書き込んだバッチ数
+    std::uint64_t rows = 0;       // 書き込んだ行数（失敗した行を含む）
+    std::uint64_t max_batch = 0;  // 最大のバッチの行数
+};
+
+// ユーザー登録のグループコミット
+// 書き込みスレッドは待たずに届いている登録（最大 max_batch 件）を1回の複数行 INSERT
+// （1回のコミット）で書き込み、各呼び出し元へ行ごとの結果を返す。
+// 書き込み中に届いた登録が次のバッチになるため、負荷が低ければ1件ずつ遅延なく、
+// 高ければコミットの待ち時間に比例した大きさのバッチで書き込む。
+// insert() の sender は書き込みまで呼び出し元のスレッドを占有しない
+class UserWriteCombiner {
+public:
+    class InsertSender;
+
+    // users と同じ順で行ごとの結果を返す書き込み関数
+    using BatchInsert = std::function<
+        std::vector<std::expected<domain::User, std::string>>(std::span<const domain::User> users)>;
+
+    UserWriteCombiner(BatchInsert insert_batch, WriteCombinerOptions options = {});
+
+    // stop() してから破棄する
+    ~UserWriteCombiner();
+
+    UserWriteCombiner(const UserWriteCombiner&) = delete;
+    UserWriteCombiner& operator=(const UserWriteCombiner&) = delete;
+
+    // 登録を投入し、結果（PostgresUserRepository::add と同じ）で完了する sender
+    // 完了は書き込みスレッド上で通知されるため、重い処理は continues_on でワーカーへ移すこと
+    // user がエラーならキューに入れずにそのエラーで完了する
+    InsertSender insert(std::expected<domain::User, std::string> user);
+
+    // 登録を投入し、書き込まれるまで待つ
+    std::expected<domain::User, std::string> add(const domain::User& user);
+
+    // ためている登録を書き込んでから書き込みスレッドを止める（以降の登録はエラーで完了する）
+    void stop();
+
+    WriteCombinerMetrics metrics() const;
+
+private:
+    using InsertResult = std::expected<domain::User, std::string>;
+
+    // 投入された登録（sender のオペレーションステートが継承する）
+    struct PendingInsert {
+        domain::User user;
+        void (*complete)(PendingInsert*, InsertResult&&) noexcept = nullptr;
+    };
+
+    void submit(PendingInsert* pending);
+    void run(std::stop_token stop_token);
+    void write(std::vector<PendingInsert*>& batch);
+
+    BatchInsert insert_batch_;
+    WriteCombinerOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::deque<PendingInsert*> pending_;
+    bool stopped_ = false;
+
+    WriteCombinerMetrics metrics_;
+
+    std::jthread thread_;
+};
+
+// UserWriteCombiner で登録する sender
+class UserWriteCombiner::InsertSender {
+public:
+    using sender_concept = stdexec::sender_t;
+    using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t(InsertResult)>;
+
+    InsertSender(UserWriteCombiner* combiner, InsertResult user)
+        : combiner_(combiner), user_(std::move(user)) {}
+
+    template <class Receiver>
+    struct Operation : PendingInsert {
+        UserWriteCombiner* combiner;
+        Receiver receiver;
+        std::optional<std::string> rejected;  // 投入前のエラー
+
+        Operation(UserWriteCombiner* c, InsertResult user, Receiver r)
+            : combiner(c), receiver(std::move(r)) {
+            if (user) {
+                this->user = std::move(user.value());
+            } else {
+                rejected = std::move(user.error());
+            }
+            this->complete = &Operation::on_complete;
+        }
+
+        Operation(const Operation&) = delete;
+        Operation& operator=(const Operation&) = delete;
+
+        static void on_complete(PendingInsert* pending, InsertResult&& result) noexcept {
+            auto* self = static_cast<Operation*>(pending);
+            stdexec::set_value(std::move(self->receiver), std::move(result));
+        }
+
+        void start() & noexcept {
+            if (rejected) {
+                on_complete(this, std::unexpected(std::move(*rejected)));
+                return;
+            }
+            combiner->submit(this);
+        }
+    };
+
+    template <stdexec::receiver Receiver>
+    Operation<Receiver> connect(Receiver receiver) && {
+        return Operation<Receiver>(combiner_, std::move(user_), std::move(receiver));
+    }
+
+    template <stdexec::receiver Receiver>
+    Operation<Receiver> connect(Receiver receiver) const& {
+        return Operation<Receiver>(combiner_, user_, std::move(receiver));
+    }
+
+private:
+    UserWriteCombiner* combiner_;
+    InsertResult user_;
+};
+
+inline UserWriteCombiner::InsertSender UserWriteCombiner::insert(std::expected<domain::User, std::string> user) {
+    return InsertSender(this, std::move(user));
+}
+
+} // namespace repository
@@ -0,0 +1,249 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace router {
+
+// HTTP メソッド
+enum class Method : std::uint8_t {
+    Get,
+    Post,
+    Put,
+    Patch,
+    Delete,
+    Head,
+    Options,
+    Unknown
+};
+
+inline constexpr size_t kMethodCount = static_cast<size_t>(Method::Unknown);
+
+constexpr Method parse_method(std::string_view method) {
+    if (method == "GET") return Method::Get;
+    if (method == "POST") return Method::Post;
+    if (method == "PUT") return Method::Put;
+    if (method == "PATCH") return Method::Patch;
+    if (method == "DELETE") return Method::Delete;
+    if (method == "HEAD") return Method::Head;
+    if (method == "OPTIONS") return Method::Options;
+    return Method::Unknown;
+}
+
+// パスパラメータの型（{name} は任意の文字列、{name:int} は数字のみ）
+enum class ParamType : std::uint8_t {
+    String,
+    Integer
+};
+
+// ルート定義（pattern は "/api/shops/{id}" の形式）
+template <typename Id>
+struct RouteDef {
+    Method method;
+    std::string_view pattern;
+    Id id;
+};
+
+// 1つのパスに含められるパラメータの上限
+inline constexpr size_t kMaxPathParams = 4;
+
+// 照合結果（params はリクエストのパスへの string_view）
+template <typename Id>
+struct RouteMatch {
+    Id id{};                      // 一致しなければ Id{}
+    bool path_matched = false;    // パスは一致したがメソッドが異なる（405）
+    std::array<std::string_view, kMaxPathParams> params{};
+    size_t param_count = 0;
+
+    explicit operator bool() const { return id != Id{}; }
+
+    std::string_view param(size_t i) const { return params[i]; }
+};
+
+// コンパイル時に構築するパスセグメント単位のトライ
+// ルートの重複や不正なパターンはコンパイルエラーになる。
+// 照合はパスを走査するだけでメモリを確保せず、リテラルのセグメントを
+// パラメータより優先する（"/api/shops/nearby" は "/api/shops/{id}" より先に一致）。
+// Id{} は「ルートなし」を表すため、ルートの Id には使えない
+template <typename Id, size_t MaxNodes>
+class RouteTable {
+public:
+    template <size_t N>
+    consteval explicit RouteTable(const std::array<RouteDef<Id>, N>& routes) {
+        nodes_[0] = Node{};
+        for (const auto& route : routes) {
+            insert(route);
+        }
+    }
+
+    // method と path（クエリを含まない）を照合する
+    constexpr RouteMatch<Id> match(Method method, std::string_view path) const {
+        RouteMatch<Id> result;
+        if (path.empty() || path.front() != '/') {
+            return result;
+        }
+        // "/" はルートノードそのもの
+        match_node(0, path, path.size() == 1 ? path.size() : 0, method, result);
+        return result;
+    }
+
+    constexpr size_t node_count() const { return size_; }
+
+private:
+    static constexpr std::uint16_t kNone = 0;  // 子・兄弟なし（ルートノードは子にならない）
+
+    struct Node {
+        std::string_view literal{};   // is_param でなければセグメントの文字列
+        bool is_param = false;
+        ParamType param_type = ParamType::String;
+        std::uint16_t first_child = kNone;
+        std::uint16_t next_sibling = kNone;
+        std::array<Id, kMethodCount> routes{};
+    };
+
+    std::array<Node, MaxNodes> nodes_{};
+    size_t size_ = 1;
+
+    // パターンの1セグメントをノードの条件へ変換
+    static consteval Node parse_segment(std::string_view segment) {
+        Node node;
+        if (segment.empty()) {
+            throw "route pattern must not contain empty segments";
+        }
+        if (segment.front() != '{') {
+            node.literal = segment;
+            return node;
+        }
+        if (segment.back() != '}') {
+            throw "unterminated path parameter";
+        }
+        node.is_param = true;
+        auto spec = segment.substr(1, segment.size() - 2);
+        auto colon = spec.find(':');
+        if (colon != std::string_view::npos) {
+            auto type = spec.substr(colon + 1);
+            if (type == "int") {
+                node.param_type = ParamType::Integer;
+            } else if (type != "string") {
+                throw "unknown path parameter type";
+            }
+        }
+        return node;
+    }
+
+    consteval void insert(const RouteDef<Id>& route) {
+        if (route.pattern.empty() || route.pattern.front() != '/' || route.method == Method::Unknown) {
+            throw "route pattern must start with '/'";
+        }
+        if (route.id == Id{}) {
+            throw "route id must not be the default value";
+        }
+
+        std::uint16_t node = 0;
+        size_t params = 0;
+        size_t pos = 1;
+        while (pos <= route.pattern.size() && route.pattern.size() > 1) {
+            size_t end = route.pattern.find('/', pos);
+            if (end == std::string_view::npos) {
+                end = route.pattern.size();
+            }
+            auto segment = parse_segment(route.pattern.substr(pos, end - pos));
+            if (segment.is_param && ++params > kMaxPathParams) {
+                throw "too many path parameters";
+            }
+            node = find_or_add_child(node, segment);
+            pos = end + 1;
+        }
+
+        auto& slot = nodes_[node].routes[static_cast<size_t>(route.method)];
+        if (slot != Id{}) {
+            throw "duplicate route";
+        }
+        slot = route.id;
+    }
+
+    consteval std::uint16_t find_or_add_child(std::uint16_t parent, const Node& segment) {
+        std::uint16_t* link = &nodes_[parent].first_child;
+        while (*link != kNone) {
+            const auto& child = nodes_[*link];
+            if (child.is_param == segment.is_param &&
+                (segment.is_param ? child.param_type == segment.param_type : child.literal == segment.literal)) {
+                return *link;
+            }
+            link = &nodes_[*link].next_sibling;
+        }
+        if (size_ >= MaxNodes) {
+            throw "route table is full";
+        }
+        nodes_[size_] = segment;
+        *link = static_cast<std::uint16_t>(size_);
+        return static_cast<std::uint16_t>(size_++);
+    }
+
+    static constexpr bool accepts(const Node& node, std::string_view segment) {
+        if (!node.is_param) {
+            return node.literal == segment;
+        }
+        if (segment.empty()) {
+            return false;
+        }
+        if (node.param_type == ParamType::Integer) {
+            for (char c : segment) {
+                if (c < '0' || c > '9') {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // pos は次のセグメントの直前の '/' の位置（パスの終端なら path.size()）
+    constexpr bool match_node(std::uint16_t index, std::string_view path, size_t pos,
+                              Method method, RouteMatch<Id>& result) const {
+        const auto& node = nodes_[index];
+
+        if (pos >= path.size()) {
+            for (auto id : node.routes) {
+                if (id != Id{}) {
+                    result.path_matched = true;
+                    break;
+                }
+            }
+            if (method == Method::Unknown) {
+                return false;
+            }
+            result.id = node.routes[static_cast<size_t>(method)];
+            return result.id != Id{};
+        }
+
+        size_t begin = pos + 1;
+        size_t end = path.find('/', begin);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
+        auto segment = path.substr(begin, end - begin);
+
+        // リテラルを先に、次にパラメータを試す（一致しなければ戻って次の候補へ）
+        for (bool params : {false, true}) {
+            for (auto child = node.first_child; child != kNone; child = nodes_[child].next_sibling) {
+                const auto& candidate = nodes_[child];
+                if (candidate.is_param != params || !accepts(candidate, segment)) {
+                    continue;
+                }
+                if (params) {
+                    result.params[result.param_count++] = segment;
+                }
+                if (match_node(child, path, end, method, result)) {
+                    return true;
+                }
+                if (params) {
+                    --result.param_count;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace router
@@ -1,7 +1,15 @@
 #include "router.hpp"
+#include "../serialization/json_writer.hpp"
+#include "../validation/finite.hpp"
 #include <format>
+#include <print>
 #include <algorithm>
-#include <sstream>
+#include <iterator>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <array>
+#include <ranges>
 
 namespace router {
 
@@ -14,99 +22,226 @@ Router::Router(std::shared_ptr<service::ShopService> shop_service,
     , shops_json_(std::move(shops_json))
     , users_json_(std::move(users_json)) {}
 
-std::string Router::route(std::string_view request) {
-    std::string full_path = extract_path(request);
-    std::string method = extract_method(request);
+bool Router::route(const http::Request& request, http::OutputBuffer& output, const http::FlushHandler& flush) {
+    // リクエスト中の一時的なメモリはスレッドごとのアリーナから確保し、送信データを
+    // output へ移し終えたらまとめて捨てる
+    auto& arena = http::RequestArena::for_this_thread();
+    http::RequestArena::Scope arena_scope(arena);
 
-    // クエリパラメータを分離
-    auto query_pos = full_path.find('?');
-    std::string path = (query_pos != std::string::npos) ? full_path.substr(0, query_pos) : full_path;
-    auto query_params = extract_query_params(full_path);
-
-    // OpenAPI準拠のRESTful ルーティング
-    // Health & Monitoring endpoints
-    if ((path == "/health" || path == "/api/health") && method == "GET") {
-        return handle_health();
+    auto response = dispatch(request, arena);
+    if (response.stream_body) {
+        return write_streamed_response(std::move(response), request, output, flush);
     }
-    else if ((path == "/metrics" || path == "/api/metrics") && method == "GET") {
-        return handle_metrics();
-    }
-    // OpenAPI specification endpoint
-    else if (path == "/api/openapi.yaml" && method == "GET") {
-        return handle_openapi_spec();
-    }
-    // Shops endpoints
-    else if (path == "/api/shops" && method == "GET") {
-        return handle_get_shops(query_params);
+    return write_response(std::move(response), request.keep_alive, output);
+}
+
+void Router::reject(int status_code, std::string_view message, http::OutputBuffer& output) {
+    write_response(
+        create_error_response(std::string(message), status_code, "INVALID_REQUEST"),
+        false,
+        output
+    );
+}
+
+std::optional<DeferredRequest> Router::defer(const http::Request& request) const {
+    if (!has_deferred_routes()) {
+        return std::nullopt;
     }
-    else if (path.starts_with("/api/shops/") && method == "GET") {
-        auto shop_id = extract_path_param(path, "/api/shops/");
-        if (shop_id) {
-            return handle_get_shop_by_id(*shop_id);
-        }
+
+    auto match = kRouteTable.match(parse_method(request.method), request.path);
+    if (match.id == RouteId::GetUserById && async_pool_) {
+        return DeferredRequest{match.id, std::string(match.param(0)), {}, request.keep_alive};
     }
-    // Users endpoints
-    else if (path == "/api/users" && method == "GET") {
-        return handle_get_users();
+    // 空のボディは handle_post_user がその場で 400 を返す
+    if (match.id == RouteId::PostUser && user_service_->write_combining_enabled() && !request.body.empty()) {
+        return DeferredRequest{match.id, {}, std::string(request.body), request.keep_alive};
     }
-    else if (path == "/api/users" && method == "POST") {
-        std::string body = extract_body(request);
-        return handle_post_user(body);
+    return std::nullopt;
+}
+
+Response Router::dispatch(const http::Request& request, http::RequestArena& arena) {
+    auto match = kRouteTable.match(parse_method(request.method), request.path);
+
+    // クエリパラメータは受信バッファを参照したまま必要な分だけ取り出し、
+    // パーセントデコードが必要な値だけをアリーナへ書き出す
+    http::QueryParams query_params(request.query, arena);
+
+    switch (match.id) {
+    case RouteId::Health:
+        return handle_health();
+    case RouteId::Metrics:
+        return handle_metrics();
+    case RouteId::OpenApiSpec:
+        return handle_openapi_spec();
+    case RouteId::GetShops:
+        return handle_get_shops(query_params, arena.resource());
+    case RouteId::GetNearbyShops:
+        return handle_get_nearby_shops(query_params, arena.resource());
+    case RouteId::ExportShops:
+        return handle_export_shops();
+    case RouteId::GetShopById:
+        return handle_get_shop_by_id(match.param(0));
+    case RouteId::GetUsers:
+        return handle_get_users(query_params);
+    case RouteId::PostUser:
+        return handle_post_user(request.body);
+    case RouteId::GetUserById:
+        return handle_get_user_by_id(std::string(match.param(0)));
+    case RouteId::GetRecommendations:
+        return handle_get_recommendations(std::string(match.param(0)), query_params, arena.resource());
+    case RouteId::None:
+        break;
     }
-    else if (path.starts_with("/api/users/") && method == "GET") {
-        auto user_id = extract_path_param(path, "/api/users/");
-        if (user_id) {
-            return handle_get_user_by_id(*user_id);
-        }
+
+    if (match.path_matched) {
+        return create_error_response("Method not allowed", 405, "METHOD_NOT_ALLOWED");
     }
 
     // 404 Not Found
     return handle_not_found();
 }
 
-std::string Router::handle_health() {
+Response Router::handle_health() {
     return create_json_response(
         R"({"status":"OK","message":"Spice Curry C++26 API Server with stdexec","timestamp":"2024-01-01T00:00:00Z"})"
     );
 }
 
-std::string Router::handle_metrics() {
-    return create_json_response(
-        R"({"api":"C++26","stdexec":"active","async":"sender-receiver","architecture":"clean"})"
-    );
+void Router::add_metrics_section(std::string name, MetricsWriter writer) {
+    metrics_sections_.emplace_back(std::move(name), std::move(writer));
 }
 
-std::string Router::handle_get_shops(const std::unordered_map<std::string, std::string>& query_params) {
+Response Router::handle_metrics() {
+    std::string json;
+    serialization::JsonWriter writer(json);
+    writer.begin_object()
+        .key("api").value("C++26")
+        .key("stdexec").value("active")
+        .key("async").value("sender-receiver")
+        .key("architecture").value("clean");
+    for (const auto& [name, write_section] : metrics_sections_) {
+        writer.key(name);
+        write_section(writer);
+    }
+    writer.end_object();
+    return create_json_response(std::move(json));
+}
+
+Response Router::handle_get_shops(const http::QueryParams& query_params, std::pmr::memory_resource* arena) {
     if (!shop_service_) {
         return create_error_response("Shop service not available", 503, "SERVICE_UNAVAILABLE");
     }
 
-    auto result = shop_service_->get_all_shops_json();
+    auto query = parse_shop_query(query_params);
+    if (!query) {
+        return create_error_response(query.error(), 400, "INVALID_REQUEST");
+    }
+
+    // 条件がなければスナップショットのレンダリング済み JSON をそのまま送信
+    auto result = shop_service_->query_shops_page(query.value(), arena);
     if (!result) {
         return create_error_response(result.error(), 500, "INTERNAL_ERROR");
     }
 
-    return create_json_response(result.value());
+    return create_page_response(std::move(result.value()));
 }
 
-std::string Router::handle_get_shop_by_id(const std::string& shop_id) {
+Response Router::handle_get_nearby_shops(const http::QueryParams& query_params, std::pmr::memory_resource* arena) {
     if (!shop_service_) {
         return create_error_response("Shop service not available", 503, "SERVICE_UNAVAILABLE");
     }
 
-    auto result = shop_service_->get_shop_by_id_json(shop_id);
+    auto param = [&query_params](const char* name) { return parse_number_param(query_params, name); };
+
+    auto lat = param("lat");
+    auto lng = param("lng");
+    if (!lat || !lng || std::abs(*lat) > 90.0 || std::abs(*lng) > 180.0) {
+        return create_error_response("lat and lng are required", 400, "INVALID_REQUEST");
+    }
+
+    auto radius_km = param("radiusKm");
+    auto limit = param("limit");
+    if ((radius_km && (*radius_km < 0.0 || *radius_km > kMaxRadiusKm)) || (limit && (*limit < 1.0 || *limit > 1000.0))) {
+        return create_error_response("Invalid radiusKm or limit", 400, "INVALID_REQUEST");
+    }
+
+    // limit 指定時は k近傍（radiusKm は上限）、それ以外は半径検索（デフォルト 5km）
+    auto result = limit
+        ? shop_service_->find_nearest_shops_json(
+              *lat, *lng, static_cast<size_t>(*limit),
+              radius_km.value_or(std::numeric_limits<double>::infinity()), arena)
+        : shop_service_->find_nearby_shops_json(*lat, *lng, radius_km.value_or(5.0), arena);
+    if (!result) {
+        return create_error_response(result.error(), 500, "INTERNAL_ERROR");
+    }
+
+    return create_json_response(std::move(result.value()));
+}
+
+Response Router::handle_get_shop_by_id(std::string_view shop_id) {
+    if (!shop_service_) {
+        return create_error_response("Shop service not available", 503, "SERVICE_UNAVAILABLE");
+    }
+
+    auto result = shop_service_->get_shop_by_id_shared_json(shop_id);
     if (!result) {
         return create_error_response(result.error(), 404, "NOT_FOUND");
     }
 
-    return create_json_response(result.value());
+    return create_shared_json_response(std::move(result.value()));
+}
+
+Response Router::handle_export_shops() {
+    if (!shop_service_) {
+        return create_error_response("Shop service not available", 503, "SERVICE_UNAVAILABLE");
+    }
+
+    // スナップショットを使わず、データベースから読んだ行をそのまま送信する
+    Response response;
+    response.stream_body = [shop_service = shop_service_](http::ChunkedWriter& writer) {
+        auto result = shop_service->stream_all_shops_json([&writer](std::string_view json) {
+            return writer.write(json);
+        });
+        if (!result) {
+            std::println("⚠️  Shop export aborted: {}", result.error());
+            return false;
+        }
+        return true;
+    };
+    return response;
 }
 
-std::string Router::handle_get_users() {
-    return create_json_response(users_json_);
+Response Router::handle_get_users(const http::QueryParams& query_params) {
+    if (!user_service_) {
+        return create_json_response(users_json_);
+    }
+
+    size_t limit = kDefaultPageSize;
+    if (query_params.contains("limit")) {
+        auto value = parse_number_param(query_params, "limit");
+        if (!value || *value < 1.0 || *value > static_cast<double>(kMaxPageSize)) {
+            return create_error_response("limit must be between 1 and 1000", 400, "INVALID_REQUEST");
+        }
+        limit = static_cast<size_t>(*value);
+    }
+
+    std::optional<std::string> after;
+    if (auto value = query_params.find("after")) {
+        after = std::string(*value);
+    }
+
+    auto result = user_service_->list_users_page(limit, after);
+    if (!result) {
+        if (result.error() == "Invalid cursor") {
+            return create_error_response("Invalid cursor", 400, "INVALID_REQUEST");
+        }
+        return create_error_response(result.error(), 500, "INTERNAL_ERROR");
+    }
+
+    return create_page_response(std::move(result.value()));
 }
 
-std::string Router::handle_post_user(std::string_view body) {
+Response Router::handle_post_user(std::string_view body) {
     if (!user_service_) {
         return create_error_response("User service not available", 503, "SERVICE_UNAVAILABLE");
     }
@@ -116,11 +251,13 @@ std::string Router::handle_post_user(std::string_view body) {
     }
 
     // UserServiceでユーザー登録処理
-    auto result = user_service_->create_user_from_json(std::string(body));
+    return post_user_response(user_service_->create_user_from_json(std::string(body)));
+}
 
+Response Router::post_user_response(std::expected<std::string, std::string> result) {
     if (!result) {
         // エラーの種類に応じたステータスコード
-        std::string error_msg = result.error();
+        const std::string& error_msg = result.error();
 
         if (error_msg.find("already exists") != std::string::npos) {
             // 重複エラー
@@ -136,18 +273,88 @@ std::string Router::handle_post_user(std::string_view body) {
     }
 
     // 成功時は201 Created
-    return create_json_response(result.value(), 201);
+    return create_json_response(std::move(result.value()), 201);
 }
 
-std::string Router::handle_get_user_by_id(const std::string& user_id) {
-    // TODO: JSONから特定のuserを検索
-    if (users_json_.find("\"id\":\"" + user_id + "\"") != std::string::npos) {
-        return create_json_response(users_json_);
+Response Router::handle_get_user_by_id(const std::string& user_id) {
+    if (!user_service_) {
+        return create_error_response("User service not available", 503, "SERVICE_UNAVAILABLE");
+    }
+
+    return user_profile_response(user_service_->get_user_profile_json(user_id));
+}
+
+Response Router::user_profile_response(std::expected<std::string, std::string> result) {
+    if (!result) {
+        if (result.error() == "User not found") {
+            return create_error_response("User not found", 404, "NOT_FOUND");
+        }
+        if (result.error().ends_with(database::AsyncPool::kTimeoutError)) {
+            return create_error_response(result.error(), 504, "GATEWAY_TIMEOUT");
+        }
+        return create_error_response(result.error(), 500, "INTERNAL_ERROR");
     }
-    return create_error_response("User not found", 404, "NOT_FOUND");
+
+    return create_json_response(std::move(result.value()));
 }
 
-std::string Router::handle_openapi_spec() {
+Response Router::handle_get_recommendations(const std::string& user_id,
+                                            const http::QueryParams& query_params,
+                                            std::pmr::memory_resource* arena) {
+    if (!shop_service_ || !user_service_) {
+        return create_error_response("Service not available", 503, "SERVICE_UNAVAILABLE");
+    }
+
+    auto param = [&query_params](const char* name) { return parse_number_param(query_params, name); };
+    auto has = [&query_params](const char* name) { return query_params.contains(name); };
+
+    service::RecommendationQuery query;
+
+    if (has("limit")) {
+        auto limit = param("limit");
+        if (!limit || *limit < 1.0 || *limit > 100.0) {
+            return create_error_response("limit must be between 1 and 100", 400, "INVALID_REQUEST");
+        }
+        query.limit = static_cast<size_t>(*limit);
+    }
+
+    if (has("minRating")) {
+        auto min_rating = param("minRating");
+        if (!min_rating || *min_rating < 0.0 || *min_rating > 5.0) {
+            return create_error_response("minRating must be between 0 and 5", 400, "INVALID_REQUEST");
+        }
+        query.min_rating = *min_rating;
+    }
+
+    // lat / lng を指定した場合は半径内（デフォルト 5km）の店舗に限定
+    if (has("lat") || has("lng")) {
+        auto lat = param("lat");
+        auto lng = param("lng");
+        auto radius_km = has("radiusKm") ? param("radiusKm") : std::optional<double>(5.0);
+        if (!lat || !lng || std::abs(*lat) > 90.0 || std::abs(*lng) > 180.0 || !radius_km || *radius_km < 0.0 || *radius_km > kMaxRadiusKm) {
+            return create_error_response("Invalid lat, lng or radiusKm", 400, "INVALID_REQUEST");
+        }
+        query.near = service::RecommendationQuery::Near{*lat, *lng, *radius_km};
+    }
+
+    auto preferences = user_service_->get_user_preferences(user_id);
+    if (!preferences) {
+        if (preferences.error() == "User not found") {
+            return create_error_response("User not found", 404, "NOT_FOUND");
+        }
+        return create_error_response(preferences.error(), 500, "INTERNAL_ERROR");
+    }
+    query.preferences = preferences.value();
+
+    auto result = shop_service_->recommend_shops_json(query, arena);
+    if (!result) {
+        return create_error_response(result.error(), 500, "INTERNAL_ERROR");
+    }
+
+    return create_json_response(std::move(result.value()));
+}
+
+Response Router::handle_openapi_spec() {
     // OpenAPI仕様ファイルを返す (静的ファイルとして読み込むべき)
     return create_response(
         "openapi: 3.0.3\ninfo:\n  title: Spice Curry Nara API\n  version: 1.0.0",
@@ -156,7 +363,7 @@ std::string Router::handle_openapi_spec() {
     );
 }
 
-std::string Router::handle_not_found() {
+Response Router::handle_not_found() {
     return create_error_response("Endpoint not found", 404, "NOT_FOUND");
 }
 
@@ -166,116 +373,240 @@ const char* Router::status_code_to_string(int code) {
         case 201: return "Created";
         case 400: return "Bad Request";
         case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Content Too Large";
+        case 431: return "Request Header Fields Too Large";
         case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        case 505: return "HTTP Version Not Supported";
         default: return "Unknown";
     }
 }
 
-std::string Router::create_response(const std::string& body, int status_code, const std::string& content_type) {
-    return std::format(
-        "HTTP/1.1 {} {}\r\n"
-        "Content-Type: {}\r\n"
-        "Content-Length: {}\r\n"
-        "Connection: close\r\n"
-        "\r\n"
-        "{}",
-        status_code,
-        status_code_to_string(status_code),
-        content_type,
-        body.length(),
-        body
-    );
+Response Router::create_response(std::string body, int status_code, std::string_view content_type) {
+    return Response{
+        .status_code = status_code,
+        .content_type = content_type,
+        .body = std::move(body)
+    };
 }
 
-std::string Router::create_json_response(const std::string& json, int status_code) {
-    return create_response(json, status_code, "application/json");
+Response Router::create_json_response(std::string json, int status_code) {
+    return create_response(std::move(json), status_code, "application/json");
 }
 
-std::string Router::create_error_response(const std::string& message, int status_code, const std::string& error_code) {
+Response Router::create_shared_json_response(std::shared_ptr<const std::string> json, int status_code) {
+    return Response{
+        .status_code = status_code,
+        .content_type = "application/json",
+        .body = {},
+        .shared_body = std::move(json)
+    };
+}
+
+Response Router::create_page_response(service::JsonPage page) {
+    auto response = create_shared_json_response(std::move(page.json));
+    if (page.next_cursor) {
+        // ボディは配列のまま、次ページの位置はヘッダーで返す
+        response.headers = std::format("X-Next-Cursor: {}\r\n", *page.next_cursor);
+    }
+    return response;
+}
+
+Response Router::create_error_response(const std::string& message, int status_code, const std::string& error_code) {
+    // メッセージにはデータベースのエラー文なども入るためエスケープする
     std::string json;
-    if (error_code.empty()) {
-        json = std::format(R"({{"error":"{}"}})", message);
-    } else {
-        json = std::format(R"({{"error":"{}","code":"{}"}})", message, error_code);
+    serialization::JsonWriter writer(json);
+    writer.begin_object().key("error").value(message);
+    if (!error_code.empty()) {
+        writer.key("code").value(error_code);
     }
-    return create_response(json, status_code, "application/json");
+    writer.end_object();
+    return create_response(std::move(json), status_code, "application/json");
 }
 
-std::string Router::extract_path(std::string_view request) {
-    // "GET /path HTTP/1.1" の形式から /path を抽出
-    size_t start = request.find(' ');
-    if (start == std::string_view::npos) return "/";
+bool Router::write_response(Response&& response, bool keep_alive, http::OutputBuffer& output) {
+    size_t content_length = response.shared_body ? response.shared_body->size() : response.body.size();
 
-    start++; // スペースの次の文字
-    size_t end = request.find(' ', start);
-    if (end == std::string_view::npos) return "/";
+    std::string head;
+    std::format_to(
+        std::back_inserter(head),
+        "HTTP/1.1 {} {}\r\n"
+        "Content-Type: {}\r\n"
+        "Content-Length: {}\r\n"
+        "Connection: {}\r\n"
+        "{}"
+        "\r\n",
+        response.status_code,
+        status_code_to_string(response.status_code),
+        response.content_type,
+        content_length,
+        keep_alive ? "keep-alive" : "close",
+        response.headers
+    );
+    output.append(std::move(head));
 
-    return std::string(request.substr(start, end - start));
+    if (response.shared_body) {
+        output.append(std::move(response.shared_body));
+    } else {
+        output.append(std::move(response.body));
+    }
+    return true;
 }
 
-std::string Router::extract_method(std::string_view request) {
-    // "GET /path HTTP/1.1" の形式から GET を抽出
-    size_t end = request.find(' ');
-    if (end == std::string_view::npos) return "GET";
+bool Router::write_streamed_response(Response&& response, const http::Request& request,
+                                     http::OutputBuffer& output, const http::FlushHandler& flush) {
+    // HTTP/1.0 はチャンク転送を解釈できないため、接続を閉じてボディの終わりを示す
+    bool chunked = request.version_minor >= 1;
+    bool keep_alive = chunked && request.keep_alive;
+
+    std::string head;
+    std::format_to(
+        std::back_inserter(head),
+        "HTTP/1.1 {} {}\r\n"
+        "Content-Type: {}\r\n"
+        "{}"
+        "Connection: {}\r\n"
+        "{}"
+        "\r\n",
+        response.status_code,
+        status_code_to_string(response.status_code),
+        response.content_type,
+        chunked ? "Transfer-Encoding: chunked\r\n" : "",
+        keep_alive ? "keep-alive" : "close",
+        response.headers
+    );
+    output.append(std::move(head));
 
-    return std::string(request.substr(0, end));
+    http::ChunkedWriter writer(output, flush, chunked);
+    if (!response.stream_body(writer) || !writer.finish()) {
+        return false;
+    }
+    return keep_alive;
 }
 
-std::string Router::extract_body(std::string_view request) {
-    // HTTPリクエストボディを抽出 (空行の後)
-    size_t body_start = request.find("\r\n\r\n");
-    if (body_start == std::string_view::npos) {
-        body_start = request.find("\n\n");
-        if (body_start == std::string_view::npos) {
-            return "";
+std::expected<domain::ShopQuery, std::string> Router::parse_shop_query(
+    const http::QueryParams& query_params) {
+
+    domain::ShopQuery query;
+
+    // 指定されていれば [min, max] の数値として読む
+    auto number = [&query_params](const char* name, double min, double max)
+        -> std::expected<std::optional<double>, std::string> {
+        if (!query_params.contains(name)) {
+            return std::nullopt;
+        }
+        auto value = parse_number_param(query_params, name);
+        if (!value || *value < min || *value > max) {
+            return std::unexpected(std::format("{} must be between {} and {}", name, min, max));
         }
-        return std::string(request.substr(body_start + 2));
+        return value;
+    };
+
+    if (auto region = query_params.find("region")) {
+        query.region = std::string(*region);
     }
-    return std::string(request.substr(body_start + 4));
-}
 
-std::unordered_map<std::string, std::string> Router::extract_query_params(std::string_view path) {
-    std::unordered_map<std::string, std::string> params;
+    auto min_rating = number("minRating", 0.0, 5.0);
+    auto max_rating = number("maxRating", 0.0, 5.0);
+    if (!min_rating) return std::unexpected(min_rating.error());
+    if (!max_rating) return std::unexpected(max_rating.error());
+    query.rating = {*min_rating, *max_rating};
+
+    // 0-100 のスパイスパラメータの範囲
+    auto spice_range = [&number](const char* min_name, const char* max_name)
+        -> std::expected<domain::Range<int>, std::string> {
+        auto min = number(min_name, 0.0, 100.0);
+        auto max = number(max_name, 0.0, 100.0);
+        if (!min) return std::unexpected(min.error());
+        if (!max) return std::unexpected(max.error());
+
+        domain::Range<int> range;
+        if (*min) range.min = static_cast<int>(std::ceil(**min));
+        if (*max) range.max = static_cast<int>(std::floor(**max));
+        return range;
+    };
+
+    auto spiciness = spice_range("minSpiciness", "maxSpiciness");
+    auto stimulation = spice_range("minStimulation", "maxStimulation");
+    auto aroma = spice_range("minAroma", "maxAroma");
+    if (!spiciness) return std::unexpected(spiciness.error());
+    if (!stimulation) return std::unexpected(stimulation.error());
+    if (!aroma) return std::unexpected(aroma.error());
+    query.spiciness = *spiciness;
+    query.stimulation = *stimulation;
+    query.aroma = *aroma;
+
+    // bbox=minLat,minLng,maxLat,maxLng
+    if (auto bbox = query_params.find("bbox")) {
+        std::string_view text = *bbox;
+        std::array<double, 4> values{};
+        size_t count = 0;
+        for (auto part : std::views::split(text, ',')) {
+            std::string_view field(part.begin(), part.end());
+            if (count == values.size()) {
+                count++;
+                break;
+            }
+            auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), values[count]);
+            if (ec != std::errc() || end != field.data() + field.size() || !validation::is_finite(values[count])) {
+                break;
+            }
+            count++;
+        }
+        if (count != values.size() || values[0] > values[2] || values[1] > values[3]) {
+            return std::unexpected("bbox must be minLat,minLng,maxLat,maxLng");
+        }
+        query.bounds = domain::BoundingBox{values[0], values[1], values[2], values[3]};
+    }
 
-    auto query_pos = path.find('?');
-    if (query_pos == std::string_view::npos) {
-        return params;
+    if (auto sort = query_params.find("sort")) {
+        if (*sort == "id") {
+            query.sort = domain::ShopSort::Id;
+        } else if (*sort == "rating") {
+            query.sort = domain::ShopSort::RatingDesc;
+        } else if (*sort == "spiciness") {
+            query.sort = domain::ShopSort::SpicinessDesc;
+        } else if (*sort == "name") {
+            query.sort = domain::ShopSort::Name;
+        } else {
+            return std::unexpected("sort must be one of id, rating, spiciness, name");
+        }
     }
 
-    std::string query_string(path.substr(query_pos + 1));
-    std::stringstream ss;
-    ss.str(query_string);
-    std::string pair;
+    auto limit = number("limit", 1.0, static_cast<double>(kMaxPageSize));
+    if (!limit) return std::unexpected(limit.error());
+    if (*limit) query.limit = static_cast<size_t>(**limit);
 
-    while (std::getline(ss, pair, '&')) {
-        auto eq_pos = pair.find('=');
-        if (eq_pos != std::string::npos) {
-            std::string key = pair.substr(0, eq_pos);
-            std::string value = pair.substr(eq_pos + 1);
-            params[key] = value;
+    // after=<前ページの X-Next-Cursor>（並び順はカーソル作成時と同じであること）
+    if (auto after = query_params.find("after")) {
+        auto cursor = service::decode_shop_cursor(*after);
+        if (!cursor || cursor->sort != query.sort) {
+            return std::unexpected("Invalid cursor");
+        }
+        query.after = std::move(cursor.value());
+        if (!query.limit) {
+            query.limit = kDefaultPageSize;
         }
     }
 
-    return params;
+    return query;
 }
 
-std::optional<std::string> Router::extract_path_param(std::string_view path, std::string_view prefix) {
-    if (!path.starts_with(prefix)) {
+std::optional<double> Router::parse_number_param(const http::QueryParams& query_params, std::string_view name) {
+    auto text = query_params.find(name);
+    if (!text) {
         return std::nullopt;
     }
-
-    std::string_view param = path.substr(prefix.length());
-    // クエリパラメータを除去
-    auto query_pos = param.find('?');
-    if (query_pos != std::string_view::npos) {
-        param = param.substr(0, query_pos);
-    }
-
-    if (param.empty()) {
+    double value = 0.0;
+    auto [end, ec] = std::from_chars(text->data(), text->data() + text->size(), value);
+    if (ec != std::errc() || end != text->data() + text->size() || !validation::is_finite(value)) {
         return std::nullopt;
     }
-
-    return std::string(param);
+    return value;
 }
 
 } // namespace router
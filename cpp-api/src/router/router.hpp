@@ -1,14 +1,53 @@
 #pragma once
 #include "../service/shop_service.hpp"
 #include "../service/user_service.hpp"
+#include "../http/request_parser.hpp"
+#include "../http/output_buffer.hpp"
+#include "../http/chunked_writer.hpp"
+#include "../http/query_params.hpp"
+#include "../http/request_arena.hpp"
+#include "../domain/shop_query.hpp"
+#include "../serialization/json_writer.hpp"
+#include "routes.hpp"
+#include <stdexec/execution.hpp>
+#include <expected>
 #include <string>
+#include <functional>
 #include <memory>
+#include <memory_resource>
 #include <string_view>
 #include <optional>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace router {
 
+// ハンドラーが返すレスポンス（シリアライズは Router::route で行う）
+struct Response {
+    int status_code = 200;
+    std::string_view content_type = "application/json";  // 文字列リテラルを指すこと
+    std::string body;
+
+    // 事前レンダリング済みの共有ボディ（設定時は body の代わりにコピーせず送信する）
+    std::shared_ptr<const std::string> shared_body{};
+
+    // 追加のヘッダー行（"Name: value\r\n" の連結）
+    std::string headers{};
+
+    // ボディを逐次生成する関数（設定時はチャンク転送で送信し、body は使わない）
+    // 途中で失敗した場合は false を返す（ヘッダー送信後のためボディを終端せずに接続を閉じる）
+    std::function<bool(http::ChunkedWriter&)> stream_body{};
+};
+
+// DB の応答を待つ間ワーカーを占有せずに処理するリクエスト
+// 受信バッファを参照しないため、セッションがバッファを詰めた後も使える
+struct DeferredRequest {
+    RouteId route = RouteId::None;
+    std::string param;        // パスパラメータ
+    std::string body;         // リクエストボディ
+    bool keep_alive = true;
+};
+
 // HTTPリクエストのルーティングとレスポンス生成を担当
 // OpenAPI 3.0 準拠のRESTful APIルーター
 class Router {
@@ -18,37 +57,113 @@ public:
            std::string shops_json,
            std::string users_json);
 
-    // HTTPリクエストをルーティングしてレスポンスを生成
-    std::string route(std::string_view request);
+    // HTTPリクエストをルーティングしてレスポンスを output へ追加
+    // Connection ヘッダーには request.keep_alive を反映する
+    // ストリーミングするレスポンスは output が一定量を超えるたびに flush で送信する
+    // 接続を継続できない場合（ストリーミングの失敗・HTTP/1.0 でのストリーミング）は false
+    bool route(const http::Request& request, http::OutputBuffer& output, const http::FlushHandler& flush = {});
+
+    // パースできなかったリクエストへのエラーレスポンス（接続は閉じる）
+    void reject(int status_code, std::string_view message, http::OutputBuffer& output);
+
+    // GET /metrics に name をキーとして出力する統計（値を1つ書く関数、サーバー開始前に登録すること）
+    using MetricsWriter = std::function<void(serialization::JsonWriter&)>;
+    void add_metrics_section(std::string name, MetricsWriter writer);
+
+    // GET /api/users/{id} を AsyncPool で処理する（サーバー開始前に呼び出すこと）
+    void enable_async_queries(database::AsyncPool& pool) { async_pool_ = &pool; }
+
+    // defer() の対象になるルートがあるか（なければ handle_session に deferred を渡さなくてよい）
+    bool has_deferred_routes() const {
+        return user_service_ && (async_pool_ || user_service_->write_combining_enabled());
+    }
+
+    // 非同期に処理するリクエストなら DeferredRequest（未設定・対象外のルートは nullopt）
+    // GET /api/users/{id} は enable_async_queries 後、POST /api/users は登録のグループコミットが有効なとき
+    std::optional<DeferredRequest> defer(const http::Request& request) const;
+
+    // DeferredRequest のレスポンス（Response）で完了する sender を launch へ渡す
+    // （ルートごとに sender の型が異なるため）
+    // 完了は AsyncPool の I/O スレッドか登録の書き込みスレッド上で通知される
+    template <class Launch>
+    void respond_async(DeferredRequest request, Launch&& launch) {
+        if (request.route == RouteId::PostUser) {
+            launch(user_service_->async_create_user_from_json(request.body)
+                   | stdexec::then([this](std::expected<std::string, std::string> result) {
+                         return post_user_response(std::move(result));
+                     }));
+            return;
+        }
+        launch(service::UserService::async_get_user_profile_json(*async_pool_, std::move(request.param))
+               | stdexec::then([this](std::expected<std::string, std::string> result) {
+                     return user_profile_response(std::move(result));
+                 }));
+    }
+
+    // respond_async のレスポンスを output へ追加（接続を継続できる場合は true）
+    bool write_deferred_response(Response&& response, bool keep_alive, http::OutputBuffer& output) {
+        return write_response(std::move(response), keep_alive, output);
+    }
 
 private:
+    // ページングの既定件数と上限
+    static constexpr size_t kDefaultPageSize = 100;
+    static constexpr size_t kMaxPageSize = 1000;
+
+    // 検索半径の上限（地球の周長の半分。これより大きい半径はセル番号が int32 を超える）
+    static constexpr double kMaxRadiusKm = 20'000.0;
+
     std::shared_ptr<service::ShopService> shop_service_;
     std::shared_ptr<service::UserService> user_service_;
     std::string shops_json_;
     std::string users_json_;
+    std::vector<std::pair<std::string, MetricsWriter>> metrics_sections_;
+    database::AsyncPool* async_pool_ = nullptr;
+
+    // ルーティング表（routes.hpp）で照合し、各ハンドラーへ振り分け
+    // パスパラメータ・クエリはリクエストとアリーナを参照するため、ハンドラーの外へ持ち出さない
+    Response dispatch(const http::Request& request, http::RequestArena& arena);
 
     // エンドポイントハンドラー (OpenAPI準拠)
-    std::string handle_health();
-    std::string handle_metrics();
-    std::string handle_get_shops(const std::unordered_map<std::string, std::string>& query_params);
-    std::string handle_get_shop_by_id(const std::string& shop_id);
-    std::string handle_get_users();
-    std::string handle_post_user(std::string_view body);
-    std::string handle_get_user_by_id(const std::string& user_id);
-    std::string handle_openapi_spec();
-    std::string handle_not_found();
+    Response handle_health();
+    Response handle_metrics();
+    Response handle_get_shops(const http::QueryParams& query_params, std::pmr::memory_resource* arena);
+    Response handle_get_nearby_shops(const http::QueryParams& query_params, std::pmr::memory_resource* arena);
+    Response handle_get_shop_by_id(std::string_view shop_id);
+    Response handle_export_shops();
+    Response handle_get_users(const http::QueryParams& query_params);
+    Response handle_post_user(std::string_view body);
+    Response handle_get_user_by_id(const std::string& user_id);
+    Response user_profile_response(std::expected<std::string, std::string> result);
+    Response post_user_response(std::expected<std::string, std::string> result);
+    Response handle_get_recommendations(const std::string& user_id,
+                                        const http::QueryParams& query_params,
+                                        std::pmr::memory_resource* arena);
+    Response handle_openapi_spec();
+    Response handle_not_found();
 
     // HTTPレスポンス生成
-    std::string create_response(const std::string& body, int status_code = 200, const std::string& content_type = "application/json");
-    std::string create_json_response(const std::string& json, int status_code = 200);
-    std::string create_error_response(const std::string& message, int status_code = 500, const std::string& error_code = "");
-
-    // リクエストパース
-    std::string extract_path(std::string_view request);
-    std::string extract_method(std::string_view request);
-    std::string extract_body(std::string_view request);
-    std::unordered_map<std::string, std::string> extract_query_params(std::string_view path);
-    std::optional<std::string> extract_path_param(std::string_view path, std::string_view prefix);
+    Response create_response(std::string body, int status_code = 200, std::string_view content_type = "application/json");
+    Response create_json_response(std::string json, int status_code = 200);
+    Response create_shared_json_response(std::shared_ptr<const std::string> json, int status_code = 200);
+    Response create_page_response(service::JsonPage page);
+    Response create_error_response(const std::string& message, int status_code = 500, const std::string& error_code = "");
+
+    // ステータスライン・ヘッダーとボディを別セグメントとして output へ追加
+    // （ボディはヘッダーを前置するためにコピーしない）
+    // 接続を継続できる場合は true
+    bool write_response(Response&& response, bool keep_alive, http::OutputBuffer& output);
+
+    // stream_body をチャンク転送（HTTP/1.0 では接続を閉じて終端）で書き出す
+    bool write_streamed_response(Response&& response, const http::Request& request,
+                                 http::OutputBuffer& output, const http::FlushHandler& flush);
+
+    // GET /api/shops のクエリパラメータを検索条件へ変換
+    static std::expected<domain::ShopQuery, std::string> parse_shop_query(
+        const http::QueryParams& query_params);
+
+    // 数値のクエリパラメータ（未指定・不正な値は nullopt）
+    static std::optional<double> parse_number_param(const http::QueryParams& query_params, std::string_view name);
 
     // ステータスコード変換
     const char* status_code_to_string(int code);
@@ -0,0 +1,48 @@
+#pragma once
+#include "router/route_table.hpp"
+#include <array>
+#include <cstdint>
+
+namespace router {
+
+// エンドポイント（Router::dispatch でハンドラーへ振り分ける）
+enum class RouteId : std::uint8_t {
+    None,
+    Health,
+    Metrics,
+    OpenApiSpec,
+    GetShops,
+    GetNearbyShops,
+    ExportShops,
+    GetShopById,
+    GetUsers,
+    PostUser,
+    GetUserById,
+    GetRecommendations
+};
+
+// OpenAPI準拠のRESTful ルーティング表
+// エンドポイントを追加するときはここに1行足し、dispatch の switch にハンドラーを追加する
+inline constexpr std::array kRouteDefs = std::to_array<RouteDef<RouteId>>({
+    // Health & Monitoring endpoints
+    {Method::Get, "/health", RouteId::Health},
+    {Method::Get, "/api/health", RouteId::Health},
+    {Method::Get, "/metrics", RouteId::Metrics},
+    {Method::Get, "/api/metrics", RouteId::Metrics},
+    // OpenAPI specification endpoint
+    {Method::Get, "/api/openapi.yaml", RouteId::OpenApiSpec},
+    // Shops endpoints
+    {Method::Get, "/api/shops", RouteId::GetShops},
+    {Method::Get, "/api/shops/nearby", RouteId::GetNearbyShops},
+    {Method::Get, "/api/shops/export", RouteId::ExportShops},
+    {Method::Get, "/api/shops/{shopId}", RouteId::GetShopById},
+    // Users endpoints
+    {Method::Get, "/api/users", RouteId::GetUsers},
+    {Method::Post, "/api/users", RouteId::PostUser},
+    {Method::Get, "/api/users/{userId:int}", RouteId::GetUserById},
+    {Method::Get, "/api/users/{userId:int}/recommendations", RouteId::GetRecommendations},
+});
+
+inline constexpr RouteTable<RouteId, 24> kRouteTable{kRouteDefs};
+
+} // namespace router
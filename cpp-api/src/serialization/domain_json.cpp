@@ -0,0 +1,72 @@
+#include "serialization/domain_json.hpp"
+
+namespace serialization {
+
+namespace {
+
+// 任意項目の文字列（未設定なら空文字列）
+std::string_view text_or_empty(const std::optional<std::string_view>& value) {
+    return value.value_or(std::string_view());
+}
+
+// User オブジェクトの項目（begin_object / end_object は呼び出し側）
+void write_user_fields(JsonWriter& writer, const domain::User& user) {
+    writer.key("id").value(user.id)
+        .key("username").value(user.username)
+        .key("email").value(user.email)
+        .key("spiciness").value(user.preferences.spiciness)
+        .key("stimulation").value(user.preferences.stimulation)
+        .key("aroma").value(user.preferences.aroma);
+}
+
+void write_string_array(JsonWriter& writer, const std::vector<std::string>& values) {
+    writer.begin_array();
+    for (const auto& value : values) {
+        writer.value(value);
+    }
+    writer.end_array();
+}
+
+} // namespace
+
+void write_shop(JsonWriter& writer, const domain::ShopView& shop) {
+    writer.begin_object()
+        .key("id").value(shop.id)
+        .key("name").value(shop.name)
+        .key("address").value(shop.address)
+        .key("phone").value(text_or_empty(shop.phone))
+        .key("latitude").value(shop.latitude)
+        .key("longitude").value(shop.longitude)
+        .key("region").value(shop.region)
+        .key("spiceParameters").begin_object()
+            .key("spiciness").value(shop.spice_params.spiciness)
+            .key("stimulation").value(shop.spice_params.stimulation)
+            .key("aroma").value(shop.spice_params.aroma)
+        .end_object()
+        .key("rating").value(shop.rating)
+        .key("description").value(text_or_empty(shop.description))
+        .key("image_url").value(text_or_empty(shop.image_url))
+    .end_object();
+}
+
+void write_shop(JsonWriter& writer, const domain::Shop& shop) {
+    write_shop(writer, domain::ShopView::of(shop));
+}
+
+void write_user(JsonWriter& writer, const domain::User& user) {
+    writer.begin_object();
+    write_user_fields(writer, user);
+    writer.end_object();
+}
+
+void write_user_profile(JsonWriter& writer, const domain::UserProfile& profile) {
+    writer.begin_object();
+    write_user_fields(writer, profile.user);
+    writer.key("favoriteShopIds");
+    write_string_array(writer, profile.favorite_shop_ids);
+    writer.key("dislikedShopIds");
+    write_string_array(writer, profile.disliked_shop_ids);
+    writer.end_object();
+}
+
+} // namespace serialization
@@ -0,0 +1,19 @@
+#pragma once
+#include "serialization/json_writer.hpp"
+#include "domain/shop.hpp"
+#include "domain/shop_view.hpp"
+#include "domain/user.hpp"
+
+namespace serialization {
+
+// API レスポンスの Shop オブジェクト（未設定の任意項目は空文字列）
+void write_shop(JsonWriter& writer, const domain::ShopView& shop);
+void write_shop(JsonWriter& writer, const domain::Shop& shop);
+
+// API レスポンスの User オブジェクト
+void write_user(JsonWriter& writer, const domain::User& user);
+
+// User にお気に入り・苦手な店舗の ID を加えたもの
+void write_user_profile(JsonWriter& writer, const domain::UserProfile& profile);
+
+} // namespace serialization
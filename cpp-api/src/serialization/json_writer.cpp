@@ -0,0 +1,259 @@
+#include "serialization/json_writer.hpp"
+#include "validation/finite.hpp"
+#include <array>
+#include <charconv>
+#include <cmath>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace serialization {
+
+namespace {
+
+// バイトごとのエスケープ表記（0 はエスケープ不要、'u' は \u00XX）
+constexpr std::array<char, 256> kEscapeTable = [] {
+    std::array<char, 256> table{};
+    for (int c = 0; c < 0x20; ++c) {
+        table[c] = 'u';
+    }
+    table['"'] = '"';
+    table['\\'] = '\\';
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    return table;
+}();
+
+bool needs_escape(char c) {
+    return kEscapeTable[static_cast<unsigned char>(c)] != 0;
+}
+
+// [begin, end) で最初にエスケープが必要な位置（なければ end）
+using FindKernel = const char* (*)(const char* begin, const char* end);
+
+const char* scalar_find(const char* p, const char* end) {
+    while (p < end && !needs_escape(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+#if defined(__x86_64__)
+// SSE2 は x86-64 の必須命令なので常に使える
+const char* sse2_find(const char* p, const char* end) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+
+    for (; p + 16 <= end; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // 符号なしで v <= 0x1F  ⇔  max(v, 0x1F) == 0x1F
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(v, control_max), control_max));
+        if (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit))) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return scalar_find(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* avx2_find(const char* p, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+
+    for (; p + 32 <= end; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(v, control_max), control_max));
+        if (unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit))) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return sse2_find(p, end);
+}
+#endif
+
+struct EscapeKernel {
+    FindKernel find;
+    const char* name;
+};
+
+// CPU の対応命令を一度だけ調べてカーネルを選択
+const EscapeKernel& select_kernel() {
+    static const EscapeKernel kernel = [] {
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return EscapeKernel{avx2_find, "avx2"};
+        }
+        return EscapeKernel{sse2_find, "sse2"};
+#else
+        return EscapeKernel{scalar_find, "scalar"};
+#endif
+    }();
+    return kernel;
+}
+
+// 1文字分のエスケープを追記
+void append_escape(std::string& out, char c) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    char code = kEscapeTable[static_cast<unsigned char>(c)];
+    if (code == 'u') {
+        const char unicode[] = {'\\', 'u', '0', '0',
+                                kHex[(static_cast<unsigned char>(c) >> 4) & 0xF],
+                                kHex[static_cast<unsigned char>(c) & 0xF]};
+        out.append(unicode, sizeof(unicode));
+    } else {
+        const char escaped[] = {'\\', code};
+        out.append(escaped, sizeof(escaped));
+    }
+}
+
+} // namespace
+
+void append_escaped(std::string& out, std::string_view s) {
+    const auto find = select_kernel().find;
+    const char* p = s.data();
+    const char* end = p + s.size();
+
+    while (p < end) {
+        const char* hit = find(p, end);
+        out.append(p, static_cast<size_t>(hit - p));
+        if (hit == end) {
+            break;
+        }
+        append_escape(out, *hit);
+        p = hit + 1;
+    }
+}
+
+const char* escape_kernel_name() {
+    return select_kernel().name;
+}
+
+void JsonWriter::separate() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (depth_ > 0) {
+        const std::uint64_t bit = std::uint64_t{1} << (depth_ - 1);
+        if (has_items_ & bit) {
+            out_ += ',';
+        }
+        has_items_ |= bit;
+    }
+}
+
+void JsonWriter::push(char open) {
+    separate();
+    out_ += open;
+    ++depth_;
+    has_items_ &= ~(std::uint64_t{1} << (depth_ - 1));
+}
+
+void JsonWriter::pop(char close) {
+    out_ += close;
+    --depth_;
+}
+
+JsonWriter& JsonWriter::begin_object() {
+    push('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::end_object() {
+    pop('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::begin_array() {
+    push('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::end_array() {
+    pop(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    out_ += '"';
+    append_escaped(out_, name);
+    out_ += "\":";
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view s) {
+    separate();
+    out_.reserve(out_.size() + s.size() + 2);
+    out_ += '"';
+    append_escaped(out_, s);
+    out_ += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::int64_t n) {
+    separate();
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), n);
+    out_.append(buf, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double d) {
+    if (!validation::is_finite(d)) {
+        return null();
+    }
+    separate();
+    // 最短で往復可能な表記（std::format の "{}" と同じ）
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), d);
+    out_.append(buf, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b) {
+    separate();
+    out_ += b ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out_ += "null";
+    return *this;
+}
+
+JsonWriter& JsonWriter::fixed(double d, int precision) {
+    if (!validation::is_finite(d)) {
+        return null();
+    }
+    separate();
+    char buf[64];
+    auto result = std::to_chars(buf, buf + sizeof(buf), d, std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) {
+        // 桁数が多すぎる場合は最短表記にする
+        result = std::to_chars(buf, buf + sizeof(buf), d);
+    }
+    out_.append(buf, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json) {
+    separate();
+    out_ += json;
+    return *this;
+}
+
+} // namespace serialization
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace serialization {
+
+// JSON 文字列の中身として s をエスケープして out へ追記する（引用符は含まない）
+// '"' '\\' と制御文字（U+0000〜U+001F）だけをエスケープし、それ以外（UTF-8 を含む）はそのまま書く。
+// エスケープ不要な区間は SIMD（AVX2 なら 32 バイト、SSE2 なら 16 バイトずつ）で読み飛ばす
+void append_escaped(std::string& out, std::string_view s);
+
+// エスケープに使われる SIMD 実装の名前（"avx2" / "sse2" / "scalar"）
+const char* escape_kernel_name();
+
+// 呼び出し側のバッファへ追記していく JSON ライター
+// 区切りのカンマはネストごとに自動で挿入する（ネストは 64 段まで）。
+// 文字列はエスケープし、数値は std::to_chars で書式化する（非有限の double は null）
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    std::string& buffer() { return out_; }
+
+    JsonWriter& begin_object();
+    JsonWriter& end_object();
+    JsonWriter& begin_array();
+    JsonWriter& end_array();
+
+    // オブジェクトのキー（続けて値を1つ書く）
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view s);
+    JsonWriter& value(const char* s) { return value(std::string_view(s)); }
+    JsonWriter& value(const std::string& s) { return value(std::string_view(s)); }
+    JsonWriter& value(std::int64_t n);
+    JsonWriter& value(int n) { return value(static_cast<std::int64_t>(n)); }
+    JsonWriter& value(double d);
+    JsonWriter& value(bool b);
+    JsonWriter& null();
+
+    // 小数点以下 precision 桁の固定小数点数
+    JsonWriter& fixed(double d, int precision);
+
+    // レンダリング済みの JSON をそのまま値として書く
+    JsonWriter& raw(std::string_view json);
+
+private:
+    std::string& out_;
+    std::uint64_t has_items_ = 0;  // ネストごとの「要素を書いたか」のビット
+    int depth_ = 0;
+    bool after_key_ = false;
+
+    // 値の前の区切り（配列の2番目以降ならカンマ）
+    void separate();
+    void push(char open);
+    void pop(char close);
+};
+
+} // namespace serialization
@@ -0,0 +1,229 @@
+#include "server/connection_handler.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <print>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace server {
+
+namespace {
+
+// 1回の recv で読み込むサイズ
+constexpr size_t kReadChunkSize = 16 * 1024;
+
+// 1回の処理で読み込む上限（残りは次の起床で読む）
+constexpr size_t kMaxReadPerWakeup = 2 * 1024 * 1024;
+
+// ストリーミング中に送信待ちとして保持する上限（超えたら送信可能になるまで待つ）
+constexpr size_t kMaxStreamBacklog = 1024 * 1024;
+
+// 1回の sendmsg で渡す iovec の上限
+constexpr size_t kMaxIovecs = 64;
+
+// EAGAIN まで読み込む。ピアが送信側を閉じていれば false
+bool read_available(Session& session) {
+    size_t total = 0;
+
+    while (total < kMaxReadPerWakeup) {
+        ssize_t n = 0;
+        size_t old_size = session.buffer.size();
+
+        // ゼロ埋めせずに末尾へ直接受信する
+        session.buffer.resize_and_overwrite(old_size + kReadChunkSize, [&](char* data, size_t) {
+            n = recv(session.fd, data + old_size, kReadChunkSize, 0);
+            return old_size + static_cast<size_t>(std::max<ssize_t>(n, 0));
+        });
+
+        if (n > 0) {
+            total += static_cast<size_t>(n);
+            continue;
+        }
+        if (n == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    return true;
+}
+
+} // namespace
+
+SessionState handle_session(Session& session, router::Router& router,
+                            std::optional<router::DeferredRequest>* deferred) {
+    try {
+        // 前回送り切れなかったレスポンスを先に送る（送り終えるまで次のリクエストは読まない）
+        if (!session.output.empty()) {
+            auto sent = send_pending(session.fd, session.output);
+            if (sent == SendStatus::Failed) {
+                return SessionState::Close;
+            }
+            if (sent == SendStatus::WouldBlock) {
+                return SessionState::WaitWritable;
+            }
+            session.clear_write_deadline();
+            if (session.close_after_send) {
+                return SessionState::Close;
+            }
+        }
+
+        bool peer_open = read_available(session);
+
+        auto state = process_requests(session, router, session.output, [&session](http::OutputBuffer& pending) {
+            return flush_stream(session, pending);
+        }, deferred);
+
+        if (state == SessionState::Suspended) {
+            // 先に処理したレスポンスは応答を待つ間に送っておく（残りは応答と一緒に送る）
+            switch (send_pending(session.fd, session.output)) {
+            case SendStatus::Failed:
+                deferred->reset();
+                return SessionState::Close;
+            case SendStatus::WouldBlock:
+                session.start_write_deadline(kWriteTimeout);
+                break;
+            case SendStatus::Complete:
+                session.clear_write_deadline();
+                break;
+            }
+            session.close_after_send = !peer_open || !(*deferred)->keep_alive;
+            return SessionState::Suspended;
+        }
+
+        switch (send_pending(session.fd, session.output)) {
+        case SendStatus::Failed:
+            return SessionState::Close;
+        case SendStatus::WouldBlock:
+            // 残りはリアクターが送信可能を通知してから送る
+            session.start_write_deadline(kWriteTimeout);
+            session.close_after_send = state == SessionState::Close || !peer_open;
+            return SessionState::WaitWritable;
+        case SendStatus::Complete:
+            session.clear_write_deadline();
+            break;
+        }
+
+        if (!peer_open) {
+            return SessionState::Close;
+        }
+
+        return state;
+
+    } catch (const std::exception& e) {
+        std::println("⚠️  Request handling failed: {}", e.what());
+        return SessionState::Close;
+    }
+}
+
+SessionState process_requests(Session& session, router::Router& router, http::OutputBuffer& output,
+                              const http::FlushHandler& flush,
+                              std::optional<router::DeferredRequest>* deferred) {
+    size_t offset = 0;
+    bool keep_alive = true;
+
+    // パイプライン化されたリクエストを到着順に処理
+    while (keep_alive && offset < session.buffer.size()) {
+        auto status = session.parser.parse(session.buffer, offset);
+
+        if (status == http::ParseStatus::Incomplete) {
+            break;
+        }
+
+        if (status == http::ParseStatus::Error) {
+            router.reject(session.parser.error_status(), session.parser.error_message(), output);
+            keep_alive = false;
+            offset = session.buffer.size();
+            break;
+        }
+
+        const auto& request = session.parser.request();
+
+        // DB の応答を待つリクエストはここで止め、後続のリクエストは応答を追記してから処理する
+        if (deferred) {
+            if (auto pending = router.defer(request)) {
+                *deferred = std::move(pending);
+                offset += session.parser.consumed();
+                session.parser.reset();
+                break;
+            }
+        }
+
+        keep_alive = router.route(request, output, flush) && request.keep_alive;
+
+        offset += session.parser.consumed();
+        session.parser.reset();
+    }
+
+    // 処理済みのリクエストを削除（未完結のリクエストは先頭へ詰める）
+    session.buffer.erase(0, offset);
+
+    if (deferred && deferred->has_value()) {
+        return SessionState::Suspended;
+    }
+    return keep_alive ? SessionState::KeepAlive : SessionState::Close;
+}
+
+SendStatus send_pending(int fd, http::OutputBuffer& output) {
+    std::array<iovec, kMaxIovecs> iov{};
+
+    while (!output.empty()) {
+        msghdr message{};
+        message.msg_iov = iov.data();
+        message.msg_iovlen = output.fill_iovecs(iov.data(), iov.size());
+
+        ssize_t n = sendmsg(fd, &message, MSG_NOSIGNAL);
+        if (n > 0) {
+            output.consume(static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return SendStatus::WouldBlock;
+        }
+        return SendStatus::Failed;
+    }
+    return SendStatus::Complete;
+}
+
+bool flush_stream(Session& session, http::OutputBuffer& output) {
+    while (true) {
+        auto sent = send_pending(session.fd, output);
+        if (sent == SendStatus::Failed) {
+            return false;
+        }
+        if (sent == SendStatus::Complete) {
+            session.clear_write_deadline();
+            return true;
+        }
+
+        // 送りきれない分は保持して生成を続け、上限を超えたときだけ待つ
+        // 待ち時間はレスポンス全体の期限で打ち切る（部分送信で延長しない）
+        session.start_write_deadline(kWriteTimeout);
+        if (output.size() < kMaxStreamBacklog) {
+            return true;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            session.write_deadline_point() - std::chrono::steady_clock::now()
+        );
+        if (remaining.count() <= 0) {
+            return false;
+        }
+
+        pollfd pfd{session.fd, POLLOUT, 0};
+        int ready = poll(&pfd, 1, static_cast<int>(remaining.count()));
+        if (ready < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+} // namespace server
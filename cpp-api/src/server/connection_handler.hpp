@@ -0,0 +1,52 @@
+#pragma once
+#include "server/session.hpp"
+#include "router/router.hpp"
+#include "http/output_buffer.hpp"
+#include "http/chunked_writer.hpp"
+#include <chrono>
+#include <optional>
+
+namespace server {
+
+// セッション処理後の接続の扱い
+enum class SessionState {
+    KeepAlive,    // 次のリクエストを待つ
+    WaitWritable, // session.output の残りを送信可能になってから送る
+    Suspended,    // DeferredRequest の応答待ち（呼び出し側が応答を追記して handle_session を再度呼ぶ）
+    Close         // 接続を閉じる
+};
+
+// 送信待ちになってからレスポンスを送り終えるまでの期限
+// （部分送信では延長しない）
+inline constexpr auto kWriteTimeout = std::chrono::seconds(30);
+
+// 送り残しがあれば続きを送り、送り終えていれば受信可能なデータを読み切って
+// バッファ内の完結したリクエストを到着順に処理する（HTTP/1.1 パイプライン対応）
+// ソケットが送信できなくなっても待たずに WaitWritable を返す
+// deferred を渡すと Router::defer の対象のリクエストで処理を止め、それを deferred に入れて Suspended を返す
+// （それより前のレスポンスは送れるだけ送り、応答後の接続の扱いは session.close_after_send に記録する）
+SessionState handle_session(Session& session, router::Router& router,
+                            std::optional<router::DeferredRequest>* deferred = nullptr);
+
+// バッファ内の完結したリクエストを到着順に処理し、レスポンスを output へ追記する
+// 処理済みのデータはバッファから取り除かれる
+// （I/O はストリーミングするレスポンスが flush を呼び出す場合のみ）
+SessionState process_requests(Session& session, router::Router& router, http::OutputBuffer& output,
+                              const http::FlushHandler& flush = {},
+                              std::optional<router::DeferredRequest>* deferred = nullptr);
+
+// 送信結果
+enum class SendStatus {
+    Complete,   // output を送り終えた
+    WouldBlock, // ソケットの送信バッファが一杯（残りは output に残る）
+    Failed      // 接続エラー
+};
+
+// output を sendmsg でまとめて送信する（ブロックしない、送信済み分は output から取り除く）
+SendStatus send_pending(int fd, http::OutputBuffer& output);
+
+// ストリーミングするレスポンスの flush
+// 送れるだけ送り、送信待ちが一定量を超えたときだけ session の書き込み期限まで待つ
+bool flush_stream(Session& session, http::OutputBuffer& output);
+
+} // namespace server
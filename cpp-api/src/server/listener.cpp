@@ -0,0 +1,47 @@
+#include "server/listener.hpp"
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace server {
+
+std::expected<int, std::string> create_listen_socket(int port, bool reuse_port) {
+    // エッジトリガーの epoll で受付キューを drain するため non-blocking で作成
+    int listen_socket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_socket < 0) {
+        return std::unexpected(std::format("Failed to create socket: {}", std::strerror(errno)));
+    }
+
+    int opt = 1;
+    setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    if (reuse_port && setsockopt(listen_socket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        int err = errno;
+        close(listen_socket);
+        return std::unexpected(std::format("Failed to set SO_REUSEPORT: {}", std::strerror(err)));
+    }
+
+    sockaddr_in server_addr{};
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(port);
+
+    if (bind(listen_socket, (sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        int err = errno;
+        close(listen_socket);
+        return std::unexpected(std::format("Failed to bind to port {}: {}", port, std::strerror(err)));
+    }
+
+    if (listen(listen_socket, SOMAXCONN) < 0) {
+        int err = errno;
+        close(listen_socket);
+        return std::unexpected(std::format("Failed to listen on socket: {}", std::strerror(err)));
+    }
+
+    return listen_socket;
+}
+
+} // namespace server
@@ -0,0 +1,11 @@
+#pragma once
+#include <expected>
+#include <string>
+
+namespace server {
+
+// ノンブロッキングのリッスンソケットを作成して bind・listen する
+// reuse_port を指定すると SO_REUSEPORT で同じポートに複数ソケットを bind できる
+std::expected<int, std::string> create_listen_socket(int port, bool reuse_port = false);
+
+} // namespace server
@@ -0,0 +1,274 @@
+#include "server/reactor.hpp"
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <print>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace server {
+
+namespace {
+
+// 1回の epoll_wait で受け取る最大イベント数
+constexpr int kMaxEvents = 256;
+
+// アイドルセッションの掃除間隔
+constexpr auto kSweepInterval = std::chrono::seconds(1);
+
+} // namespace
+
+std::expected<std::unique_ptr<Reactor>, std::string> Reactor::create(
+    int listen_socket,
+    ReadyHandler on_ready,
+    std::chrono::seconds idle_timeout
+) {
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        return std::unexpected(std::format("epoll_create1 failed: {}", std::strerror(errno)));
+    }
+
+    // 停止通知用の eventfd（読み出さずに残すことで全スレッドを起床させる）
+    int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        int err = errno;
+        close(epoll_fd);
+        return std::unexpected(std::format("eventfd failed: {}", std::strerror(err)));
+    }
+
+    std::unique_ptr<Reactor> reactor(
+        new Reactor(listen_socket, epoll_fd, wake_fd, std::move(on_ready), idle_timeout)
+    );
+
+    // data.ptr でイベント元を識別する（リッスン/停止通知はメンバーのアドレスを目印にする）
+    epoll_event listen_event{};
+    listen_event.events = EPOLLIN | EPOLLET;
+    listen_event.data.ptr = &reactor->listen_socket_;
+
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.ptr = &reactor->wake_fd_;
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_socket, &listen_event) < 0 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event) < 0) {
+        return std::unexpected(std::format("epoll_ctl failed: {}", std::strerror(errno)));
+    }
+
+    return reactor;
+}
+
+Reactor::Reactor(int listen_socket, int epoll_fd, int wake_fd,
+                 ReadyHandler on_ready, std::chrono::seconds idle_timeout)
+    : listen_socket_(listen_socket)
+    , epoll_fd_(epoll_fd)
+    , wake_fd_(wake_fd)
+    , on_ready_(std::move(on_ready))
+    , idle_timeout_(idle_timeout)
+    , running_(true)
+    , dispatched_(0)
+    , last_sweep_(std::chrono::steady_clock::now().time_since_epoch().count()) {}
+
+Reactor::~Reactor() {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    for (auto& [fd, session] : sessions_) {
+        close(fd);
+    }
+    sessions_.clear();
+
+    close(wake_fd_);
+    close(epoll_fd_);
+}
+
+void Reactor::run(size_t num_threads) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads > 0 ? num_threads - 1 : 0);
+
+    for (size_t i = 1; i < num_threads; ++i) {
+        threads.emplace_back([this] { event_loop(); });
+    }
+
+    event_loop();
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // ワーカーで処理中のセッションが resume()/close_session() を呼び終えるまで待つ
+    while (auto pending = dispatched_.load()) {
+        dispatched_.wait(pending);
+    }
+}
+
+void Reactor::stop() noexcept {
+    running_.store(false, std::memory_order_relaxed);
+
+    // write(2) は async-signal-safe
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto written = write(wake_fd_, &one, sizeof(one));
+}
+
+void Reactor::resume(Session& session) {
+    session.touch();
+
+    // EPOLL_CTL_MOD は再登録時点の準備状態も評価するため、
+    // 処理中に届いた後続リクエストの通知は失われない
+    rearm(session, EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT);
+}
+
+void Reactor::wait_writable(Session& session) {
+    session.touch();
+
+    // 送り終えるまでは次のリクエストを読まない（受信データはカーネルに残す）
+    // ピアの半クローズ（EPOLLRDHUP）は送信可能とは無関係なので待たない
+    rearm(session, EPOLLOUT | EPOLLET | EPOLLONESHOT);
+}
+
+void Reactor::rearm(Session& session, std::uint32_t events) {
+    session.in_flight.store(false, std::memory_order_release);
+
+    epoll_event client_event{};
+    client_event.events = events;
+    client_event.data.ptr = &session;
+
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, session.fd, &client_event) < 0) {
+        std::println("⚠️  Failed to re-arm client socket: {}", std::strerror(errno));
+        close_session(session);
+        return;
+    }
+
+    finish_dispatch();
+}
+
+void Reactor::close_session(Session& session) {
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        int fd = session.fd;
+        close(fd);
+        sessions_.erase(fd);
+    }
+
+    finish_dispatch();
+}
+
+size_t Reactor::get_open_sessions() const {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    return sessions_.size();
+}
+
+void Reactor::finish_dispatch() {
+    if (dispatched_.fetch_sub(1) == 1) {
+        dispatched_.notify_all();
+    }
+}
+
+void Reactor::event_loop() {
+    std::array<epoll_event, kMaxEvents> events{};
+    const int wait_ms = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(kSweepInterval).count()
+    );
+
+    while (running_.load(std::memory_order_relaxed)) {
+        int n = epoll_wait(epoll_fd_, events.data(), kMaxEvents, wait_ms);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::println("⚠️  epoll_wait failed: {}", std::strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            void* source = events[i].data.ptr;
+
+            if (source == &wake_fd_) {
+                continue;
+            }
+
+            if (source == &listen_socket_) {
+                accept_all();
+                continue;
+            }
+
+            // EPOLLONESHOT なので、このセッションは resume() されるまで他スレッドに通知されない
+            auto* session = static_cast<Session*>(source);
+            session->in_flight.store(true, std::memory_order_relaxed);
+            dispatched_.fetch_add(1);
+            on_ready_(*this, *session);
+        }
+
+        sweep_idle_sessions();
+    }
+}
+
+void Reactor::accept_all() {
+    while (true) {
+        sockaddr_in client_addr{};
+        socklen_t client_len = sizeof(client_addr);
+
+        int client_socket = accept4(listen_socket_, (sockaddr*)&client_addr, &client_len,
+                                    SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // EMFILE 等: 受付キューに残った接続は次の起床で再試行される
+                std::println("⚠️  accept failed: {}", std::strerror(errno));
+            }
+            return;
+        }
+
+        auto session = std::make_unique<Session>(client_socket);
+        Session* session_ptr = session.get();
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            sessions_.emplace(client_socket, std::move(session));
+        }
+
+        epoll_event client_event{};
+        client_event.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+        client_event.data.ptr = session_ptr;
+
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_socket, &client_event) < 0) {
+            std::println("⚠️  Failed to register client socket: {}", std::strerror(errno));
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            close(client_socket);
+            sessions_.erase(client_socket);
+        }
+    }
+}
+
+void Reactor::sweep_idle_sessions() {
+    auto now = std::chrono::steady_clock::now();
+    auto last = std::chrono::steady_clock::duration(last_sweep_.load(std::memory_order_relaxed));
+    if (now.time_since_epoch() - last < kSweepInterval) {
+        return;
+    }
+
+    // 掃除は1スレッドだけが行う
+    std::unique_lock<std::mutex> sweep_lock(sweep_mutex_, std::try_to_lock);
+    if (!sweep_lock.owns_lock()) {
+        return;
+    }
+    last_sweep_.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+
+    // 処理中（Suspended を含む）のセッションは対象外。非同期クエリは AsyncPool の期限
+    // （DB_ASYNC_QUERY_TIMEOUT）で必ず完了し、応答を返してから掃除の対象に戻る
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    for (auto& [fd, session] : sessions_) {
+        if (!session->in_flight.load(std::memory_order_acquire) &&
+            (session->idle_for(now) >= idle_timeout_ || session->write_expired(now))) {
+            // HUP がハンドラーに届き、そこで close_session() される
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+}
+
+} // namespace server
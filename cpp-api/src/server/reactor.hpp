@@ -0,0 +1,93 @@
+#pragma once
+#include "server/session.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace server {
+
+// epoll（エッジトリガー）ベースのイベントリアクター
+// 起床ごとにリッスンソケットの受付キューを空になるまで accept し、
+// 読み込み可能になったセッションをハンドラーへ渡す
+class Reactor {
+public:
+    // 読み込み可能になったセッションを受け取るハンドラー
+    // 処理後は必ず resume()・wait_writable()・close_session() のいずれかを呼び出すこと
+    using ReadyHandler = std::function<void(Reactor&, Session&)>;
+
+    // リアクターの作成（listen_socket は listen 済みであること）
+    static std::expected<std::unique_ptr<Reactor>, std::string> create(
+        int listen_socket,
+        ReadyHandler on_ready,
+        std::chrono::seconds idle_timeout = std::chrono::seconds(75)
+    );
+
+    ~Reactor();
+
+    // コピー・ムーブ禁止（epoll に自身のアドレスを登録しているため）
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    // num_threads 本のリアクタースレッドでイベントループを実行
+    // 呼び出しスレッドも1本として参加し、stop() 後に処理中のセッションが
+    // すべてハンドラーから戻るまで戻らない
+    void run(size_t num_threads = 1);
+
+    // イベントループの停止（async-signal-safe なのでシグナルハンドラーから呼び出し可能）
+    void stop() noexcept;
+
+    // keep-alive: セッションを epoll に再登録して次のリクエストを待つ
+    void resume(Session& session);
+
+    // 送信しきれなかったレスポンスがあるセッションを EPOLLOUT で再登録する
+    // 送信可能になるとハンドラーが再び呼ばれ、書き込み期限を過ぎたセッションは切断される
+    void wait_writable(Session& session);
+
+    // セッションを閉じて破棄
+    void close_session(Session& session);
+
+    // 統計情報
+    size_t get_open_sessions() const;
+
+private:
+    Reactor(int listen_socket, int epoll_fd, int wake_fd,
+            ReadyHandler on_ready, std::chrono::seconds idle_timeout);
+
+    // 1スレッド分のイベントループ
+    void event_loop();
+
+    // 受付キューが空になるまで accept してセッションを epoll に登録
+    void accept_all();
+
+    // セッションを指定したイベントで epoll に再登録する
+    void rearm(Session& session, std::uint32_t events);
+
+    // アイドルタイムアウト・書き込み期限を超えたセッションを shutdown する
+    // （破棄は HUP を受け取ったハンドラー側で行う）
+    void sweep_idle_sessions();
+
+    // ハンドラーから戻ったことを通知
+    void finish_dispatch();
+
+    int listen_socket_;
+    int epoll_fd_;
+    int wake_fd_;
+    ReadyHandler on_ready_;
+    std::chrono::seconds idle_timeout_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> dispatched_;
+    std::atomic<std::chrono::steady_clock::rep> last_sweep_;
+
+    mutable std::mutex sessions_mutex_;
+    std::unordered_map<int, std::unique_ptr<Session>> sessions_;
+    std::mutex sweep_mutex_;
+};
+
+} // namespace server
@@ -0,0 +1,81 @@
+#pragma once
+#include "http/request_parser.hpp"
+#include "http/output_buffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace server {
+
+// クライアント接続（HTTP/1.1 keep-alive セッション）の状態
+// EPOLLONESHOT により、同時に処理するワーカーは常に1つだけ
+struct Session {
+    explicit Session(int fd)
+        : fd(fd)
+        , in_flight(false)
+        , last_active(now_ticks())
+        , write_deadline(0) {}
+
+    int fd;
+
+    // 受信済みで未処理のデータ（パイプライン化された後続リクエストを含む）
+    // パース結果の string_view はこのバッファを直接参照する
+    std::string buffer;
+
+    // 読み込みをまたいで解析状態を保持するパーサー
+    http::RequestParser parser;
+
+    // 送信しきれていないレスポンス（送信可能になったら続きから送る）
+    http::OutputBuffer output;
+
+    // output を送り終えたら接続を閉じる
+    bool close_after_send = false;
+
+    // ワーカーで処理中か（アイドルタイムアウトの対象外にする）
+    std::atomic<bool> in_flight;
+
+    // 最後に通信した時刻（steady_clock のティック）
+    std::atomic<std::chrono::steady_clock::rep> last_active;
+
+    // output を送り終える期限（steady_clock のティック、0 は送信待ちなし）
+    // 部分送信のたびに延長しないため、少しずつしか読まないクライアントも期限で切断される
+    std::atomic<std::chrono::steady_clock::rep> write_deadline;
+
+    void touch() {
+        last_active.store(now_ticks(), std::memory_order_relaxed);
+    }
+
+    std::chrono::steady_clock::duration idle_for(std::chrono::steady_clock::time_point now) const {
+        auto last = std::chrono::steady_clock::duration(last_active.load(std::memory_order_relaxed));
+        return now.time_since_epoch() - last;
+    }
+
+    // 送信待ちになった時点で期限を設定（すでに設定済みなら変更しない）
+    void start_write_deadline(std::chrono::steady_clock::duration timeout) {
+        std::chrono::steady_clock::rep expected = 0;
+        write_deadline.compare_exchange_strong(expected, now_ticks() + timeout.count(),
+                                               std::memory_order_relaxed);
+    }
+
+    void clear_write_deadline() {
+        write_deadline.store(0, std::memory_order_relaxed);
+    }
+
+    bool write_expired(std::chrono::steady_clock::time_point now) const {
+        auto deadline = write_deadline.load(std::memory_order_relaxed);
+        return deadline != 0 && now.time_since_epoch().count() >= deadline;
+    }
+
+    std::chrono::steady_clock::time_point write_deadline_point() const {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(write_deadline.load(std::memory_order_relaxed))
+        );
+    }
+
+private:
+    static std::chrono::steady_clock::rep now_ticks() {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+};
+
+} // namespace server
@@ -0,0 +1,117 @@
+#include "server/sharded_server.hpp"
+#include "server/listener.hpp"
+#include <cstring>
+#include <format>
+#include <print>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace server {
+
+std::expected<std::unique_ptr<ShardedServer>, std::string> ShardedServer::create(
+    int port,
+    size_t shard_count,
+    Reactor::ReadyHandler on_ready,
+    std::chrono::seconds idle_timeout
+) {
+    if (shard_count == 0) {
+        return std::unexpected("shard_count must be greater than 0");
+    }
+
+    std::unique_ptr<ShardedServer> server(new ShardedServer());
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                server->cpus_.push_back(cpu);
+            }
+        }
+    }
+
+    server->shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        auto socket_result = create_listen_socket(port, true);
+        if (!socket_result.has_value()) {
+            return std::unexpected(socket_result.error());
+        }
+        int listen_socket = socket_result.value();
+
+        // 受信 CPU が一致するシャードへ優先して振り分けるヒント（非対応カーネルでは無視）
+        if (!server->cpus_.empty()) {
+            int cpu = server->cpus_[i % server->cpus_.size()];
+            setsockopt(listen_socket, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu));
+        }
+
+        auto reactor_result = Reactor::create(listen_socket, on_ready, idle_timeout);
+        if (!reactor_result.has_value()) {
+            close(listen_socket);
+            return std::unexpected(reactor_result.error());
+        }
+
+        server->shards_.push_back(Shard{listen_socket, std::move(reactor_result.value())});
+    }
+
+    return server;
+}
+
+ShardedServer::~ShardedServer() {
+    for (auto& shard : shards_) {
+        shard.reactor.reset();
+        close(shard.listen_socket);
+    }
+}
+
+void ShardedServer::run() {
+    std::vector<std::thread> threads;
+    threads.reserve(shards_.size() - 1);
+
+    for (size_t i = 1; i < shards_.size(); ++i) {
+        threads.emplace_back([this, i] {
+            pin_current_thread(i);
+            shards_[i].reactor->run(1);
+        });
+    }
+
+    pin_current_thread(0);
+    shards_[0].reactor->run(1);
+
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void ShardedServer::stop() noexcept {
+    // shards_ は create() 後に変更しないのでシグナルハンドラーから走査できる
+    for (auto& shard : shards_) {
+        shard.reactor->stop();
+    }
+}
+
+size_t ShardedServer::get_open_sessions() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.reactor->get_open_sessions();
+    }
+    return total;
+}
+
+void ShardedServer::pin_current_thread(size_t index) const {
+    if (cpus_.empty()) {
+        return;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpus_[index % cpus_.size()], &cpuset);
+
+    if (int err = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset); err != 0) {
+        std::println("⚠️  Failed to pin shard {} to CPU: {}", index, std::strerror(err));
+    }
+}
+
+} // namespace server
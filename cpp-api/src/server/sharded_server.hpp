@@ -0,0 +1,58 @@
+#pragma once
+#include "server/reactor.hpp"
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace server {
+
+// SO_REUSEPORT による per-core シャード構成のサーバー
+// シャードごとに同じポートへ bind したリッスンソケットとシングルスレッドの
+// リアクターを持ち、カーネルが接続をシャードへ振り分ける。
+// ハンドラーはリアクタースレッド上で実行されるため、リクエスト処理も同じコアで完結する
+class ShardedServer {
+public:
+    // shard_count 個のリッスンソケットとリアクターを作成
+    static std::expected<std::unique_ptr<ShardedServer>, std::string> create(
+        int port,
+        size_t shard_count,
+        Reactor::ReadyHandler on_ready,
+        std::chrono::seconds idle_timeout = std::chrono::seconds(75)
+    );
+
+    ~ShardedServer();
+
+    ShardedServer(const ShardedServer&) = delete;
+    ShardedServer& operator=(const ShardedServer&) = delete;
+
+    // シャードごとにスレッドを起動してコアへ固定し、全シャードの停止まで待つ
+    // 呼び出しスレッドは先頭のシャードを担当する
+    void run();
+
+    // 全シャードの停止（async-signal-safe）
+    void stop() noexcept;
+
+    size_t get_shard_count() const { return shards_.size(); }
+
+    // 統計情報
+    size_t get_open_sessions() const;
+
+private:
+    struct Shard {
+        int listen_socket;
+        std::unique_ptr<Reactor> reactor;
+    };
+
+    ShardedServer() = default;
+
+    // index 番目のシャードを実行するスレッドを CPU に固定
+    void pin_current_thread(size_t index) const;
+
+    std::vector<Shard> shards_;
+    std::vector<int> cpus_;   // プロセスに許可された CPU（cgroup の cpuset を尊重）
+};
+
+} // namespace server
@@ -0,0 +1,501 @@
+#include "server/uring_server.hpp"
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <print>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace server {
+
+namespace {
+
+// プロバイデッドバッファのグループID
+constexpr int kBufferGroup = 0;
+
+// アイドルセッションの掃除間隔
+constexpr long long kSweepIntervalSec = 1;
+
+constexpr std::uint64_t kOpMask = 0x7;
+
+} // namespace
+
+std::expected<std::unique_ptr<UringServer>, std::string> UringServer::create(
+    int listen_socket,
+    RequestHandler on_requests,
+    UringOptions options
+) {
+    if (options.buffer_count == 0 || (options.buffer_count & (options.buffer_count - 1)) != 0) {
+        return std::unexpected("io_uring buffer_count must be a power of two");
+    }
+
+    int wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        return std::unexpected(std::format("eventfd failed: {}", std::strerror(errno)));
+    }
+
+    std::unique_ptr<UringServer> server(
+        new UringServer(listen_socket, wake_fd, std::move(on_requests), options)
+    );
+
+    if (auto init_result = server->initialize(); !init_result.has_value()) {
+        return std::unexpected(init_result.error());
+    }
+
+    return server;
+}
+
+UringServer::UringServer(int listen_socket, int wake_fd, RequestHandler on_requests, UringOptions options)
+    : listen_socket_(listen_socket)
+    , wake_fd_(wake_fd)
+    , on_requests_(std::move(on_requests))
+    , options_(options)
+    , ring_{}
+    , ring_initialized_(false)
+    , buf_ring_(nullptr)
+    , wake_value_(0)
+    , timer_interval_{.tv_sec = kSweepIntervalSec, .tv_nsec = 0}
+    , running_(true)
+    , tasks_(nullptr)
+    , busy_sessions_(0) {}
+
+UringServer::~UringServer() {
+    for (auto* session : sessions_) {
+        close(session->fd);
+        delete session;
+    }
+    sessions_.clear();
+
+    if (ring_initialized_) {
+        if (buf_ring_) {
+            io_uring_free_buf_ring(&ring_, buf_ring_, options_.buffer_count, kBufferGroup);
+        }
+        io_uring_queue_exit(&ring_);
+    }
+    close(wake_fd_);
+}
+
+std::expected<void, std::string> UringServer::initialize() {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+
+    if (int ret = io_uring_queue_init_params(options_.queue_depth, &ring_, &params); ret < 0) {
+        return std::unexpected(std::format("io_uring_queue_init failed: {}", std::strerror(-ret)));
+    }
+    ring_initialized_ = true;
+
+    // recv 用のプロバイデッドバッファをカーネルへ登録
+    int ret = 0;
+    buf_ring_ = io_uring_setup_buf_ring(&ring_, options_.buffer_count, kBufferGroup, 0, &ret);
+    if (!buf_ring_) {
+        return std::unexpected(std::format("io_uring_setup_buf_ring failed: {}", std::strerror(-ret)));
+    }
+
+    buffers_.resize(static_cast<size_t>(options_.buffer_count) * options_.buffer_size);
+    const int mask = io_uring_buf_ring_mask(options_.buffer_count);
+    for (unsigned i = 0; i < options_.buffer_count; ++i) {
+        io_uring_buf_ring_add(buf_ring_, buffers_.data() + static_cast<size_t>(i) * options_.buffer_size,
+                              options_.buffer_size, static_cast<unsigned short>(i), mask, static_cast<int>(i));
+    }
+    io_uring_buf_ring_advance(buf_ring_, static_cast<int>(options_.buffer_count));
+
+    submit_accept();
+    submit_wake_read();
+    submit_timer();
+    io_uring_submit(&ring_);
+
+    return {};
+}
+
+void UringServer::run() {
+    // 停止後もワーカーで処理中のセッションが戻るまではループを回す
+    while (running_.load(std::memory_order_relaxed) || busy_sessions_ > 0) {
+        int ret = io_uring_submit_and_wait(&ring_, 1);
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            std::println("⚠️  io_uring_submit_and_wait failed: {}", std::strerror(-ret));
+            break;
+        }
+
+        unsigned head = 0;
+        unsigned count = 0;
+        io_uring_cqe* cqe = nullptr;
+        io_uring_for_each_cqe(&ring_, head, cqe) {
+            handle_completion(cqe);
+            ++count;
+        }
+        io_uring_cq_advance(&ring_, count);
+
+        run_tasks();
+    }
+}
+
+void UringServer::stop() noexcept {
+    running_.store(false, std::memory_order_relaxed);
+
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto written = write(wake_fd_, &one, sizeof(one));
+}
+
+void UringServer::enqueue(Task* task) noexcept {
+    // 侵入型スタックへ push し、空からの遷移時だけリングスレッドを起こす
+    Task* head = tasks_.load(std::memory_order_relaxed);
+    do {
+        task->next = head;
+    } while (!tasks_.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+
+    if (head == nullptr) {
+        std::uint64_t one = 1;
+        [[maybe_unused]] auto written = write(wake_fd_, &one, sizeof(one));
+    }
+}
+
+void UringServer::run_tasks() {
+    Task* list = tasks_.exchange(nullptr, std::memory_order_acquire);
+
+    // スタックを反転して投入順に実行
+    Task* ordered = nullptr;
+    while (list) {
+        Task* next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    while (ordered) {
+        Task* next = ordered->next;
+        ordered->execute(ordered);
+        ordered = next;
+    }
+}
+
+io_uring_sqe* UringServer::get_sqe() {
+    io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+    while (!sqe) {
+        // SQ が満杯なら一度カーネルへ渡して空きを作る
+        io_uring_submit(&ring_);
+        sqe = io_uring_get_sqe(&ring_);
+    }
+    return sqe;
+}
+
+namespace {
+
+std::uint64_t encode(void* ptr, std::uint64_t op) {
+    return reinterpret_cast<std::uint64_t>(ptr) | op;
+}
+
+} // namespace
+
+void UringServer::submit_accept() {
+    io_uring_sqe* sqe = get_sqe();
+    io_uring_prep_multishot_accept(sqe, listen_socket_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    io_uring_sqe_set_data64(sqe, encode(nullptr, static_cast<std::uint64_t>(Op::Accept)));
+}
+
+void UringServer::submit_recv(UringSession& session) {
+    io_uring_sqe* sqe = get_sqe();
+    io_uring_prep_recv_multishot(sqe, session.fd, nullptr, 0, 0);
+    io_uring_sqe_set_flags(sqe, IOSQE_BUFFER_SELECT);
+    sqe->buf_group = kBufferGroup;
+    io_uring_sqe_set_data64(sqe, encode(&session, static_cast<std::uint64_t>(Op::Recv)));
+    session.pending_ops++;
+    session.recv_armed = true;
+}
+
+void UringServer::submit_cancel_recv(UringSession& session) {
+    // 取り消された recv は -ECANCELED で完了し、以降は再登録しない
+    io_uring_sqe* sqe = get_sqe();
+    io_uring_prep_cancel64(sqe, encode(&session, static_cast<std::uint64_t>(Op::Recv)), 0);
+    io_uring_sqe_set_data64(sqe, encode(&session, static_cast<std::uint64_t>(Op::Cancel)));
+    session.pending_ops++;
+}
+
+void UringServer::submit_send(UringSession& session, unsigned sqe_flags) {
+    // ヘッダーとボディのセグメントを sendmsg でまとめて送信
+    session.message = msghdr{};
+    session.message.msg_iov = session.iov.data();
+    session.message.msg_iovlen = session.output.fill_iovecs(session.iov.data(), session.iov.size());
+
+    io_uring_sqe* sqe = get_sqe();
+    io_uring_prep_sendmsg(sqe, session.fd, &session.message, MSG_NOSIGNAL | MSG_WAITALL);
+    io_uring_sqe_set_flags(sqe, sqe_flags);
+    io_uring_sqe_set_data64(sqe, encode(&session, static_cast<std::uint64_t>(Op::Send)));
+    session.pending_ops++;
+    session.sending = true;
+}
+
+void UringServer::submit_wake_read() {
+    io_uring_sqe* sqe = get_sqe();
+    io_uring_prep_read(sqe, wake_fd_, &wake_value_, sizeof(wake_value_), 0);
+    io_uring_sqe_set_data64(sqe, encode(nullptr, static_cast<std::uint64_t>(Op::Wake)));
+}
+
+void UringServer::submit_timer() {
+    io_uring_sqe* sqe = get_sqe();
+    io_uring_prep_timeout(sqe, &timer_interval_, 0, 0);
+    io_uring_sqe_set_data64(sqe, encode(nullptr, static_cast<std::uint64_t>(Op::Timer)));
+}
+
+void UringServer::handle_completion(io_uring_cqe* cqe) {
+    std::uint64_t data = io_uring_cqe_get_data64(cqe);
+    auto op = static_cast<Op>(data & kOpMask);
+    auto* session = reinterpret_cast<UringSession*>(data & ~kOpMask);
+
+    switch (op) {
+    case Op::Accept:
+        on_accept(cqe);
+        break;
+    case Op::Recv:
+        on_recv(*session, cqe);
+        break;
+    case Op::Send:
+        on_send(*session, cqe);
+        break;
+    case Op::Shutdown:
+    case Op::Cancel:
+        session->pending_ops--;
+        maybe_destroy(*session);
+        break;
+    case Op::Close:
+        on_closed(*session, cqe);
+        break;
+    case Op::Wake:
+        // スケジュールされた処理は run_tasks() で実行される
+        if (running_.load(std::memory_order_relaxed) || busy_sessions_ > 0) {
+            submit_wake_read();
+        }
+        break;
+    case Op::Timer:
+        sweep_idle_sessions();
+        if (running_.load(std::memory_order_relaxed)) {
+            submit_timer();
+        }
+        break;
+    }
+}
+
+void UringServer::on_accept(io_uring_cqe* cqe) {
+    if (cqe->res >= 0) {
+        if (running_.load(std::memory_order_relaxed)) {
+            auto* session = new UringSession(cqe->res);
+            sessions_.insert(session);
+            submit_recv(*session);
+        } else {
+            close(cqe->res);
+        }
+    } else if (cqe->res != -EAGAIN && cqe->res != -ECONNABORTED) {
+        std::println("⚠️  io_uring accept failed: {}", std::strerror(-cqe->res));
+    }
+
+    // マルチショットが終了していれば再登録
+    if (!(cqe->flags & IORING_CQE_F_MORE) && running_.load(std::memory_order_relaxed)) {
+        submit_accept();
+    }
+}
+
+void UringServer::on_recv(UringSession& session, io_uring_cqe* cqe) {
+    bool more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+    if (!more) {
+        session.pending_ops--;
+        session.recv_armed = false;
+    }
+
+    if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+        auto buffer_id = static_cast<unsigned short>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        char* data = buffers_.data() + static_cast<size_t>(buffer_id) * options_.buffer_size;
+
+        // ワーカー処理中・送信中はバッファに触れないよう別領域へ退避
+        // （取り込みとディスパッチは after_send() で行う）
+        auto& target = (session.busy || session.sending) ? session.incoming : session.buffer;
+        target.append(data, static_cast<size_t>(cqe->res));
+
+        // バッファをカーネルへ返却
+        io_uring_buf_ring_add(buf_ring_, data, options_.buffer_size, buffer_id,
+                              io_uring_buf_ring_mask(options_.buffer_count), 0);
+        io_uring_buf_ring_advance(buf_ring_, 1);
+
+        session.touch();
+    } else if (cqe->res == 0 || (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -ECANCELED)) {
+        session.peer_closed = true;
+    }
+
+    if (session.closing) {
+        maybe_destroy(session);
+        return;
+    }
+
+    if (session.peer_closed) {
+        if (!session.busy && !session.sending) {
+            begin_close(session, false);
+        }
+        return;
+    }
+
+    // パイプライン化された後続リクエストを処理中に溜め込みすぎないよう、
+    // 上限に達したら complete() で取り込むまで受信を止める（残りはカーネルに残る）
+    if ((session.busy || session.sending) && !session.recv_paused && session.incoming.size() >= UringSession::kMaxIncomingBytes) {
+        session.recv_paused = true;
+        if (session.recv_armed) {
+            submit_cancel_recv(session);
+        }
+    }
+
+    if (!session.recv_armed && !session.recv_paused) {
+        submit_recv(session);
+    }
+
+    if (!session.busy && !session.sending && !session.buffer.empty()) {
+        dispatch(session);
+    }
+}
+
+void UringServer::on_send(UringSession& session, io_uring_cqe* cqe) {
+    session.pending_ops--;
+    session.sending = false;
+
+    if (session.closing) {
+        // send → shutdown → close のリンク中（失敗時は後続が -ECANCELED で返る）
+        maybe_destroy(session);
+        return;
+    }
+
+    if (cqe->res < 0) {
+        begin_close(session, false);
+        return;
+    }
+
+    // 部分送信・iovec 上限を超えた残りは続きから送信
+    session.output.consume(static_cast<size_t>(cqe->res));
+    if (!session.output.empty()) {
+        submit_send(session);
+        return;
+    }
+
+    after_send(session);
+}
+
+void UringServer::on_closed(UringSession& session, io_uring_cqe* cqe) {
+    session.pending_ops--;
+
+    if (cqe->res == -ECANCELED) {
+        // リンク先の send が失敗した場合は単独で close し直す
+        io_uring_sqe* sqe = get_sqe();
+        io_uring_prep_close(sqe, session.fd);
+        io_uring_sqe_set_data64(sqe, encode(&session, static_cast<std::uint64_t>(Op::Close)));
+        session.pending_ops++;
+        return;
+    }
+
+    maybe_destroy(session);
+}
+
+void UringServer::dispatch(UringSession& session) {
+    if (!running_.load(std::memory_order_relaxed)) {
+        begin_close(session, false);
+        return;
+    }
+
+    session.busy = true;
+    session.in_flight.store(true, std::memory_order_relaxed);
+    busy_sessions_++;
+    on_requests_(*this, session);
+}
+
+void UringServer::complete(UringSession& session, SessionState state) {
+    session.busy = false;
+    session.in_flight.store(false, std::memory_order_relaxed);
+    busy_sessions_--;
+    session.state = state;
+
+    // 送信中なら on_send() が追加分も続けて送信する（iov/message は送信完了まで使用中）
+    if (session.sending) {
+        return;
+    }
+
+    if (session.output.empty()) {
+        after_send(session);
+        return;
+    }
+
+    // 1回の sendmsg で送り切れる場合は send → shutdown → close をリンクする
+    if (state == SessionState::Close && session.output.segment_count() <= UringSession::kMaxIovecs) {
+        begin_close(session, true);
+        return;
+    }
+
+    // 読むのが遅いクライアントはレスポンス全体の期限で切断する
+    session.start_write_deadline(kWriteTimeout);
+    submit_send(session);
+}
+
+void UringServer::after_send(UringSession& session) {
+    session.clear_write_deadline();
+
+    if (session.state == SessionState::Close || session.peer_closed ||
+        !running_.load(std::memory_order_relaxed)) {
+        begin_close(session, false);
+        return;
+    }
+
+    // 処理中に届いたデータを取り込み、後続リクエストがあれば続けて処理
+    if (!session.incoming.empty()) {
+        session.buffer.append(session.incoming);
+        session.incoming.clear();
+    }
+    if (session.recv_paused) {
+        session.recv_paused = false;
+        if (!session.recv_armed) {
+            submit_recv(session);
+        }
+    }
+    if (!session.buffer.empty()) {
+        dispatch(session);
+    }
+}
+
+void UringServer::begin_close(UringSession& session, bool linked_send) {
+    if (session.closing) {
+        return;
+    }
+    session.closing = true;
+
+    // send（任意）→ shutdown → close をリンクして1回で投入する
+    // shutdown でマルチショット recv も終了する
+    if (linked_send) {
+        submit_send(session, IOSQE_IO_LINK);
+    }
+
+    io_uring_sqe* shutdown_sqe = get_sqe();
+    io_uring_prep_shutdown(shutdown_sqe, session.fd, SHUT_RDWR);
+    io_uring_sqe_set_flags(shutdown_sqe, IOSQE_IO_LINK);
+    io_uring_sqe_set_data64(shutdown_sqe, encode(&session, static_cast<std::uint64_t>(Op::Shutdown)));
+    session.pending_ops++;
+
+    io_uring_sqe* close_sqe = get_sqe();
+    io_uring_prep_close(close_sqe, session.fd);
+    io_uring_sqe_set_data64(close_sqe, encode(&session, static_cast<std::uint64_t>(Op::Close)));
+    session.pending_ops++;
+}
+
+void UringServer::maybe_destroy(UringSession& session) {
+    if (session.closing && session.pending_ops == 0 && !session.busy) {
+        sessions_.erase(&session);
+        delete &session;
+    }
+}
+
+void UringServer::sweep_idle_sessions() {
+    auto now = std::chrono::steady_clock::now();
+
+    // begin_close は sessions_ を変更しないので走査中に呼び出せる
+    for (auto* session : sessions_) {
+        if (!session->busy && !session->closing &&
+            (session->idle_for(now) >= options_.idle_timeout || session->write_expired(now) ||
+             !running_.load(std::memory_order_relaxed))) {
+            begin_close(*session, false);
+        }
+    }
+}
+
+} // namespace server
@@ -0,0 +1,220 @@
+#pragma once
+#include "server/session.hpp"
+#include "server/connection_handler.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <sys/socket.h>
+#include <liburing.h>
+#include <stdexec/execution.hpp>
+
+namespace server {
+
+// io_uring バックエンドのセッション（状態はリングスレッドだけが触る）
+struct UringSession : Session {
+    using Session::Session;
+
+    static constexpr size_t kMaxIovecs = 64;
+
+    // 処理中・送信中に退避する受信データの上限（超えたら送信完了まで受信を止める）
+    static constexpr size_t kMaxIncomingBytes = 1024 * 1024;
+
+    std::string incoming;      // ワーカー処理中・送信中に届いたデータ
+
+    // sendmsg の完了まで有効である必要があるためセッションに保持する
+    std::array<iovec, kMaxIovecs> iov{};
+    msghdr message{};
+
+    SessionState state = SessionState::KeepAlive;
+    int pending_ops = 0;      // 完了待ちの SQE 数（0 になるまで破棄しない）
+    bool busy = false;        // ワーカーでリクエスト処理中
+    bool sending = false;     // sendmsg の完了待ち（output を送り切るまで iov/message を使用中）
+    bool recv_armed = false;  // マルチショット recv が有効
+    bool recv_paused = false; // incoming が上限に達したため受信を止めている
+    bool peer_closed = false;
+    bool closing = false;
+};
+
+// io_uring の設定
+struct UringOptions {
+    unsigned queue_depth = 4096;
+    unsigned buffer_count = 1024;        // プロバイデッドバッファ数（2のべき乗）
+    unsigned buffer_size = 16 * 1024;
+    std::chrono::seconds idle_timeout = std::chrono::seconds(75);
+};
+
+// io_uring ベースの HTTP サーバー
+// マルチショット accept / プロバイデッドバッファによるマルチショット recv /
+// send と shutdown・close のリンク SQE でシステムコールを削減する。
+// リングスレッドは stdexec のスケジューラーとしても動作し、ワーカーでの
+// リクエスト処理後は continues_on(get_scheduler()) で完了処理に戻ってくる
+class UringServer {
+public:
+    // 完結したリクエストを含むセッションを受け取るハンドラー（リングスレッドで呼ばれる）
+    // 処理後はリングスレッド上で complete() を呼び出すこと
+    using RequestHandler = std::function<void(UringServer&, UringSession&)>;
+
+    class Scheduler;
+
+    static std::expected<std::unique_ptr<UringServer>, std::string> create(
+        int listen_socket,
+        RequestHandler on_requests,
+        UringOptions options = {}
+    );
+
+    ~UringServer();
+
+    UringServer(const UringServer&) = delete;
+    UringServer& operator=(const UringServer&) = delete;
+
+    // リングスレッドのイベントループ（呼び出しスレッドで実行、stop() まで戻らない）
+    void run();
+
+    // 停止（async-signal-safe）
+    void stop() noexcept;
+
+    // リングスレッドで実行する stdexec スケジューラー
+    Scheduler get_scheduler() noexcept;
+
+    // ワーカーでの処理結果を送信する（リングスレッドで呼ぶ）
+    void complete(UringSession& session, SessionState state);
+
+private:
+    // スケジューラーに投入された処理（侵入型リスト）
+    struct Task {
+        Task* next = nullptr;
+        void (*execute)(Task*) noexcept = nullptr;
+    };
+
+    // user_data の下位ビットに埋め込む操作種別
+    enum class Op : std::uint64_t {
+        Accept = 0,
+        Recv = 1,
+        Send = 2,
+        Shutdown = 3,
+        Close = 4,
+        Wake = 5,
+        Timer = 6,
+        Cancel = 7
+    };
+
+    UringServer(int listen_socket, int wake_fd, RequestHandler on_requests, UringOptions options);
+
+    std::expected<void, std::string> initialize();
+
+    io_uring_sqe* get_sqe();
+    void submit_accept();
+    void submit_recv(UringSession& session);
+    void submit_cancel_recv(UringSession& session);
+    void submit_send(UringSession& session, unsigned sqe_flags = 0);
+    void submit_wake_read();
+    void submit_timer();
+
+    void handle_completion(io_uring_cqe* cqe);
+    void on_accept(io_uring_cqe* cqe);
+    void on_recv(UringSession& session, io_uring_cqe* cqe);
+    void on_send(UringSession& session, io_uring_cqe* cqe);
+    void on_closed(UringSession& session, io_uring_cqe* cqe);
+
+    void dispatch(UringSession& session);
+    void after_send(UringSession& session);
+    void begin_close(UringSession& session, bool linked_send);
+    void maybe_destroy(UringSession& session);
+    void sweep_idle_sessions();
+
+    void enqueue(Task* task) noexcept;
+    void run_tasks();
+
+    int listen_socket_;
+    int wake_fd_;
+    RequestHandler on_requests_;
+    UringOptions options_;
+
+    io_uring ring_;
+    bool ring_initialized_;
+    io_uring_buf_ring* buf_ring_;
+    std::vector<char> buffers_;
+    std::uint64_t wake_value_;
+    __kernel_timespec timer_interval_;
+
+    std::atomic<bool> running_;
+    std::atomic<Task*> tasks_;
+    size_t busy_sessions_;
+    std::unordered_set<UringSession*> sessions_;
+};
+
+// リングスレッドへ処理を移す stdexec スケジューラー
+class UringServer::Scheduler {
+public:
+    explicit Scheduler(UringServer* server) noexcept : server_(server) {}
+
+    struct Env {
+        UringServer* server;
+
+        template <class CPO>
+        Scheduler query(stdexec::get_completion_scheduler_t<CPO>) const noexcept {
+            return Scheduler(server);
+        }
+    };
+
+    template <class Receiver>
+    struct Operation : Task {
+        UringServer* server;
+        Receiver receiver;
+
+        Operation(UringServer* s, Receiver r)
+            : server(s), receiver(std::move(r)) {
+            this->execute = &Operation::run;
+        }
+
+        Operation(const Operation&) = delete;
+        Operation& operator=(const Operation&) = delete;
+
+        static void run(Task* task) noexcept {
+            auto* self = static_cast<Operation*>(task);
+            stdexec::set_value(std::move(self->receiver));
+        }
+
+        void start() & noexcept {
+            server->enqueue(this);
+        }
+    };
+
+    struct Sender {
+        using sender_concept = stdexec::sender_t;
+        using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t()>;
+
+        UringServer* server;
+
+        template <stdexec::receiver Receiver>
+        Operation<Receiver> connect(Receiver receiver) const {
+            return Operation<Receiver>(server, std::move(receiver));
+        }
+
+        Env get_env() const noexcept {
+            return Env{server};
+        }
+    };
+
+    Sender schedule() const noexcept {
+        return Sender{server_};
+    }
+
+    bool operator==(const Scheduler&) const noexcept = default;
+
+private:
+    UringServer* server_;
+};
+
+inline UringServer::Scheduler UringServer::get_scheduler() noexcept {
+    return Scheduler(this);
+}
+
+} // namespace server
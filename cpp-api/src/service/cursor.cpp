@@ -0,0 +1,169 @@
+#include "cursor.hpp"
+#include "../validation/finite.hpp"
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <format>
+
+namespace service {
+
+namespace {
+
+constexpr std::string_view kAlphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+constexpr std::string_view kInvalidCursor = "Invalid cursor";
+
+// base64url（パディングなし）
+std::string base64url_encode(std::string_view data) {
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+
+    size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        std::uint32_t n = (static_cast<std::uint8_t>(data[i]) << 16) |
+                          (static_cast<std::uint8_t>(data[i + 1]) << 8) |
+                          static_cast<std::uint8_t>(data[i + 2]);
+        out += kAlphabet[(n >> 18) & 0x3f];
+        out += kAlphabet[(n >> 12) & 0x3f];
+        out += kAlphabet[(n >> 6) & 0x3f];
+        out += kAlphabet[n & 0x3f];
+    }
+
+    size_t rest = data.size() - i;
+    if (rest > 0) {
+        std::uint32_t n = static_cast<std::uint8_t>(data[i]) << 16;
+        if (rest == 2) {
+            n |= static_cast<std::uint8_t>(data[i + 1]) << 8;
+        }
+        out += kAlphabet[(n >> 18) & 0x3f];
+        out += kAlphabet[(n >> 12) & 0x3f];
+        if (rest == 2) {
+            out += kAlphabet[(n >> 6) & 0x3f];
+        }
+    }
+    return out;
+}
+
+std::optional<std::string> base64url_decode(std::string_view text) {
+    static constexpr auto kTable = [] {
+        std::array<std::int8_t, 256> table{};
+        table.fill(-1);
+        for (size_t i = 0; i < kAlphabet.size(); ++i) {
+            table[static_cast<unsigned char>(kAlphabet[i])] = static_cast<std::int8_t>(i);
+        }
+        return table;
+    }();
+
+    if (text.size() % 4 == 1) {
+        return std::nullopt;
+    }
+
+    std::string out;
+    out.reserve(text.size() * 3 / 4);
+
+    std::uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : text) {
+        auto value = kTable[static_cast<unsigned char>(c)];
+        if (value < 0) {
+            return std::nullopt;
+        }
+        buffer = (buffer << 6) | static_cast<std::uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out += static_cast<char>((buffer >> bits) & 0xff);
+        }
+    }
+    return out;
+}
+
+char sort_code(domain::ShopSort sort) {
+    switch (sort) {
+    case domain::ShopSort::RatingDesc: return 'r';
+    case domain::ShopSort::SpicinessDesc: return 's';
+    case domain::ShopSort::Name: return 'n';
+    case domain::ShopSort::Id: break;
+    }
+    return 'i';
+}
+
+} // namespace
+
+// 形式: <並び順コード><キー長>:<キー><id>
+std::string encode_shop_cursor(const domain::ShopCursor& cursor) {
+    std::string key;
+    switch (cursor.sort) {
+    case domain::ShopSort::RatingDesc: key = std::format("{}", cursor.rating); break;
+    case domain::ShopSort::SpicinessDesc: key = std::format("{}", cursor.spiciness); break;
+    case domain::ShopSort::Name: key = cursor.name; break;
+    case domain::ShopSort::Id: break;
+    }
+    return base64url_encode(std::format("{}{}:{}{}", sort_code(cursor.sort), key.size(), key, cursor.id));
+}
+
+std::expected<domain::ShopCursor, std::string> decode_shop_cursor(std::string_view text) {
+    auto decoded = base64url_decode(text);
+    if (!decoded || decoded->size() < 3) {
+        return std::unexpected(std::string(kInvalidCursor));
+    }
+    std::string_view data = *decoded;
+
+    domain::ShopCursor cursor;
+    switch (data[0]) {
+    case 'i': cursor.sort = domain::ShopSort::Id; break;
+    case 'r': cursor.sort = domain::ShopSort::RatingDesc; break;
+    case 's': cursor.sort = domain::ShopSort::SpicinessDesc; break;
+    case 'n': cursor.sort = domain::ShopSort::Name; break;
+    default: return std::unexpected(std::string(kInvalidCursor));
+    }
+
+    size_t key_size = 0;
+    auto [length_end, length_ec] = std::from_chars(data.data() + 1, data.data() + data.size(), key_size);
+    if (length_ec != std::errc() || length_end == data.data() + data.size() || *length_end != ':') {
+        return std::unexpected(std::string(kInvalidCursor));
+    }
+
+    std::string_view rest = data.substr(static_cast<size_t>(length_end - data.data()) + 1);
+    if (key_size > rest.size()) {
+        return std::unexpected(std::string(kInvalidCursor));
+    }
+    std::string_view key = rest.substr(0, key_size);
+    cursor.id = std::string(rest.substr(key_size));
+    if (cursor.id.empty()) {
+        return std::unexpected(std::string(kInvalidCursor));
+    }
+
+    auto parse_key = [&key](auto& value) {
+        auto [end, ec] = std::from_chars(key.data(), key.data() + key.size(), value);
+        return ec == std::errc() && end == key.data() + key.size();
+    };
+
+    bool valid = true;
+    switch (cursor.sort) {
+    case domain::ShopSort::RatingDesc: valid = parse_key(cursor.rating) && validation::is_finite(cursor.rating); break;
+    case domain::ShopSort::SpicinessDesc: valid = parse_key(cursor.spiciness); break;
+    case domain::ShopSort::Name: cursor.name = std::string(key); break;
+    case domain::ShopSort::Id: valid = key.empty(); break;
+    }
+    if (!valid) {
+        return std::unexpected(std::string(kInvalidCursor));
+    }
+
+    return cursor;
+}
+
+std::string encode_user_cursor(std::string_view id) {
+    return base64url_encode(std::format("u{}", id));
+}
+
+std::expected<std::string, std::string> decode_user_cursor(std::string_view text) {
+    auto decoded = base64url_decode(text);
+    if (!decoded || decoded->size() < 2 || decoded->front() != 'u') {
+        return std::unexpected(std::string(kInvalidCursor));
+    }
+    return decoded->substr(1);
+}
+
+} // namespace service
@@ -0,0 +1,25 @@
+#pragma once
+#include "../domain/shop_query.hpp"
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace service {
+
+// ページングされた JSON 配列と次ページのカーソル（最後のページなら nullopt）
+struct JsonPage {
+    std::shared_ptr<const std::string> json;
+    std::optional<std::string> next_cursor;
+};
+
+// カーソルは並び替えキーを base64url で包んだ不透明な文字列
+// （クライアントは次ページの after にそのまま渡すだけで中身を解釈しない）
+std::string encode_shop_cursor(const domain::ShopCursor& cursor);
+std::expected<domain::ShopCursor, std::string> decode_shop_cursor(std::string_view cursor);
+
+std::string encode_user_cursor(std::string_view id);
+std::expected<std::string, std::string> decode_user_cursor(std::string_view cursor);
+
+} // namespace service
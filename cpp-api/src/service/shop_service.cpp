@@ -1,49 +1,333 @@
 #include "shop_service.hpp"
-#include <format>
+#include "../serialization/domain_json.hpp"
+#include <algorithm>
 #include <cmath>
-#include <numbers>
+#include <print>
+#include <unordered_map>
 
 namespace service {
 
-ShopService::ShopService(std::shared_ptr<repository::IRepository<domain::Shop>> repository)
-    : repository_(std::move(repository)) {}
+ShopService::ShopService(std::shared_ptr<repository::IRepository<domain::Shop>> repository,
+                         std::shared_ptr<repository::IShopQueryRepository> query_repository)
+    : repository_(std::move(repository))
+    , query_repository_(std::move(query_repository)) {}
+
+std::expected<std::shared_ptr<const ShopSnapshot>, std::string> ShopService::get_snapshot() {
+    // ホットパスはポインタのロードのみ
+    if (auto snapshot = snapshot_.load(std::memory_order_acquire)) {
+        return snapshot;
+    }
+
+    if (auto result = refresh_snapshot(); !result) {
+        return std::unexpected(result.error());
+    }
+    return snapshot_.load(std::memory_order_acquire);
+}
+
+std::expected<void, std::string> ShopService::refresh_snapshot() {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
 
-std::expected<std::string, std::string> ShopService::get_all_shops_json() {
     auto result = repository_->find_all();
     if (!result) {
         return std::unexpected(result.error());
     }
-    return shops_to_json(result.value());
+
+    snapshot_.store(build_snapshot(std::move(result.value())), std::memory_order_release);
+    return {};
+}
+
+std::expected<void, std::string> ShopService::refresh_shops(const std::vector<std::string>& ids) {
+    // 一括更新は全件読み込みの方が速い
+    constexpr size_t kMaxIncrementalChanges = 64;
+
+    auto current = snapshot_.load(std::memory_order_acquire);
+    if (!current || ids.empty() || ids.size() > kMaxIncrementalChanges) {
+        return refresh_snapshot();
+    }
+
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+
+    // ロック待ちの間に差し替わっている可能性があるので取り直す
+    current = snapshot_.load(std::memory_order_acquire);
+
+    // 変更された店舗を読み直す（nullopt は削除された店舗）
+    std::unordered_map<std::string_view, std::optional<domain::Shop>> changes;
+    for (const auto& id : ids) {
+        auto result = repository_->find_by_id(id);
+        if (!result) {
+            return std::unexpected(result.error());
+        }
+        changes.insert_or_assign(id, std::move(result.value()));
+    }
+
+    // スナップショットにない店舗は ID 順に並べ、全件読み込み（ORDER BY id）と同じ位置へ挿入する
+    std::vector<domain::Shop> added;
+    for (auto& [id, shop] : changes) {
+        if (shop && current->find_index(id) == current->shops.size()) {
+            added.push_back(std::move(*shop));
+        }
+    }
+    std::ranges::sort(added, {}, &domain::Shop::id);
+
+    // 変更のない店舗は JSON 断片を使い回し、変更・追加された店舗だけを描画し直す
+    std::vector<domain::Shop> shops;
+    std::vector<std::shared_ptr<const std::string>> shop_json;
+    shops.reserve(current->shops.size() + added.size());
+    shop_json.reserve(current->shops.size() + added.size());
+
+    auto next_added = added.begin();
+    auto insert_added_before = [&](const std::string* id) {
+        while (next_added != added.end() && (!id || next_added->id < *id)) {
+            shops.push_back(std::move(*next_added++));
+            shop_json.emplace_back();
+        }
+    };
+
+    for (size_t i = 0; i < current->shops.size(); ++i) {
+        const auto& shop = current->shops[i];
+        insert_added_before(&shop.id);
+
+        auto change = changes.find(shop.id);
+        if (change == changes.end()) {
+            shops.push_back(shop);
+            shop_json.push_back(current->shop_json[i]);
+        } else if (change->second) {
+            shops.push_back(std::move(*change->second));
+            shop_json.emplace_back();
+        }
+    }
+    insert_added_before(nullptr);
+
+    snapshot_.store(build_snapshot(std::move(shops), std::move(shop_json)), std::memory_order_release);
+    return {};
+}
+
+void ShopService::start_snapshot_refresh(std::chrono::seconds interval) {
+    refresh_thread_ = std::jthread([this, interval](std::stop_token stop_token) {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(refresh_timer_mutex_);
+                if (refresh_timer_cv_.wait_for(lock, stop_token, interval,
+                                               [&stop_token] { return stop_token.stop_requested(); })) {
+                    return;
+                }
+            }
+
+            // 失敗時は古いスナップショットを使い続ける
+            if (auto result = refresh_snapshot(); !result) {
+                std::println("⚠️  Shop snapshot refresh failed: {}", result.error());
+            }
+        }
+    });
+}
+
+std::shared_ptr<const ShopSnapshot> ShopService::build_snapshot(
+    std::vector<domain::Shop> shops, std::vector<std::shared_ptr<const std::string>> shop_json) {
+    auto snapshot = std::make_shared<ShopSnapshot>();
+    snapshot->shops = std::move(shops);
+    snapshot->shop_json = std::move(shop_json);
+    snapshot->shop_json.resize(snapshot->shops.size());
+    snapshot->loaded_at = std::chrono::steady_clock::now();
+
+    const auto& stored = snapshot->shops;
+    snapshot->index_by_id.reserve(stored.size());
+
+    std::vector<size_t> all_indices;
+    all_indices.reserve(stored.size());
+
+    std::vector<spatial::GeoPoint> points;
+    points.reserve(stored.size());
+
+    for (size_t i = 0; i < stored.size(); ++i) {
+        if (!snapshot->shop_json[i]) {
+            snapshot->shop_json[i] = std::make_shared<const std::string>(shop_to_json(stored[i]));
+        }
+        snapshot->index_by_id.emplace(stored[i].id, i);
+        all_indices.push_back(i);
+        points.push_back(spatial::GeoPoint{stored[i].latitude, stored[i].longitude, static_cast<std::uint32_t>(i)});
+    }
+
+    snapshot->geo_index = spatial::GeoIndex(std::move(points));
+
+    snapshot->spice_index.reserve(stored.size());
+    for (const auto& shop : stored) {
+        const auto& spice = shop.spice_params;
+        snapshot->spice_index.push_back(
+            spatial::SpicePoint{spice.spiciness, spice.stimulation, spice.aroma}, shop.rating);
+    }
+
+    snapshot->all_json = std::make_shared<const std::string>(snapshot->render(all_indices));
+    return snapshot;
+}
+
+std::expected<std::string, std::string> ShopService::get_all_shops_json() {
+    auto result = get_all_shops_shared_json();
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    return *result.value();
+}
+
+std::expected<std::shared_ptr<const std::string>, std::string> ShopService::get_all_shops_shared_json() {
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        return std::unexpected(snapshot.error());
+    }
+    return snapshot.value()->all_json;
+}
+
+std::expected<std::shared_ptr<const std::string>, std::string> ShopService::query_shops_shared_json(
+    const domain::ShopQuery& query) {
+
+    auto page = query_shops_page(query);
+    if (!page) {
+        return std::unexpected(page.error());
+    }
+    return std::move(page.value().json);
+}
+
+std::expected<JsonPage, std::string> ShopService::query_shops_page(const domain::ShopQuery& query,
+                                                                  std::pmr::memory_resource* arena) {
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        // スナップショットがなければ条件と件数をデータベース側で評価する
+        if (query_repository_) {
+            return query_repository_page(query);
+        }
+        return std::unexpected(snapshot.error());
+    }
+
+    const auto& current = *snapshot.value();
+    if (!query.has_filters() && query.sort == domain::ShopSort::Id && !query.limit) {
+        return JsonPage{current.all_json, std::nullopt};
+    }
+
+    // カーソルより後ろの店舗も matches() で絞り込まれる
+    std::pmr::vector<size_t> matched(arena);
+    for (size_t i = 0; i < current.shops.size(); ++i) {
+        if (query.matches(current.shops[i])) {
+            matched.push_back(i);
+        }
+    }
+
+    // limit があれば上位だけを部分ソート
+    auto before = [&current, &query](size_t a, size_t b) {
+        return query.before(current.shops[a], current.shops[b]);
+    };
+    size_t count = std::min(matched.size(), query.limit.value_or(matched.size()));
+    std::partial_sort(matched.begin(), matched.begin() + static_cast<std::ptrdiff_t>(count), matched.end(), before);
+
+    JsonPage page;
+    if (count < matched.size() && count > 0) {
+        page.next_cursor = encode_shop_cursor(domain::ShopCursor::from(current.shops[matched[count - 1]], query.sort));
+    }
+    matched.resize(count);
+
+    page.json = std::make_shared<const std::string>(current.render(matched));
+    return page;
+}
+
+std::expected<JsonPage, std::string> ShopService::query_repository_page(const domain::ShopQuery& query) {
+    // 1件多く読み、次のページがあるかを判定する
+    auto lookahead = query;
+    if (lookahead.limit) {
+        lookahead.limit = *lookahead.limit + 1;
+    }
+
+    auto result = query_repository_->find_matching(lookahead);
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+
+    auto& shops = result.value();
+    JsonPage page;
+    if (query.limit && shops.size() > *query.limit) {
+        shops.resize(*query.limit);
+        if (!shops.empty()) {
+            page.next_cursor = encode_shop_cursor(domain::ShopCursor::from(shops.back(), query.sort));
+        }
+    }
+
+    std::string json = "[";
+    for (size_t i = 0; i < shops.size(); ++i) {
+        if (i > 0) json += ',';
+        json += shop_to_json(shops[i]);
+    }
+    json += ']';
+
+    page.json = std::make_shared<const std::string>(std::move(json));
+    return page;
+}
+
+std::expected<void, std::string> ShopService::stream_all_shops_json(
+    const std::function<bool(std::string_view)>& sink) {
+
+    if (!sink("[")) {
+        return std::unexpected("Output closed");
+    }
+
+    // 1行分のバッファを使い回し、JSON は直接そこへ書く
+    std::string json;
+    bool first = true;
+    bool sink_open = true;
+    auto result = repository_->for_each([&](const domain::Shop& shop) {
+        json.clear();
+        if (!first) {
+            json += ',';
+        }
+        first = false;
+        serialization::JsonWriter writer(json);
+        serialization::write_shop(writer, shop);
+        sink_open = sink(json);
+        return sink_open;
+    });
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    if (!sink_open || !sink("]")) {
+        return std::unexpected("Output closed");
+    }
+    return {};
 }
 
 std::expected<std::string, std::string> ShopService::get_shop_by_id_json(const std::string& id) {
-    auto result = repository_->find_by_id(id);
+    auto result = get_shop_by_id_shared_json(id);
     if (!result) {
         return std::unexpected(result.error());
     }
+    return *result.value();
+}
 
-    if (!result.value().has_value()) {
+std::expected<std::shared_ptr<const std::string>, std::string> ShopService::get_shop_by_id_shared_json(std::string_view id) {
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        return std::unexpected(snapshot.error());
+    }
+
+    const auto& current = *snapshot.value();
+    size_t index = current.find_index(id);
+    if (index == current.shops.size()) {
         return std::unexpected("Shop not found");
     }
 
-    return shop_to_json(result.value().value());
+    return current.shop_json[index];
 }
 
 std::expected<std::string, std::string> ShopService::search_shops_by_name_json(const std::string& name) {
-    // Get all shops and filter by name
-    auto all_shops_result = repository_->find_all();
-    if (!all_shops_result) {
-        return std::unexpected(all_shops_result.error());
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        return std::unexpected(snapshot.error());
     }
 
-    std::vector<domain::Shop> filtered_shops;
-    for (const auto& shop : all_shops_result.value()) {
-        if (shop.name.find(name) != std::string::npos) {
-            filtered_shops.push_back(shop);
+    const auto& current = *snapshot.value();
+    std::vector<size_t> matched;
+    for (size_t i = 0; i < current.shops.size(); ++i) {
+        if (current.shops[i].name.find(name) != std::string::npos) {
+            matched.push_back(i);
         }
     }
 
-    return shops_to_json(filtered_shops);
+    return current.render(matched);
 }
 
 std::expected<std::string, std::string> ShopService::search_shops_by_spice_level_json(const std::string& level) {
@@ -55,78 +339,103 @@ std::expected<std::string, std::string> ShopService::search_shops_by_spice_level
         return std::unexpected("Invalid spice level");
     }
 
-    auto all_shops_result = repository_->find_all();
-    if (!all_shops_result) {
-        return std::unexpected(all_shops_result.error());
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        return std::unexpected(snapshot.error());
     }
 
-    std::vector<domain::Shop> filtered_shops;
-    for (const auto& shop : all_shops_result.value()) {
-        if (shop.spice_params.spiciness >= spice_level) {
-            filtered_shops.push_back(shop);
+    const auto& current = *snapshot.value();
+    std::vector<size_t> matched;
+    for (size_t i = 0; i < current.shops.size(); ++i) {
+        if (current.shops[i].spice_params.spiciness >= spice_level) {
+            matched.push_back(i);
         }
     }
 
-    return shops_to_json(filtered_shops);
+    return current.render(matched);
 }
 
 std::expected<std::string, std::string> ShopService::find_nearby_shops_json(
-    double latitude, double longitude, double radius_km) {
+    double latitude, double longitude, double radius_km, std::pmr::memory_resource* arena) {
 
-    auto all_shops_result = repository_->find_all();
-    if (!all_shops_result) {
-        return std::unexpected(all_shops_result.error());
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        return std::unexpected(snapshot.error());
     }
 
-    std::vector<domain::Shop> nearby_shops;
-    for (const auto& shop : all_shops_result.value()) {
-        double distance = calculate_distance(latitude, longitude, shop.latitude, shop.longitude);
-        if (distance <= radius_km) {
-            nearby_shops.push_back(shop);
-        }
-    }
-
-    return shops_to_json(nearby_shops);
+    const auto& current = *snapshot.value();
+    auto nearby = current.geo_index.within_radius(latitude, longitude, radius_km, arena);
+    return current.render(nearby, &spatial::GeoHit::index);
 }
 
-std::string ShopService::shops_to_json(const std::vector<domain::Shop>& shops) {
-    std::string json = "[";
-    for (size_t i = 0; i < shops.size(); ++i) {
-        if (i > 0) json += ",";
-        json += shop_to_json(shops[i]);
+std::expected<std::string, std::string> ShopService::find_nearest_shops_json(
+    double latitude, double longitude, size_t k, double max_radius_km, std::pmr::memory_resource* arena) {
+
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        return std::unexpected(snapshot.error());
     }
-    json += "]";
-    return json;
-}
 
-std::string ShopService::shop_to_json(const domain::Shop& shop) {
-    return std::format(
-        R"({{"id":"{}","name":"{}","address":"{}","phone":"{}","latitude":{},"longitude":{},"region":"{}","spiceParameters":{{"spiciness":{},"stimulation":{},"aroma":{}}},"rating":{},"description":"{}","image_url":"{}"}})",
-        shop.id, shop.name, shop.address,
-        shop.phone.value_or(""),
-        shop.latitude, shop.longitude, shop.region,
-        shop.spice_params.spiciness, shop.spice_params.stimulation, shop.spice_params.aroma,
-        shop.rating,
-        shop.description.value_or(""),
-        shop.image_url.value_or("")
-    );
+    const auto& current = *snapshot.value();
+    auto nearest = current.geo_index.nearest(latitude, longitude, k, max_radius_km, arena);
+    return current.render(nearest, &spatial::GeoHit::index);
 }
 
-double ShopService::calculate_distance(double lat1, double lon1, double lat2, double lon2) {
-    const double R = 6371.0; // 地球の半径（km）
+std::expected<std::string, std::string> ShopService::recommend_shops_json(const RecommendationQuery& query,
+                                                                          std::pmr::memory_resource* arena) {
+    auto snapshot = get_snapshot();
+    if (!snapshot) {
+        return std::unexpected(snapshot.error());
+    }
 
-    double phi1 = lat1 * std::numbers::pi / 180.0;
-    double phi2 = lat2 * std::numbers::pi / 180.0;
-    double delta_phi = (lat2 - lat1) * std::numbers::pi / 180.0;
-    double delta_lambda = (lon2 - lon1) * std::numbers::pi / 180.0;
+    const auto& current = *snapshot.value();
+    const auto& preferences = query.preferences;
+    spatial::SpicePoint target{preferences.spiciness, preferences.stimulation, preferences.aroma};
 
-    double a = std::sin(delta_phi / 2.0) * std::sin(delta_phi / 2.0) +
-               std::cos(phi1) * std::cos(phi2) *
-               std::sin(delta_lambda / 2.0) * std::sin(delta_lambda / 2.0);
+    // 位置指定があれば半径内の店舗だけを候補にする
+    std::vector<spatial::SpiceHit> hits;
+    std::pmr::vector<spatial::GeoHit> nearby(arena);
+    if (query.near) {
+        nearby = current.geo_index.within_radius(query.near->latitude, query.near->longitude,
+                                                 query.near->radius_km, arena);
+        std::pmr::vector<std::uint32_t> candidates(arena);
+        candidates.reserve(nearby.size());
+        for (const auto& hit : nearby) {
+            candidates.push_back(hit.index);
+        }
+        hits = current.spice_index.nearest(target, query.limit, query.min_rating, candidates);
+    } else {
+        hits = current.spice_index.nearest(target, query.limit, query.min_rating);
+    }
 
-    double c = 2.0 * std::atan2(std::sqrt(a), std::sqrt(1.0 - a));
+    std::string json;
+    serialization::JsonWriter writer(json);
+    writer.begin_array();
+    for (const auto& hit : hits) {
+        double match_score = std::round((1.0 - hit.distance / spatial::SpiceIndex::kMaxDistance) * 1000.0) / 10.0;
 
-    return R * c;
+        writer.begin_object()
+            .key("matchScore").value(match_score)
+            .key("spiceDistance").fixed(hit.distance, 2);
+        if (query.near) {
+            auto it = std::find_if(nearby.begin(), nearby.end(),
+                                   [&hit](const spatial::GeoHit& g) { return g.index == hit.index; });
+            if (it != nearby.end()) {
+                writer.key("distanceKm").fixed(it->distance_km, 3);
+            }
+        }
+        writer.key("shop").raw(*current.shop_json[hit.index]);
+        writer.end_object();
+    }
+    writer.end_array();
+    return json;
+}
+
+std::string ShopService::shop_to_json(const domain::Shop& shop) {
+    std::string json;
+    serialization::JsonWriter writer(json);
+    serialization::write_shop(writer, shop);
+    return json;
 }
 
 } // namespace service
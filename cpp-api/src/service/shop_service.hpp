@@ -1,41 +1,135 @@
 #pragma once
 #include "../repository/i_repository.hpp"
+#include "../repository/i_shop_query_repository.hpp"
 #include "../domain/shop.hpp"
+#include "../domain/shop_query.hpp"
+#include "../domain/user.hpp"
+#include "shop_snapshot.hpp"
+#include "cursor.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory_resource>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace service {
 
+// 好みに合う店舗の推薦条件
+struct RecommendationQuery {
+    // 位置による絞り込み
+    struct Near {
+        double latitude;
+        double longitude;
+        double radius_km;
+    };
+
+    domain::UserPreferences preferences;
+    size_t limit = 10;
+    double min_rating = 0.0;
+    std::optional<Near> near = std::nullopt;
+};
+
 // Shop関連のビジネスロジックを担当
+// 読み取りはメモリ上のスナップショット（レンダリング済み JSON を含む）から行い、
+// スナップショットは書き込み後の refresh_snapshot() か定期更新で差し替える
 class ShopService {
 public:
-    explicit ShopService(std::shared_ptr<repository::IRepository<domain::Shop>> repository);
+    // query_repository を渡すと、スナップショットを読み込めないときの店舗一覧を
+    // データベース側の絞り込み（find_matching）で返す
+    explicit ShopService(std::shared_ptr<repository::IRepository<domain::Shop>> repository,
+                         std::shared_ptr<repository::IShopQueryRepository> query_repository = nullptr);
 
     // 全店舗取得
     std::expected<std::string, std::string> get_all_shops_json();
 
+    // 全店舗取得（スナップショットの JSON をコピーせずに返す）
+    std::expected<std::shared_ptr<const std::string>, std::string> get_all_shops_shared_json();
+
+    // 条件で絞り込んだ店舗一覧（条件がなければ全店舗の JSON をそのまま返す）
+    std::expected<std::shared_ptr<const std::string>, std::string> query_shops_shared_json(const domain::ShopQuery& query);
+
+    // 条件で絞り込んだ店舗一覧の1ページ（limit 件で打ち切った場合は次ページのカーソル付き）
+    // arena はリクエストの間だけ使う作業領域（絞り込み結果のインデックスなど）
+    std::expected<JsonPage, std::string> query_shops_page(
+        const domain::ShopQuery& query,
+        std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+
+    // 全店舗をリポジトリから1件ずつ読み、JSON 配列を断片ごとに sink へ渡す
+    // スナップショットを経由しないため、メモリ使用量は行数によらず1行分に収まる
+    // （sink が false を返したら打ち切ってエラーを返す）
+    std::expected<void, std::string> stream_all_shops_json(const std::function<bool(std::string_view)>& sink);
+
     // ID検索
     std::expected<std::string, std::string> get_shop_by_id_json(const std::string& id);
 
+    // ID検索（スナップショットの JSON をコピーせずに返す）
+    std::expected<std::shared_ptr<const std::string>, std::string> get_shop_by_id_shared_json(std::string_view id);
+
     // 店名検索
     std::expected<std::string, std::string> search_shops_by_name_json(const std::string& name);
 
     // 辛さレベルで検索
     std::expected<std::string, std::string> search_shops_by_spice_level_json(const std::string& level);
 
-    // 近隣店舗検索（緯度経度ベース）
-    std::expected<std::string, std::string> find_nearby_shops_json(double latitude, double longitude, double radius_km);
+    // 近隣店舗検索（緯度経度ベース、距離の近い順）
+    std::expected<std::string, std::string> find_nearby_shops_json(
+        double latitude, double longitude, double radius_km,
+        std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+
+    // 最寄りの k 店舗（距離の近い順、max_radius_km より遠い店舗は含めない）
+    std::expected<std::string, std::string> find_nearest_shops_json(
+        double latitude, double longitude, size_t k,
+        double max_radius_km = std::numeric_limits<double>::infinity(),
+        std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+
+    // 好みのスパイスパラメータに近い順の店舗（一致度・スパイス空間の距離付き）
+    std::expected<std::string, std::string> recommend_shops_json(
+        const RecommendationQuery& query,
+        std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+
+    // 現在のスナップショット（未ロードならリポジトリから読み込む）
+    std::expected<std::shared_ptr<const ShopSnapshot>, std::string> get_snapshot();
+
+    // リポジトリから再読み込みしてスナップショットを差し替える（書き込み後に呼び出す）
+    std::expected<void, std::string> refresh_snapshot();
+
+    // 変更された店舗だけをリポジトリから読み直してスナップショットを差し替える
+    // （件数が多い場合や ids が空の場合は全件を再読み込み）
+    std::expected<void, std::string> refresh_shops(const std::vector<std::string>& ids);
+
+    // interval ごとにバックグラウンドでスナップショットを更新する
+    void start_snapshot_refresh(std::chrono::seconds interval);
 
 private:
     std::shared_ptr<repository::IRepository<domain::Shop>> repository_;
+    std::shared_ptr<repository::IShopQueryRepository> query_repository_;
+
+    std::atomic<std::shared_ptr<const ShopSnapshot>> snapshot_;
+    std::mutex refresh_mutex_;   // 再読み込みの直列化
+
+    // 定期更新スレッド（破棄時に最初に停止・join されるよう最後に宣言）
+    std::mutex refresh_timer_mutex_;
+    std::condition_variable_any refresh_timer_cv_;
+    std::jthread refresh_thread_;
+
+    // shop_json に断片がある店舗はそれを使い、ない店舗（null・省略）だけを描画する
+    std::shared_ptr<const ShopSnapshot> build_snapshot(
+        std::vector<domain::Shop> shops,
+        std::vector<std::shared_ptr<const std::string>> shop_json = {});
+
+    // スナップショットを使わず query_repository_ で絞り込んだ1ページ
+    std::expected<JsonPage, std::string> query_repository_page(const domain::ShopQuery& query);
 
     // ドメインオブジェクトからJSON文字列への変換
-    std::string shops_to_json(const std::vector<domain::Shop>& shops);
     std::string shop_to_json(const domain::Shop& shop);
-
-    // 距離計算（Haversine公式）
-    double calculate_distance(double lat1, double lon1, double lat2, double lon2);
 };
 
 } // namespace service
@@ -0,0 +1,68 @@
+#pragma once
+#include "../domain/shop.hpp"
+#include "../spatial/geo_index.hpp"
+#include "../spatial/spice_index.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace service {
+
+// 店舗データのイミュータブルなスナップショット
+// 構築後は変更しないため、複数スレッドからロックなしで参照できる。
+// 更新時は新しいスナップショットを作成してポインタごと差し替える
+struct ShopSnapshot {
+    std::vector<domain::Shop> shops;
+
+    // 全店舗の JSON 配列（レスポンスボディとしてそのまま送信する）
+    std::shared_ptr<const std::string> all_json;
+
+    // 店舗ごとの JSON（shops と同じ順序）
+    std::vector<std::shared_ptr<const std::string>> shop_json;
+
+    // ID → shops のインデックス
+    std::unordered_map<std::string_view, size_t> index_by_id;
+
+    // 店舗座標の空間インデックス（GeoHit::index は shops のインデックス）
+    spatial::GeoIndex geo_index;
+
+    // スパイスパラメータの k近傍インデックス（SpiceHit::index は shops のインデックス）
+    spatial::SpiceIndex spice_index;
+
+    std::chrono::steady_clock::time_point loaded_at;
+
+    // ID検索（見つからなければ shops.size()）
+    size_t find_index(std::string_view id) const {
+        auto it = index_by_id.find(id);
+        return it != index_by_id.end() ? it->second : shops.size();
+    }
+
+    // 指定したインデックスの店舗を JSON 配列として連結
+    // index で要素からインデックスを取り出す（GeoHit などを詰め替えずに渡せる）
+    template <class Range, class Index = std::identity>
+    std::string render(const Range& items, Index index = {}) const {
+        size_t total = 2;
+        for (const auto& item : items) {
+            total += shop_json[std::invoke(index, item)]->size() + 1;
+        }
+
+        std::string json;
+        json.reserve(total);
+        json += '[';
+        bool first = true;
+        for (const auto& item : items) {
+            if (!first) json += ',';
+            first = false;
+            json += *shop_json[std::invoke(index, item)];
+        }
+        json += ']';
+        return json;
+    }
+};
+
+} // namespace service
@@ -1,5 +1,7 @@
 #include "user_service.hpp"
 #include "../validation/user_validator.hpp"
+#include "../serialization/domain_json.hpp"
+#include <algorithm>
 #include <format>
 #include <nlohmann/json.hpp>
 
@@ -17,27 +19,159 @@ std::expected<std::string, std::string> UserService::get_all_users_json() {
     return std::unexpected("Not implemented yet");
 }
 
+std::expected<JsonPage, std::string> UserService::list_users_page(size_t limit, const std::optional<std::string>& after) {
+    std::optional<std::string> after_id;
+    if (after) {
+        auto decoded = decode_user_cursor(*after);
+        if (!decoded) {
+            return std::unexpected(decoded.error());
+        }
+        after_id = std::move(decoded.value());
+    }
+
+    // 1件多く読んで次ページの有無を判定
+    std::vector<domain::User> users;
+    if (postgres_repository_) {
+        // users.id は SERIAL
+        if (after_id && !std::ranges::all_of(*after_id, [](char c) { return c >= '0' && c <= '9'; })) {
+            return std::unexpected("Invalid cursor");
+        }
+        auto result = postgres_repository_->find_page(limit + 1, after_id);
+        if (!result) {
+            return std::unexpected(result.error());
+        }
+        users = std::move(result.value());
+    } else if (json_repository_) {
+        auto result = json_repository_->find_all();
+        if (!result) {
+            return std::unexpected(result.error());
+        }
+        for (auto& user : result.value()) {
+            if (!after_id || user.id > *after_id) {
+                users.push_back(std::move(user));
+            }
+        }
+        std::ranges::sort(users, {}, &domain::User::id);
+        if (users.size() > limit + 1) {
+            users.resize(limit + 1);
+        }
+    } else {
+        return std::unexpected("No repository available");
+    }
+
+    JsonPage page;
+    if (users.size() > limit) {
+        users.resize(limit);
+        if (!users.empty()) {
+            page.next_cursor = encode_user_cursor(users.back().id);
+        }
+    }
+    page.json = std::make_shared<const std::string>(users_to_json(users));
+    return page;
+}
+
+std::expected<std::optional<domain::User>, std::string> UserService::find_user_by_id(const std::string& id) {
+    if (postgres_repository_) {
+        return postgres_repository_->find_by_id(id);
+    } else if (json_repository_) {
+        return json_repository_->find_by_id(id);
+    }
+    return std::unexpected("No repository available");
+}
+
 std::expected<std::string, std::string> UserService::get_user_by_id_json(const std::string& id) {
+    auto result = find_user_by_id(id);
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    if (!result.value().has_value()) {
+        return std::unexpected("User not found");
+    }
+    return user_to_json(result.value().value());
+}
+
+std::expected<std::string, std::string> UserService::get_user_profile_json(const std::string& id) {
+    domain::UserProfile profile;
+
     if (postgres_repository_) {
-        auto result = postgres_repository_->find_by_id(id);
+        auto result = postgres_repository_->find_profile_by_id(id);
         if (!result) {
             return std::unexpected(result.error());
         }
         if (!result.value().has_value()) {
             return std::unexpected("User not found");
         }
-        return user_to_json(result.value().value());
-    } else if (json_repository_) {
-        auto result = json_repository_->find_by_id(id);
+        profile = std::move(*result.value());
+    } else {
+        // JSON リポジトリは店舗との関連を持たない
+        auto result = find_user_by_id(id);
         if (!result) {
             return std::unexpected(result.error());
         }
         if (!result.value().has_value()) {
             return std::unexpected("User not found");
         }
-        return user_to_json(result.value().value());
+        profile.user = std::move(*result.value());
+    }
+
+    return profile_to_json(profile);
+}
+
+std::string UserService::profile_to_json(const domain::UserProfile& profile) {
+    std::string json;
+    serialization::JsonWriter writer(json);
+    serialization::write_user_profile(writer, profile);
+    return json;
+}
+
+std::expected<domain::UserPreferences, std::string> UserService::get_user_preferences(const std::string& id) {
+    // キャッシュが際限なく増えないよう上限で全件破棄する
+    constexpr size_t kMaxCachedPreferences = 100'000;
+
+    std::uint64_t generation = 0;
+    {
+        std::shared_lock lock(preferences_mutex_);
+        auto it = preferences_cache_.find(id);
+        if (it != preferences_cache_.end() &&
+            std::chrono::steady_clock::now() - it->second.loaded_at < kPreferencesTtl) {
+            return it->second.preferences;
+        }
+        generation = preferences_generation_;
+    }
+
+    auto loaded_at = std::chrono::steady_clock::now();
+    auto result = find_user_by_id(id);
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    if (!result.value().has_value()) {
+        return std::unexpected("User not found");
+    }
+
+    auto preferences = result.value()->preferences;
+
+    std::unique_lock lock(preferences_mutex_);
+    // 読み込みの間に無効化されていれば、読んだ値が古い可能性があるので格納しない
+    if (preferences_generation_ != generation) {
+        return preferences;
+    }
+    if (preferences_cache_.size() >= kMaxCachedPreferences) {
+        preferences_cache_.clear();
+    }
+    preferences_cache_.insert_or_assign(id, CachedPreferences{preferences, loaded_at});
+    return preferences;
+}
+
+void UserService::invalidate_preferences(const std::vector<std::string>& ids) {
+    std::unique_lock lock(preferences_mutex_);
+    ++preferences_generation_;
+    if (ids.empty()) {
+        preferences_cache_.clear();
+        return;
+    }
+    for (const auto& id : ids) {
+        preferences_cache_.erase(id);
     }
-    return std::unexpected("No repository available");
 }
 
 std::expected<std::string, std::string> UserService::get_user_by_username_json(const std::string& username) {
@@ -94,21 +228,22 @@ std::expected<std::string, std::string> UserService::create_user_json(
 }
 
 std::string UserService::users_to_json(const std::vector<domain::User>& users) {
-    std::string json = "[";
-    for (size_t i = 0; i < users.size(); ++i) {
-        if (i > 0) json += ",";
-        json += user_to_json(users[i]);
+    // 全ユーザーを1つのバッファへ直接書き込む
+    std::string json;
+    serialization::JsonWriter writer(json);
+    writer.begin_array();
+    for (const auto& user : users) {
+        serialization::write_user(writer, user);
     }
-    json += "]";
+    writer.end_array();
     return json;
 }
 
 std::string UserService::user_to_json(const domain::User& user) {
-    return std::format(
-        R"({{"id":"{}","username":"{}","email":"{}","spiciness":{},"stimulation":{},"aroma":{}}})",
-        user.id, user.username, user.email,
-        user.preferences.spiciness, user.preferences.stimulation, user.preferences.aroma
-    );
+    std::string json;
+    serialization::JsonWriter writer(json);
+    serialization::write_user(writer, user);
+    return json;
 }
 
 std::expected<std::string, std::string> UserService::create_user_from_json(const std::string& json_body) {
@@ -116,28 +251,58 @@ std::expected<std::string, std::string> UserService::create_user_from_json(const
         return std::unexpected("PostgreSQL repository not available");
     }
 
-    // 1. JSONパース
+    // 1. JSONパース・バリデーション
+    auto user = parse_new_user(json_body);
+    if (!user) {
+        return std::unexpected(user.error());
+    }
+
+    // 2. データベース挿入（有効なら他の登録とまとめてコミット）
+    auto insert_result = write_combiner_ ? write_combiner_->add(*user) : postgres_repository_->add(*user);
+    if (!insert_result) {
+        return std::unexpected(insert_result.error());
+    }
+
+    // 3. 成功レスポンス生成
+    return user_to_json(insert_result.value());
+}
+
+std::expected<domain::User, std::string> UserService::parse_new_user(const std::string& json_body) {
     auto user_result = parse_user_json(json_body);
     if (!user_result) {
         return std::unexpected("Invalid JSON: " + user_result.error());
     }
 
-    domain::User user = user_result.value();
-
-    // 2. バリデーション
-    auto validation_result = validate_user(user);
+    auto validation_result = validate_user(user_result.value());
     if (!validation_result) {
         return std::unexpected("Validation failed: " + validation_result.error());
     }
+    return user_result;
+}
 
-    // 3. データベース挿入
-    auto insert_result = postgres_repository_->add(user);
-    if (!insert_result) {
-        return std::unexpected(insert_result.error());
+void UserService::enable_write_combining(const repository::WriteCombinerOptions& options) {
+    if (!postgres_repository_) {
+        return;
     }
+    write_combiner_ = std::make_unique<repository::UserWriteCombiner>(
+        [repository = postgres_repository_](std::span<const domain::User> users) {
+            return repository->add_batch(users);
+        },
+        options
+    );
+}
 
-    // 4. 成功レスポンス生成
-    return user_to_json(insert_result.value());
+void UserService::stop_write_combining() {
+    if (write_combiner_) {
+        write_combiner_->stop();
+    }
+}
+
+std::optional<repository::WriteCombinerMetrics> UserService::write_combiner_metrics() const {
+    if (!write_combiner_) {
+        return std::nullopt;
+    }
+    return write_combiner_->metrics();
 }
 
 std::expected<domain::User, std::string> UserService::parse_user_json(const std::string& json_body) {
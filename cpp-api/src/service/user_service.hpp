@@ -1,9 +1,15 @@
 #pragma once
 #include "../repository/json_repository.hpp"
 #include "../repository/postgres_user_repository.hpp"
+#include "../repository/user_write_combiner.hpp"
 #include "../domain/user.hpp"
+#include "cursor.hpp"
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace service {
@@ -20,9 +26,39 @@ public:
     // 全ユーザー取得
     std::expected<std::string, std::string> get_all_users_json();
 
+    // id 順のユーザー一覧の1ページ（after は前ページで返したカーソル）
+    std::expected<JsonPage, std::string> list_users_page(size_t limit, const std::optional<std::string>& after);
+
     // ID検索
     std::expected<std::string, std::string> get_user_by_id_json(const std::string& id);
 
+    // ID検索（お気に入り・苦手な店舗の ID を含む）
+    std::expected<std::string, std::string> get_user_profile_json(const std::string& id);
+
+    // get_user_profile_json の非同期版（AsyncPool の I/O スレッドで JSON まで作る sender）
+    static auto async_get_user_profile_json(database::AsyncPool& pool, std::string id) {
+        return repository::PostgresUserRepository::async_find_profile_by_id(pool, std::move(id))
+             | stdexec::then([](std::expected<std::optional<domain::UserProfile>, std::string> result)
+                   -> std::expected<std::string, std::string> {
+                   if (!result) {
+                       return std::unexpected(result.error());
+                   }
+                   if (!result.value().has_value()) {
+                       return std::unexpected("User not found");
+                   }
+                   return profile_to_json(*result.value());
+               });
+    }
+
+    // キャッシュした好みの有効期限（変更通知を取りこぼしても古い値はこれ以上使わない）
+    static constexpr auto kPreferencesTtl = std::chrono::seconds(60);
+
+    // スパイスの好み（推薦用にキャッシュし、kPreferencesTtl の間は SQL を発行しない）
+    std::expected<domain::UserPreferences, std::string> get_user_preferences(const std::string& id);
+
+    // 変更されたユーザーのキャッシュを破棄（ids が空なら全件）
+    void invalidate_preferences(const std::vector<std::string>& ids);
+
     // ユーザー名検索
     std::expected<std::string, std::string> get_user_by_username_json(const std::string& username);
 
@@ -37,9 +73,47 @@ public:
     // JSON リクエストボディからユーザー登録（新規）
     std::expected<std::string, std::string> create_user_from_json(const std::string& json_body);
 
+    // 同時に届いた登録をまとめて1回のコミットで書き込む（PostgreSQL のみ、サーバー起動前に呼び出すこと）
+    void enable_write_combining(const repository::WriteCombinerOptions& options);
+
+    bool write_combining_enabled() const { return write_combiner_ != nullptr; }
+
+    // create_user_from_json の非同期版（write_combining_enabled() のときのみ）
+    // 書き込みを待つ間はスレッドを占有せず、書き込みスレッド上で JSON まで作って完了する
+    auto async_create_user_from_json(const std::string& json_body) {
+        return write_combiner_->insert(parse_new_user(json_body))
+             | stdexec::then([this](std::expected<domain::User, std::string> result)
+                   -> std::expected<std::string, std::string> {
+                   if (!result) {
+                       return std::unexpected(result.error());
+                   }
+                   return user_to_json(result.value());
+               });
+    }
+
+    // ためている登録を書き込んで以降の登録を止める（サーバー停止後に呼び出す）
+    void stop_write_combining();
+
+    // 登録のバッチの統計（無効なら nullopt）
+    std::optional<repository::WriteCombinerMetrics> write_combiner_metrics() const;
+
 private:
     std::shared_ptr<repository::JsonUserRepository> json_repository_;
     std::shared_ptr<repository::PostgresUserRepository> postgres_repository_;
+    std::unique_ptr<repository::UserWriteCombiner> write_combiner_;
+
+    struct CachedPreferences {
+        domain::UserPreferences preferences;
+        std::chrono::steady_clock::time_point loaded_at;
+    };
+
+    // ユーザーID → スパイスの好み
+    // 世代は invalidate_preferences() のたびに進み、読み込み中に無効化された値は格納しない
+    std::shared_mutex preferences_mutex_;
+    std::unordered_map<std::string, CachedPreferences> preferences_cache_;
+    std::uint64_t preferences_generation_ = 0;
+
+    std::expected<std::optional<domain::User>, std::string> find_user_by_id(const std::string& id);
 
     // JSON パース
     std::expected<domain::User, std::string> parse_user_json(const std::string& json);
@@ -47,9 +121,13 @@ private:
     // バリデーション
     std::expected<void, std::string> validate_user(const domain::User& user);
 
+    // 登録するユーザーをパースして検証（エラーは create_user_from_json と同じ）
+    std::expected<domain::User, std::string> parse_new_user(const std::string& json_body);
+
     // ドメインオブジェクトからJSON文字列への変換
     std::string users_to_json(const std::vector<domain::User>& users);
     std::string user_to_json(const domain::User& user);
+    static std::string profile_to_json(const domain::UserProfile& profile);
 };
 
 } // namespace service
@@ -0,0 +1,258 @@
+#include "spatial/coordinate_store.hpp"
+#include "spatial/geo_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace spatial {
+
+namespace {
+
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+
+// 判定の許容誤差（1 - cos の桁落ち対策、約 6m 相当）
+constexpr double kHaversineSlack = 1e-12;
+constexpr double kEquirectangularSlack = 1e-9;
+
+// カーネルに渡す列と検索条件
+// Haversine:   a = cos_lat, b = sin_lat, c = cos_lon, d = sin_lon
+//              q0 = cos φq, q1 = sin φq, q2 = cos λq, q3 = sin λq
+// 正距円筒:    a = lat_rad, b = lon_rad
+//              q0 = φq, q1 = λq, q2 = cos φq
+struct KernelArgs {
+    const double* a;
+    const double* b;
+    const double* c;
+    const double* d;
+    double q0, q1, q2, q3;
+    double threshold;
+    size_t begin;
+    size_t end;
+};
+
+// hav(d) = (1 - cos Δφ) / 2 + cos φ1 cos φ2 (1 - cos Δλ) / 2
+// cos Δφ = cos φ1 cos φ2 + sin φ1 sin φ2（経度も同様）なので事前計算した sin/cos の積和で求まる
+inline bool haversine_hit(const KernelArgs& k, size_t i) {
+    double cos_product = k.q0 * k.a[i];
+    double cos_dlat = cos_product + k.q1 * k.b[i];
+    double cos_dlon = k.q2 * k.c[i] + k.q3 * k.d[i];
+    double hav = 0.5 * ((1.0 - cos_dlat) + cos_product * (1.0 - cos_dlon));
+    return hav <= k.threshold;
+}
+
+// x = Δλ cos φq, y = Δφ として平面上の距離で判定
+inline bool equirectangular_hit(const KernelArgs& k, size_t i) {
+    double y = k.a[i] - k.q0;
+    double x = (k.b[i] - k.q1) * k.q2;
+    return x * x + y * y <= k.threshold;
+}
+
+template <bool (*Hit)(const KernelArgs&, size_t)>
+void scalar_kernel(const KernelArgs& k, size_t begin, std::pmr::vector<std::uint32_t>& out) {
+    for (size_t i = begin; i < k.end; ++i) {
+        if (Hit(k, i)) {
+            out.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+void scalar_haversine(const KernelArgs& k, std::pmr::vector<std::uint32_t>& out) {
+    scalar_kernel<haversine_hit>(k, k.begin, out);
+}
+
+void scalar_equirectangular(const KernelArgs& k, std::pmr::vector<std::uint32_t>& out) {
+    scalar_kernel<equirectangular_hit>(k, k.begin, out);
+}
+
+#if defined(__x86_64__)
+
+// 比較結果のビットマスクから一致した位置を追加
+inline void append_mask(unsigned mask, size_t base, std::pmr::vector<std::uint32_t>& out) {
+    while (mask) {
+        out.push_back(static_cast<std::uint32_t>(base + static_cast<size_t>(__builtin_ctz(mask))));
+        mask &= mask - 1;
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void avx2_haversine(const KernelArgs& k, std::pmr::vector<std::uint32_t>& out) {
+    const __m256d q0 = _mm256_set1_pd(k.q0);
+    const __m256d q1 = _mm256_set1_pd(k.q1);
+    const __m256d q2 = _mm256_set1_pd(k.q2);
+    const __m256d q3 = _mm256_set1_pd(k.q3);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d threshold = _mm256_set1_pd(k.threshold);
+
+    size_t i = k.begin;
+    for (; i + 4 <= k.end; i += 4) {
+        __m256d cos_product = _mm256_mul_pd(q0, _mm256_loadu_pd(k.a + i));
+        __m256d cos_dlat = _mm256_fmadd_pd(q1, _mm256_loadu_pd(k.b + i), cos_product);
+        __m256d cos_dlon = _mm256_fmadd_pd(q3, _mm256_loadu_pd(k.d + i),
+                                           _mm256_mul_pd(q2, _mm256_loadu_pd(k.c + i)));
+        __m256d hav = _mm256_mul_pd(half, _mm256_fmadd_pd(cos_product, _mm256_sub_pd(one, cos_dlon),
+                                                          _mm256_sub_pd(one, cos_dlat)));
+        __m256d hit = _mm256_cmp_pd(hav, threshold, _CMP_LE_OQ);
+        append_mask(static_cast<unsigned>(_mm256_movemask_pd(hit)), i, out);
+    }
+
+    scalar_kernel<haversine_hit>(k, i, out);
+}
+
+__attribute__((target("avx2,fma")))
+void avx2_equirectangular(const KernelArgs& k, std::pmr::vector<std::uint32_t>& out) {
+    const __m256d q0 = _mm256_set1_pd(k.q0);
+    const __m256d q1 = _mm256_set1_pd(k.q1);
+    const __m256d q2 = _mm256_set1_pd(k.q2);
+    const __m256d threshold = _mm256_set1_pd(k.threshold);
+
+    size_t i = k.begin;
+    for (; i + 4 <= k.end; i += 4) {
+        __m256d y = _mm256_sub_pd(_mm256_loadu_pd(k.a + i), q0);
+        __m256d x = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(k.b + i), q1), q2);
+        __m256d dist2 = _mm256_fmadd_pd(x, x, _mm256_mul_pd(y, y));
+        __m256d hit = _mm256_cmp_pd(dist2, threshold, _CMP_LE_OQ);
+        append_mask(static_cast<unsigned>(_mm256_movemask_pd(hit)), i, out);
+    }
+
+    scalar_kernel<equirectangular_hit>(k, i, out);
+}
+
+__attribute__((target("avx512f")))
+void avx512_haversine(const KernelArgs& k, std::pmr::vector<std::uint32_t>& out) {
+    const __m512d q0 = _mm512_set1_pd(k.q0);
+    const __m512d q1 = _mm512_set1_pd(k.q1);
+    const __m512d q2 = _mm512_set1_pd(k.q2);
+    const __m512d q3 = _mm512_set1_pd(k.q3);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d threshold = _mm512_set1_pd(k.threshold);
+
+    size_t i = k.begin;
+    for (; i + 8 <= k.end; i += 8) {
+        __m512d cos_product = _mm512_mul_pd(q0, _mm512_loadu_pd(k.a + i));
+        __m512d cos_dlat = _mm512_fmadd_pd(q1, _mm512_loadu_pd(k.b + i), cos_product);
+        __m512d cos_dlon = _mm512_fmadd_pd(q3, _mm512_loadu_pd(k.d + i),
+                                           _mm512_mul_pd(q2, _mm512_loadu_pd(k.c + i)));
+        __m512d hav = _mm512_mul_pd(half, _mm512_fmadd_pd(cos_product, _mm512_sub_pd(one, cos_dlon),
+                                                          _mm512_sub_pd(one, cos_dlat)));
+        __mmask8 hit = _mm512_cmp_pd_mask(hav, threshold, _CMP_LE_OQ);
+        append_mask(hit, i, out);
+    }
+
+    scalar_kernel<haversine_hit>(k, i, out);
+}
+
+__attribute__((target("avx512f")))
+void avx512_equirectangular(const KernelArgs& k, std::pmr::vector<std::uint32_t>& out) {
+    const __m512d q0 = _mm512_set1_pd(k.q0);
+    const __m512d q1 = _mm512_set1_pd(k.q1);
+    const __m512d q2 = _mm512_set1_pd(k.q2);
+    const __m512d threshold = _mm512_set1_pd(k.threshold);
+
+    size_t i = k.begin;
+    for (; i + 8 <= k.end; i += 8) {
+        __m512d y = _mm512_sub_pd(_mm512_loadu_pd(k.a + i), q0);
+        __m512d x = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(k.b + i), q1), q2);
+        __m512d dist2 = _mm512_fmadd_pd(x, x, _mm512_mul_pd(y, y));
+        __mmask8 hit = _mm512_cmp_pd_mask(dist2, threshold, _CMP_LE_OQ);
+        append_mask(hit, i, out);
+    }
+
+    scalar_kernel<equirectangular_hit>(k, i, out);
+}
+
+#endif
+
+using Kernel = void (*)(const KernelArgs&, std::pmr::vector<std::uint32_t>&);
+
+struct KernelSet {
+    Kernel haversine;
+    Kernel equirectangular;
+    const char* name;
+};
+
+// CPU の対応命令を一度だけ調べてカーネルを選択
+const KernelSet& select_kernels() {
+    static const KernelSet kernels = [] {
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return KernelSet{avx512_haversine, avx512_equirectangular, "avx512"};
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return KernelSet{avx2_haversine, avx2_equirectangular, "avx2"};
+        }
+#endif
+        return KernelSet{scalar_haversine, scalar_equirectangular, "scalar"};
+    }();
+    return kernels;
+}
+
+} // namespace
+
+void CoordinateStore::reserve(size_t n) {
+    for (auto* column : {&lat_deg_, &lon_deg_, &lat_rad_, &lon_rad_,
+                         &sin_lat_, &cos_lat_, &sin_lon_, &cos_lon_}) {
+        column->reserve(n);
+    }
+}
+
+void CoordinateStore::push_back(double latitude_deg, double longitude_deg) {
+    double phi = latitude_deg * kDegToRad;
+    double lambda = longitude_deg * kDegToRad;
+
+    lat_deg_.push_back(latitude_deg);
+    lon_deg_.push_back(longitude_deg);
+    lat_rad_.push_back(phi);
+    lon_rad_.push_back(lambda);
+    sin_lat_.push_back(std::sin(phi));
+    cos_lat_.push_back(std::cos(phi));
+    sin_lon_.push_back(std::sin(lambda));
+    cos_lon_.push_back(std::cos(lambda));
+}
+
+void CoordinateStore::filter_within_radius(double latitude_deg, double longitude_deg, double radius_km,
+                                           size_t begin, size_t end, std::pmr::vector<std::uint32_t>& out,
+                                           DistanceMode mode) const {
+    end = std::min(end, size());
+    if (begin >= end || radius_km < 0.0) {
+        return;
+    }
+
+    double phi = latitude_deg * kDegToRad;
+    double lambda = longitude_deg * kDegToRad;
+    double angular = std::min(radius_km / kEarthRadiusKm, std::numbers::pi);
+    const auto& kernels = select_kernels();
+
+    if (mode == DistanceMode::Equirectangular) {
+        KernelArgs args{
+            lat_rad_.data(), lon_rad_.data(), nullptr, nullptr,
+            phi, lambda, std::cos(phi), 0.0,
+            angular * angular * (1.0 + kEquirectangularSlack),
+            begin, end
+        };
+        kernels.equirectangular(args, out);
+        return;
+    }
+
+    // hav(θ) = sin²(θ/2) と比較すれば逆三角関数は不要
+    double half_sin = std::sin(angular / 2.0);
+    KernelArgs args{
+        cos_lat_.data(), sin_lat_.data(), cos_lon_.data(), sin_lon_.data(),
+        std::cos(phi), std::sin(phi), std::cos(lambda), std::sin(lambda),
+        half_sin * half_sin + kHaversineSlack,
+        begin, end
+    };
+    kernels.haversine(args, out);
+}
+
+const char* CoordinateStore::kernel_name() {
+    return select_kernels().name;
+}
+
+} // namespace spatial
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace spatial {
+
+// 半径判定の方式
+enum class DistanceMode {
+    Haversine,        // 大円距離（正確）
+    Equirectangular   // 正距円筒近似（数十km以内の短い半径向けの高速版）
+};
+
+// 座標の列指向（SoA）ストア
+// 緯度経度の sin/cos を登録時に計算して列ごとに連続配置し、半径判定を
+// 三角関数なしの積和だけで行う（AVX-512 / AVX2 / スカラーを実行時に選択）
+class CoordinateStore {
+public:
+    void reserve(size_t n);
+    void push_back(double latitude_deg, double longitude_deg);
+
+    size_t size() const { return lat_deg_.size(); }
+    double latitude(size_t i) const { return lat_deg_[i]; }
+    double longitude(size_t i) const { return lon_deg_[i]; }
+
+    // [begin, end) のうち中心から radius_km 以内の位置を out に追加する
+    // 境界上の丸め誤差で取りこぼさないよう判定はわずかに緩いため、
+    // 厳密な距離は呼び出し側で haversine_km により確認する
+    // out は呼び出し側のアロケータ（リクエストのアリーナなど）で確保したものをそのまま使う
+    void filter_within_radius(double latitude_deg, double longitude_deg, double radius_km,
+                              size_t begin, size_t end, std::pmr::vector<std::uint32_t>& out,
+                              DistanceMode mode = DistanceMode::Haversine) const;
+
+    // 実行時に選択されたカーネル（"avx512" / "avx2" / "scalar"）
+    static const char* kernel_name();
+
+private:
+    std::vector<double> lat_deg_;
+    std::vector<double> lon_deg_;
+    std::vector<double> lat_rad_;
+    std::vector<double> lon_rad_;
+    std::vector<double> sin_lat_;
+    std::vector<double> cos_lat_;
+    std::vector<double> sin_lon_;
+    std::vector<double> cos_lon_;
+};
+
+} // namespace spatial
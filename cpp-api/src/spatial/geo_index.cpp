@@ -0,0 +1,252 @@
+#include "spatial/geo_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <queue>
+
+namespace spatial {
+
+namespace {
+
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+
+} // namespace
+
+double haversine_km(double lat1, double lon1, double lat2, double lon2) {
+    double phi1 = lat1 * kDegToRad;
+    double phi2 = lat2 * kDegToRad;
+    double delta_phi = (lat2 - lat1) * kDegToRad;
+    double delta_lambda = (lon2 - lon1) * kDegToRad;
+
+    double sin_phi = std::sin(delta_phi / 2.0);
+    double sin_lambda = std::sin(delta_lambda / 2.0);
+    double a = sin_phi * sin_phi + std::cos(phi1) * std::cos(phi2) * sin_lambda * sin_lambda;
+
+    return 2.0 * kEarthRadiusKm * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+GeoIndex::GeoIndex(std::vector<GeoPoint> points, double cell_size_deg)
+    : cell_size_deg_(cell_size_deg) {
+    if (points.empty()) {
+        return;
+    }
+
+    // セル順（行優先）に並べ替えて各セルの範囲を記録
+    std::sort(points.begin(), points.end(), [this](const GeoPoint& a, const GeoPoint& b) {
+        auto ka = std::pair(cell_row(a.latitude), cell_col(a.longitude));
+        auto kb = std::pair(cell_row(b.latitude), cell_col(b.longitude));
+        return ka < kb;
+    });
+
+    coordinates_.reserve(points.size());
+    indices_.reserve(points.size());
+
+    min_row_ = min_col_ = std::numeric_limits<std::int32_t>::max();
+    max_row_ = max_col_ = std::numeric_limits<std::int32_t>::min();
+
+    for (std::uint32_t i = 0; i < points.size(); ++i) {
+        const auto& point = points[i];
+        auto row = cell_row(point.latitude);
+        auto col = cell_col(point.longitude);
+
+        coordinates_.push_back(point.latitude, point.longitude);
+        indices_.push_back(point.index);
+
+        auto [it, inserted] = cells_.try_emplace(cell_key(row, col), CellRange{i, i + 1});
+        if (!inserted) {
+            it->second.end = i + 1;
+        }
+
+        min_row_ = std::min(min_row_, row);
+        max_row_ = std::max(max_row_, row);
+        min_col_ = std::min(min_col_, col);
+        max_col_ = std::max(max_col_, col);
+        max_abs_latitude_ = std::max(max_abs_latitude_, std::abs(point.latitude));
+    }
+}
+
+std::int32_t GeoIndex::cell_row(double latitude) const {
+    return static_cast<std::int32_t>(std::floor(latitude / cell_size_deg_));
+}
+
+std::int32_t GeoIndex::cell_col(double longitude) const {
+    return static_cast<std::int32_t>(std::floor(longitude / cell_size_deg_));
+}
+
+std::uint64_t GeoIndex::cell_key(std::int32_t row, std::int32_t col) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32) |
+           static_cast<std::uint32_t>(col);
+}
+
+template <class Visitor>
+void GeoIndex::visit_cell(std::int32_t row, std::int32_t col, Visitor&& visit) const {
+    if (row < min_row_ || row > max_row_ || col < min_col_ || col > max_col_) {
+        return;
+    }
+    auto it = cells_.find(cell_key(row, col));
+    if (it == cells_.end()) {
+        return;
+    }
+    for (auto i = it->second.begin; i < it->second.end; ++i) {
+        visit(i);
+    }
+}
+
+std::pmr::vector<GeoHit> GeoIndex::within_radius(double latitude, double longitude, double radius_km,
+                                                 std::pmr::memory_resource* arena) const {
+    std::pmr::vector<GeoHit> hits(arena);
+    if (indices_.empty() || radius_km < 0.0) {
+        return hits;
+    }
+
+    // 中心から radius_km を含むバウンディングボックス
+    double angular = radius_km / kEarthRadiusKm;
+    double delta_lat = angular / kDegToRad;
+    double delta_lon = 180.0;
+    double cos_lat = std::cos(latitude * kDegToRad);
+    if (std::sin(angular) < cos_lat) {
+        delta_lon = std::asin(std::sin(angular) / cos_lat) / kDegToRad;
+    }
+
+    auto row_begin = std::max(cell_row(latitude - delta_lat), min_row_);
+    auto row_end = std::min(cell_row(latitude + delta_lat), max_row_);
+    auto col_begin = std::max(cell_col(longitude - delta_lon), min_col_);
+    auto col_end = std::min(cell_col(longitude + delta_lon), max_col_);
+
+    std::pmr::vector<std::uint32_t> candidates(arena);
+
+    for (auto row = row_begin; row <= row_end; ++row) {
+        // 行優先で整列しているため、同じ行の連続したセルはストア上でも連続する
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+        bool found = false;
+        for (auto col = col_begin; col <= col_end; ++col) {
+            auto it = cells_.find(cell_key(row, col));
+            if (it == cells_.end()) {
+                continue;
+            }
+            if (!found) {
+                begin = it->second.begin;
+                found = true;
+            }
+            end = it->second.end;
+        }
+
+        if (found) {
+            coordinates_.filter_within_radius(latitude, longitude, radius_km, begin, end, candidates);
+        }
+    }
+
+    // カーネルの判定はわずかに緩いため、候補だけ正確な距離で確認
+    hits.reserve(candidates.size());
+    for (auto position : candidates) {
+        double distance = haversine_km(latitude, longitude,
+                                       coordinates_.latitude(position), coordinates_.longitude(position));
+        if (distance <= radius_km) {
+            hits.push_back(GeoHit{indices_[position], distance});
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const GeoHit& a, const GeoHit& b) {
+        return a.distance_km < b.distance_km || (a.distance_km == b.distance_km && a.index < b.index);
+    });
+    return hits;
+}
+
+double GeoIndex::ring_lower_bound_km(double latitude, std::int32_t ring) const {
+    if (ring <= 0) {
+        return 0.0;
+    }
+
+    // ring 個離れたセルとは緯度か経度が少なくとも (ring - 1) セル分離れている
+    // （中心セル内のどこにいても成り立つ）
+    double delta = (ring - 1) * cell_size_deg_ * kDegToRad;
+
+    // 緯度方向: 子午線に沿った距離が下限
+    double lat_bound = kEarthRadiusKm * delta;
+
+    // 経度方向: hav(d) >= cos(φ1)cos(φ2)hav(Δλ) より
+    double cos_product = std::cos(latitude * kDegToRad) * std::cos(max_abs_latitude_ * kDegToRad);
+    double lon_bound = 2.0 * kEarthRadiusKm *
+                       std::asin(std::min(1.0, std::sqrt(std::max(0.0, cos_product)) * std::sin(delta / 2.0)));
+
+    return std::min(lat_bound, lon_bound);
+}
+
+std::pmr::vector<GeoHit> GeoIndex::nearest(double latitude, double longitude, size_t k, double max_radius_km,
+                                           std::pmr::memory_resource* arena) const {
+    std::pmr::vector<GeoHit> hits(arena);
+    if (indices_.empty() || k == 0) {
+        return hits;
+    }
+
+    auto by_distance = [](const GeoHit& a, const GeoHit& b) {
+        return a.distance_km < b.distance_km || (a.distance_km == b.distance_km && a.index < b.index);
+    };
+    // 現在の上位 k 件（先頭が最も遠い）
+    std::pmr::vector<GeoHit> heap(arena);
+    heap.reserve(std::min(k, indices_.size()));
+    std::priority_queue<GeoHit, std::pmr::vector<GeoHit>, decltype(by_distance)> best(by_distance, std::move(heap));
+
+    auto center_row = cell_row(latitude);
+    auto center_col = cell_col(longitude);
+
+    // すべてのセルを覆うのに必要なリング数
+    std::int32_t max_ring = std::max({
+        std::abs(center_row - min_row_), std::abs(center_row - max_row_),
+        std::abs(center_col - min_col_), std::abs(center_col - max_col_)
+    });
+
+    auto consider = [&](std::uint32_t position) {
+        double distance = haversine_km(latitude, longitude,
+                                       coordinates_.latitude(position), coordinates_.longitude(position));
+        if (distance > max_radius_km) {
+            return;
+        }
+        GeoHit hit{indices_[position], distance};
+        if (best.size() < k) {
+            best.push(hit);
+        } else if (by_distance(hit, best.top())) {
+            best.pop();
+            best.push(hit);
+        }
+    };
+
+    for (std::int32_t ring = 0; ring <= max_ring; ++ring) {
+        double bound = ring_lower_bound_km(latitude, ring);
+        if (bound > max_radius_km) {
+            break;
+        }
+        if (best.size() == k && bound > best.top().distance_km) {
+            break;
+        }
+
+        // リングの外周セルだけを走査（点のある範囲外のセルは飛ばす）
+        auto row_begin = std::max(center_row - ring, min_row_);
+        auto row_end = std::min(center_row + ring, max_row_);
+        for (auto row = row_begin; row <= row_end; ++row) {
+            bool edge_row = (row == center_row - ring || row == center_row + ring);
+            if (edge_row) {
+                auto col_begin = std::max(center_col - ring, min_col_);
+                auto col_end = std::min(center_col + ring, max_col_);
+                for (auto col = col_begin; col <= col_end; ++col) {
+                    visit_cell(row, col, consider);
+                }
+            } else {
+                visit_cell(row, center_col - ring, consider);
+                if (ring > 0) {
+                    visit_cell(row, center_col + ring, consider);
+                }
+            }
+        }
+    }
+
+    hits.resize(best.size());
+    for (auto i = hits.size(); i > 0; --i) {
+        hits[i - 1] = best.top();
+        best.pop();
+    }
+    return hits;
+}
+
+} // namespace spatial
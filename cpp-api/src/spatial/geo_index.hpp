@@ -0,0 +1,83 @@
+#pragma once
+#include "spatial/coordinate_store.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+namespace spatial {
+
+// 地球の半径（km）
+inline constexpr double kEarthRadiusKm = 6371.0;
+
+// 2点間の大円距離（Haversine公式、km）
+double haversine_km(double lat1, double lon1, double lat2, double lon2);
+
+// 登録点の位置
+struct GeoPoint {
+    double latitude;
+    double longitude;
+    std::uint32_t index;   // 呼び出し側の配列（店舗など）のインデックス
+};
+
+// 検索結果（距離の昇順で返す）
+struct GeoHit {
+    std::uint32_t index;
+    double distance_km;
+};
+
+// 緯度経度の等間隔グリッドによるイミュータブルな空間インデックス
+// 点はセル順に列指向ストアへ連続配置し、半径検索はバウンディングボックスに掛かる
+// 各行のセル範囲をまとめて SIMD カーネルで絞り込んでから正確な距離を計算する。
+// k近傍検索は中心セルからリング状に広げ、未探索セルの距離の下限が
+// k番目の距離を超えた時点で打ち切る（経度 ±180° の折り返しは扱わない）
+class GeoIndex {
+public:
+    GeoIndex() = default;
+
+    // cell_size_deg: セルの一辺（度）。0.05° ≒ 緯度方向 5.6km
+    explicit GeoIndex(std::vector<GeoPoint> points, double cell_size_deg = 0.05);
+
+    // 半径 radius_km 以内の点
+    // 結果と途中の候補は arena から確保する（リクエストのアリーナを渡せばヒープを使わない）
+    std::pmr::vector<GeoHit> within_radius(
+        double latitude, double longitude, double radius_km,
+        std::pmr::memory_resource* arena = std::pmr::get_default_resource()) const;
+
+    // 近い順に最大 k 件（max_radius_km を超える点は含めない）
+    std::pmr::vector<GeoHit> nearest(
+        double latitude, double longitude, size_t k,
+        double max_radius_km = std::numeric_limits<double>::infinity(),
+        std::pmr::memory_resource* arena = std::pmr::get_default_resource()) const;
+
+    size_t size() const { return indices_.size(); }
+
+private:
+    struct CellRange {
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    std::int32_t cell_row(double latitude) const;
+    std::int32_t cell_col(double longitude) const;
+    static std::uint64_t cell_key(std::int32_t row, std::int32_t col);
+
+    // セル内の点（ストア上の位置）を visit に渡す
+    template <class Visitor>
+    void visit_cell(std::int32_t row, std::int32_t col, Visitor&& visit) const;
+
+    // 中心セルからリング ring 個分離れたセルに含まれる点までの距離の下限
+    double ring_lower_bound_km(double latitude, std::int32_t ring) const;
+
+    double cell_size_deg_ = 0.05;
+    CoordinateStore coordinates_;                         // セル順に整列した座標
+    std::vector<std::uint32_t> indices_;                  // 位置 → 呼び出し側のインデックス
+    std::unordered_map<std::uint64_t, CellRange> cells_;  // セル → 位置の範囲
+    std::int32_t min_row_ = 0, max_row_ = -1;
+    std::int32_t min_col_ = 0, max_col_ = -1;
+    double max_abs_latitude_ = 0.0;
+};
+
+} // namespace spatial
@@ -0,0 +1,121 @@
+#include "spatial/spice_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace spatial {
+
+namespace {
+
+// 除外した点に設定する距離
+constexpr float kExcluded = std::numeric_limits<float>::infinity();
+
+// 距離の二乗を上位 k 件の距離順（同距離はインデックス順）に整列した結果へ変換
+std::vector<SpiceHit> select_top_k(const std::vector<float>& distance2,
+                                   std::vector<std::uint32_t>& order, size_t k) {
+    auto closer = [&distance2](std::uint32_t a, std::uint32_t b) {
+        return distance2[a] < distance2[b] || (distance2[a] == distance2[b] && a < b);
+    };
+
+    // 除外された点を取り除いてから上位 k 件を選択
+    std::erase_if(order, [&distance2](std::uint32_t i) { return distance2[i] == kExcluded; });
+    k = std::min(k, order.size());
+    if (k < order.size()) {
+        std::nth_element(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(), closer);
+        order.resize(k);
+    }
+    std::sort(order.begin(), order.end(), closer);
+
+    std::vector<SpiceHit> hits;
+    hits.reserve(order.size());
+    for (auto i : order) {
+        hits.push_back(SpiceHit{i, std::sqrt(static_cast<double>(distance2[i]))});
+    }
+    return hits;
+}
+
+float clamp_level(int value) {
+    return static_cast<float>(std::clamp(value, 0, 100));
+}
+
+} // namespace
+
+void SpiceIndex::reserve(size_t n) {
+    spiciness_.reserve(n);
+    stimulation_.reserve(n);
+    aroma_.reserve(n);
+    rating_.reserve(n);
+}
+
+void SpiceIndex::push_back(const SpicePoint& point, double rating) {
+    spiciness_.push_back(clamp_level(point.spiciness));
+    stimulation_.push_back(clamp_level(point.stimulation));
+    aroma_.push_back(clamp_level(point.aroma));
+    rating_.push_back(static_cast<float>(rating));
+}
+
+std::vector<SpiceHit> SpiceIndex::nearest(const SpicePoint& query, size_t k, double min_rating) const {
+    const size_t n = size();
+    if (n == 0 || k == 0) {
+        return {};
+    }
+
+    const float qs = clamp_level(query.spiciness);
+    const float qt = clamp_level(query.stimulation);
+    const float qa = clamp_level(query.aroma);
+    const float min_r = static_cast<float>(min_rating);
+
+    const float* s = spiciness_.data();
+    const float* t = stimulation_.data();
+    const float* a = aroma_.data();
+    const float* r = rating_.data();
+
+    // 列ごとの連続配列に対する分岐なしのループ（-O3 でベクトル化される）
+    std::vector<float> distance2(n);
+    float* out = distance2.data();
+    for (size_t i = 0; i < n; ++i) {
+        float ds = s[i] - qs;
+        float dt = t[i] - qt;
+        float da = a[i] - qa;
+        float d2 = ds * ds + dt * dt + da * da;
+        out[i] = r[i] >= min_r ? d2 : kExcluded;
+    }
+
+    std::vector<std::uint32_t> order(n);
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = static_cast<std::uint32_t>(i);
+    }
+    return select_top_k(distance2, order, k);
+}
+
+std::vector<SpiceHit> SpiceIndex::nearest(const SpicePoint& query, size_t k, double min_rating,
+                                          std::span<const std::uint32_t> candidates) const {
+    if (candidates.empty() || k == 0) {
+        return {};
+    }
+
+    const float qs = clamp_level(query.spiciness);
+    const float qt = clamp_level(query.stimulation);
+    const float qa = clamp_level(query.aroma);
+    const float min_r = static_cast<float>(min_rating);
+
+    // 候補は絞り込み済みで少ないため、登録順の距離表に必要な分だけ書き込む
+    std::vector<float> distance2(size(), kExcluded);
+    std::vector<std::uint32_t> order;
+    order.reserve(candidates.size());
+
+    for (auto i : candidates) {
+        if (i >= size() || distance2[i] != kExcluded) {
+            continue;
+        }
+        float ds = spiciness_[i] - qs;
+        float dt = stimulation_[i] - qt;
+        float da = aroma_[i] - qa;
+        distance2[i] = rating_[i] >= min_r ? ds * ds + dt * dt + da * da : kExcluded;
+        order.push_back(i);
+    }
+
+    return select_top_k(distance2, order, k);
+}
+
+} // namespace spatial
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace spatial {
+
+// スパイス空間（辛さ・刺激度・香り、各 0-100）の点
+struct SpicePoint {
+    int spiciness;
+    int stimulation;
+    int aroma;
+};
+
+// 推薦結果（スパイス空間での距離の昇順）
+struct SpiceHit {
+    std::uint32_t index;   // 登録順のインデックス
+    double distance;       // ユークリッド距離（0 〜 100√3）
+};
+
+// スパイスパラメータの k近傍検索
+// 値を列ごとに float 配列へ並べ、全件の距離を分岐なしのループで計算してから
+// 上位 k 件を選ぶ（店舗数が数万件までならグリッドより速くメモリも小さい）
+class SpiceIndex {
+public:
+    // 2点間の最大距離（100√3）
+    static constexpr double kMaxDistance = 173.20508075688772;
+
+    SpiceIndex() = default;
+
+    void reserve(size_t n);
+    void push_back(const SpicePoint& point, double rating);
+
+    size_t size() const { return spiciness_.size(); }
+
+    // 近い順に最大 k 件（min_rating 未満は除外）
+    std::vector<SpiceHit> nearest(const SpicePoint& query, size_t k, double min_rating = 0.0) const;
+
+    // candidates（登録順のインデックス）の中から近い順に最大 k 件
+    std::vector<SpiceHit> nearest(const SpicePoint& query, size_t k, double min_rating,
+                                  std::span<const std::uint32_t> candidates) const;
+
+private:
+    std::vector<float> spiciness_;
+    std::vector<float> stimulation_;
+    std::vector<float> aroma_;
+    std::vector<float> rating_;
+};
+
+} // namespace spatial
@@ -0,0 +1,15 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+
+namespace validation {
+
+// NaN・無限大でなければ true
+// サーバーは -ffast-math（-ffinite-math-only）でビルドされ std::isfinite が常に true に
+// 畳み込まれうるため、指数部のビットを直接調べる
+constexpr bool is_finite(double value) noexcept {
+    constexpr std::uint64_t kExponentMask = 0x7ff0'0000'0000'0000;
+    return (std::bit_cast<std::uint64_t>(value) & kExponentMask) != kExponentMask;
+}
+
+} // namespace validation
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "database/async_pool.hpp"
+#include "repository/postgres_user_repository.hpp"
+#include <stdexec/execution.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace database;
+
+class AsyncPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // テスト用環境変数
+        setenv("DB_HOST", "postgres", 1);
+        setenv("DB_PORT", "5432", 1);
+        setenv("DB_NAME", "spice_road", 1);
+        setenv("DB_USER", "spice_user", 1);
+        setenv("DB_PASSWORD", "spice_password", 1);
+    }
+
+    void TearDown() override {
+        unsetenv("DB_HOST");
+        unsetenv("DB_PORT");
+        unsetenv("DB_NAME");
+        unsetenv("DB_USER");
+        unsetenv("DB_PASSWORD");
+    }
+
+    static constexpr const char* kMissingUserId = "00000000-0000-0000-0000-000000000000";
+};
+
+// Test 1: 全接続の準備完了まで待って作成される
+TEST_F(AsyncPoolTest, CreateOpensAllConnections) {
+    auto config = DatabaseConfig::from_env().value();
+    auto pool = AsyncPool::create(config, 3);
+    ASSERT_TRUE(pool.has_value());
+
+    EXPECT_EQ((*pool)->get_connection_count(), 3);
+    EXPECT_EQ((*pool)->get_in_flight(), 0);
+}
+
+// Test 2: 接続できない設定では作成に失敗する
+TEST_F(AsyncPoolTest, InvalidConfiguration) {
+    DatabaseConfig config{"invalid_host", 9999, "invalid_db", "invalid_user", "invalid_password"};
+
+    auto pool = AsyncPool::create(config, 2);
+    EXPECT_FALSE(pool.has_value());
+}
+
+// Test 3: sync_wait でクエリ結果を受け取る
+TEST_F(AsyncPoolTest, QueryCompletesWithResult) {
+    auto pool = AsyncPool::create(DatabaseConfig::from_env().value(), 1).value();
+
+    auto [result] = stdexec::sync_wait(
+        pool->query(statements::kUserFindById, {std::string(kMissingUserId)})
+    ).value();
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->rows(), 0);
+}
+
+// Test 4: SQL エラーは失敗として完了し、同じ接続で次のクエリを実行できる
+TEST_F(AsyncPoolTest, SqlErrorDoesNotBreakConnection) {
+    auto pool = AsyncPool::create(DatabaseConfig::from_env().value(), 1).value();
+
+    auto [invalid] = stdexec::sync_wait(
+        pool->query(statements::kUserFindById, {std::string("not-a-uuid")})
+    ).value();
+    EXPECT_FALSE(invalid.has_value());
+
+    auto [valid] = stdexec::sync_wait(
+        pool->query(statements::kUserFindById, {std::string(kMissingUserId)})
+    ).value();
+    EXPECT_TRUE(valid.has_value());
+}
+
+// Test 5: 少数のスレッドから接続数を超えるクエリを同時に投入できる
+TEST_F(AsyncPoolTest, ManyQueriesInFlightOverFewConnections) {
+    auto pool = AsyncPool::create(DatabaseConfig::from_env().value(), 2).value();
+
+    constexpr int kQueries = 200;
+    std::atomic<int> completed{0};
+    std::atomic<int> failed{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kQueries / 2; ++i) {
+                stdexec::start_detached(
+                    pool->query(statements::kUserFindById, {std::string(kMissingUserId)})
+                    | stdexec::then([&](QueryResult result) {
+                          if (!result.has_value()) {
+                              failed.fetch_add(1);
+                          }
+                          completed.fetch_add(1);
+                      })
+                );
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (completed.load() < kQueries && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(completed.load(), kQueries);
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_EQ(pool->get_in_flight(), 0);
+}
+
+// Test 6: リポジトリの sender は UserProfile に変換して完了する
+TEST_F(AsyncPoolTest, RepositorySenderConvertsResult) {
+    auto pool = AsyncPool::create(DatabaseConfig::from_env().value(), 1).value();
+
+    auto [profile] = stdexec::sync_wait(
+        repository::PostgresUserRepository::async_find_profile_by_id(*pool, kMissingUserId)
+    ).value();
+
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_FALSE(profile->has_value());
+}
+
+// Test 7: 期限を過ぎたクエリ（接続待ちを含む）は kTimeoutError で完了し、残らない
+TEST_F(AsyncPoolTest, QueriesPastDeadlineTimeOut) {
+    auto pool = AsyncPool::create(DatabaseConfig::from_env().value(), 1, std::chrono::milliseconds(1)).value();
+
+    constexpr int kQueries = 200;
+    std::atomic<int> completed{0};
+    std::atomic<int> timed_out{0};
+    for (int i = 0; i < kQueries; ++i) {
+        stdexec::start_detached(
+            pool->query(statements::kUserFindById, {std::string(kMissingUserId)})
+            | stdexec::then([&](QueryResult result) {
+                  if (!result.has_value() && result.error() == AsyncPool::kTimeoutError) {
+                      timed_out.fetch_add(1);
+                  }
+                  completed.fetch_add(1);
+              })
+        );
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (completed.load() < kQueries && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(completed.load(), kQueries);
+    EXPECT_GT(timed_out.load(), 0);
+    EXPECT_EQ(pool->get_in_flight(), 0);
+}
+
+// Test 8: text[] のテキスト形式を要素へ分解する（引用符・エスケープ・空配列）
+TEST(ParseTextArrayTest, SplitsQuotedAndPlainElements) {
+    auto ids = parse_text_array(R"({1,"a b","c,d","e\"f","g\\h"})");
+    ASSERT_TRUE(ids.has_value());
+    EXPECT_EQ(*ids, (std::vector<std::string>{"1", "a b", "c,d", "e\"f", "g\\h"}));
+
+    auto empty = parse_text_array("{}");
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_TRUE(empty->empty());
+
+    EXPECT_FALSE(parse_text_array("{a,NULL}").has_value());
+    EXPECT_FALSE(parse_text_array("{{1,2},{3,4}}").has_value());
+    EXPECT_FALSE(parse_text_array("1,2").has_value());
+}
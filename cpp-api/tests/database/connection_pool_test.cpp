@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "database/connection_pool.hpp"
+#include <array>
 #include <thread>
 #include <vector>
 
@@ -194,3 +195,145 @@ TEST_F(ConnectionPoolTest, ProperCleanupOnDestruction) {
     auto new_pool = ConnectionPool::create(config, 5);
     EXPECT_TRUE(new_pool.has_value());
 }
+
+// Test 9: 接続数より多いスレッドからの同時取得でも同じ接続を二重に貸し出さない
+TEST_F(ConnectionPoolTest, ConcurrentAcquireNeverSharesConnection) {
+    auto config = DatabaseConfig::from_env().value();
+    auto pool = ConnectionPool::create(config, 2).value();
+
+    std::atomic<int> in_use{0};
+    std::atomic<int> max_in_use{0};
+    std::atomic<int> success_count{0};
+
+    auto worker = [&]() {
+        for (int i = 0; i < 200; ++i) {
+            auto conn = pool.acquire();
+            if (!conn.has_value()) {
+                continue;
+            }
+            success_count++;
+            int now = ++in_use;
+            int seen = max_in_use.load();
+            while (now > seen && !max_in_use.compare_exchange_weak(seen, now)) {
+            }
+            --in_use;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < std::max(4u, std::thread::hardware_concurrency()); ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto metrics = pool.metrics();
+    EXPECT_LE(max_in_use.load(), 2);
+    EXPECT_EQ(metrics.acquired, static_cast<std::uint64_t>(success_count.load()));
+    // 初回の取得と接続を増やした取得はどちらにも数えない
+    EXPECT_LE(metrics.affinity_hits + metrics.steals, metrics.acquired);
+    EXPECT_EQ(metrics.active, 0u);
+    EXPECT_EQ(metrics.available, 2u);
+}
+
+// Test 10: 接続は需要に応じて max_size まで増え、使われなくなると min_size まで減る
+TEST_F(ConnectionPoolTest, GrowsOnDemandAndShrinksWhenIdle) {
+    auto config = DatabaseConfig::from_env().value();
+    PoolOptions options;
+    options.min_size = 1;
+    options.max_size = 3;
+    options.idle_timeout = std::chrono::milliseconds(50);
+    options.health_check_interval = std::chrono::milliseconds(20);
+    auto pool = ConnectionPool::create(config, options).value();
+    EXPECT_EQ(pool.get_pool_size(), 1u);
+
+    {
+        std::vector<Connection> connections;
+        for (int i = 0; i < 3; ++i) {
+            auto conn = pool.acquire();
+            ASSERT_TRUE(conn.has_value());
+            connections.push_back(std::move(conn.value()));
+        }
+        EXPECT_EQ(pool.get_pool_size(), 3u);
+
+        // 上限に達したらタイムアウトまで待つ
+        EXPECT_FALSE(pool.acquire(std::chrono::milliseconds(100)).has_value());
+    }
+
+    pool.start_maintenance();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    auto metrics = pool.metrics();
+    EXPECT_EQ(pool.get_pool_size(), 1u);
+    EXPECT_EQ(metrics.closed_idle, 2u);
+    EXPECT_EQ(metrics.connects, 3u);
+    EXPECT_TRUE(pool.acquire().has_value());
+}
+
+// Test 11: 複数のステートメントを1回の往復でまとめて実行し、結果を順に返す
+TEST_F(ConnectionPoolTest, ExecuteBatchReturnsResultsInOrder) {
+    auto config = DatabaseConfig::from_env().value();
+    auto pool = ConnectionPool::create(config, 1).value();
+    auto conn = pool.acquire().value();
+
+    const std::string missing_id = "-1";
+    const std::array<BatchQuery, 3> queries{{
+        {statements::kUserFindById, {missing_id}},
+        {statements::kUserFavoriteShopIds, {missing_id}},
+        {statements::kShopFindAll, {}},
+    }};
+
+    auto results = conn.execute_batch(queries);
+    ASSERT_TRUE(results.has_value()) << results.error();
+    ASSERT_EQ(results->size(), 3u);
+    EXPECT_TRUE((*results)[0].empty());
+    EXPECT_TRUE((*results)[1].empty());
+
+    // 型の合わないパラメータは失敗し、接続はそのまま使える
+    const std::array<BatchQuery, 1> invalid{{
+        {statements::kUserFindById, {std::string("not-a-number")}},
+    }};
+    EXPECT_FALSE(conn.execute_batch(invalid).has_value());
+    EXPECT_TRUE(conn.execute_batch(queries).has_value());
+}
+
+// Test 12: 前回の接続が使用中のときだけ steals に数える
+TEST_F(ConnectionPoolTest, CountsStealsOnlyWhenAffinitySlotIsBusy) {
+    auto config = DatabaseConfig::from_env().value();
+    auto pool = ConnectionPool::create(config, 2).value();
+
+    // 前回の接続はスレッドごとに覚えるため、以前のテストの影響がない新しいスレッドで取得する
+    std::thread([&pool] {
+        // 初回はどちらにも数えず、返却後の再取得は前回の接続
+        EXPECT_TRUE(pool.acquire().has_value());
+        EXPECT_TRUE(pool.acquire().has_value());
+        EXPECT_EQ(pool.metrics().affinity_hits, 1u);
+        EXPECT_EQ(pool.metrics().steals, 0u);
+
+        // 前回の接続を持ったまま取得すると、もう一方の空き接続を取る
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        EXPECT_TRUE(first.has_value() && second.has_value());
+    }).join();
+
+    auto metrics = pool.metrics();
+    EXPECT_EQ(metrics.affinity_hits, 2u);
+    EXPECT_EQ(metrics.steals, 1u);
+    EXPECT_EQ(metrics.acquired, 4u);
+}
+
+// Test 13: 変更通知ペイロードの解析
+TEST(NotificationListenerTest, ParsesChangePayload) {
+    EXPECT_EQ(NotificationListener::channel_for("shops"), "shops_changed");
+
+    auto update = NotificationListener::parse_payload("shops", "UPDATE:shop-001");
+    EXPECT_EQ(update.table, "shops");
+    EXPECT_EQ(update.operation, "UPDATE");
+    EXPECT_EQ(update.id, "shop-001");
+    EXPECT_FALSE(update.is_whole_table());
+
+    auto truncate = NotificationListener::parse_payload("users", "TRUNCATE:");
+    EXPECT_EQ(truncate.operation, "TRUNCATE");
+    EXPECT_TRUE(truncate.is_whole_table());
+}
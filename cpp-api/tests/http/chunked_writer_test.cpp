@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "http/chunked_writer.hpp"
+#include <string>
+
+using namespace http;
+
+// Test 1: 小さなボディは1チャンクと終端チャンクになる
+TEST(ChunkedWriterTest, WritesChunkFraming) {
+    OutputBuffer output;
+    ChunkedWriter writer(output);
+
+    EXPECT_TRUE(writer.write("[1,"));
+    EXPECT_TRUE(writer.write("2]"));
+    EXPECT_TRUE(writer.finish());
+
+    EXPECT_EQ(output.to_string(), "5\r\n[1,2]\r\n0\r\n\r\n");
+}
+
+// Test 2: 一定量を超えると flush が呼ばれ、送信済みのデータは保持しない
+TEST(ChunkedWriterTest, FlushesLargeBodies) {
+    OutputBuffer output;
+    std::string sent;
+    int flushes = 0;
+    ChunkedWriter writer(output, [&](OutputBuffer& pending) {
+        ++flushes;
+        EXPECT_GE(pending.size(), ChunkedWriter::kFlushThreshold);
+        sent += pending.to_string();
+        pending.clear();
+        return true;
+    });
+
+    const std::string row(1000, 'x');
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(writer.write(row));
+        EXPECT_LT(output.size(), ChunkedWriter::kFlushThreshold + ChunkedWriter::kChunkSize + row.size() + 16);
+    }
+    ASSERT_TRUE(writer.finish());
+    sent += output.to_string();
+
+    EXPECT_GT(flushes, 0);
+    EXPECT_TRUE(sent.ends_with("\r\n0\r\n\r\n"));
+
+    // チャンクを解いて元のボディと一致することを確認
+    std::string body;
+    size_t pos = 0;
+    while (true) {
+        size_t line_end = sent.find("\r\n", pos);
+        ASSERT_NE(line_end, std::string::npos);
+        size_t size = std::stoul(sent.substr(pos, line_end - pos), nullptr, 16);
+        if (size == 0) {
+            break;
+        }
+        body += sent.substr(line_end + 2, size);
+        pos = line_end + 2 + size + 2;
+    }
+    EXPECT_EQ(body.size(), row.size() * 1000);
+}
+
+// Test 3: flush に失敗したら以降の書き込みを拒否する
+TEST(ChunkedWriterTest, StopsAfterFlushFailure) {
+    OutputBuffer output;
+    ChunkedWriter writer(output, [](OutputBuffer&) { return false; });
+
+    const std::string row(ChunkedWriter::kFlushThreshold, 'x');
+    EXPECT_FALSE(writer.write(row));
+    EXPECT_TRUE(writer.failed());
+    EXPECT_FALSE(writer.write("y"));
+    EXPECT_FALSE(writer.finish());
+}
+
+// Test 4: チャンク形式でない場合はボディをそのまま書き出す
+TEST(ChunkedWriterTest, WritesRawBodyWhenNotChunked) {
+    OutputBuffer output;
+    ChunkedWriter writer(output, {}, false);
+
+    EXPECT_TRUE(writer.write("[]"));
+    EXPECT_TRUE(writer.finish());
+
+    EXPECT_EQ(output.to_string(), "[]");
+}
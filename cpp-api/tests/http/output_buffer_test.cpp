@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "http/output_buffer.hpp"
+#include <memory>
+#include <string>
+
+using namespace http;
+
+// Test 1: 小さな所有データは1セグメントに連結される
+TEST(OutputBufferTest, CoalescesSmallSegments) {
+    OutputBuffer output;
+    output.append(std::string("HTTP/1.1 200 OK\r\n\r\n"));
+    output.append(std::string(R"({"status":"OK"})"));
+
+    EXPECT_EQ(output.segment_count(), 1u);
+    EXPECT_EQ(output.to_string(), "HTTP/1.1 200 OK\r\n\r\n{\"status\":\"OK\"}");
+}
+
+// Test 2: 共有ボディはコピーせずに参照される
+TEST(OutputBufferTest, SharedBodyIsNotCopied) {
+    auto body = std::make_shared<const std::string>(std::string(10000, 'x'));
+
+    OutputBuffer output;
+    output.append(std::string("header\r\n\r\n"));
+    output.append(body);
+
+    iovec iov[4];
+    ASSERT_EQ(output.fill_iovecs(iov, 4), 2u);
+    EXPECT_EQ(iov[1].iov_base, body->data());
+    EXPECT_EQ(iov[1].iov_len, body->size());
+    EXPECT_EQ(output.size(), 10u + body->size());
+}
+
+// Test 3: 部分書き込み後は続きから iovec を作る
+TEST(OutputBufferTest, ConsumeHandlesPartialWrites) {
+    auto body = std::make_shared<const std::string>("0123456789");
+
+    OutputBuffer output;
+    output.append(std::string("abc"));
+    output.append(body);
+    output.append(std::string("xyz"));
+
+    output.consume(5);
+    EXPECT_EQ(output.to_string(), "23456789xyz");
+
+    iovec iov[4];
+    ASSERT_EQ(output.fill_iovecs(iov, 4), 2u);
+    EXPECT_EQ(std::string(static_cast<char*>(iov[0].iov_base), iov[0].iov_len), "23456789");
+
+    output.consume(output.size());
+    EXPECT_TRUE(output.empty());
+    EXPECT_EQ(output.size(), 0u);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "http/query_params.hpp"
+#include "http/request_parser.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace http;
+
+// このテストバイナリ内のヒープ確保回数
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Test 1: 名前と値をパーセントデコードし、'=' のないパラメータは空の値になる
+TEST(QueryParamsTest, DecodesParameters) {
+    RequestArena arena;
+    QueryParams params("region=%E5%A5%88%E8%89%AF%E5%B8%82&sort=rating&q=a+b&flag&&bad=%zz", arena);
+
+    std::vector<std::pair<std::string, std::string>> all;
+    for (const auto& param : params) {
+        all.emplace_back(param.name, param.value);
+    }
+    ASSERT_EQ(all.size(), 5u);
+    EXPECT_EQ(all[0].second, "奈良市");
+    EXPECT_EQ(all[2].second, "a b");
+    EXPECT_EQ(all[3], (std::pair<std::string, std::string>{"flag", ""}));
+    EXPECT_EQ(all[4].second, "%zz");
+
+    EXPECT_EQ(params.find("sort"), "rating");
+    EXPECT_TRUE(params.contains("flag"));
+    EXPECT_FALSE(params.find("missing").has_value());
+}
+
+// Test 2: エンコードのない値は受信バッファをそのまま参照する
+TEST(QueryParamsTest, ReturnsViewsIntoQuery) {
+    std::string query = "lat=34.68&lng=135.80";
+    RequestArena arena;
+    QueryParams params(query, arena);
+
+    auto lat = params.find("lat");
+    ASSERT_TRUE(lat.has_value());
+    EXPECT_EQ(lat->data(), query.data() + 4);
+}
+
+// Test 3: 典型的なリクエストの解析とクエリの取り出しは（アリーナのウォームアップ後）ヒープを確保しない
+TEST(QueryParamsTest, ParsesTypicalRequestWithoutAllocating) {
+    std::string buffer =
+        "GET /api/shops?region=%E5%A5%88%E8%89%AF%E5%B8%82&minRating=4&sort=rating&limit=20 HTTP/1.1\r\n"
+        "Host: api.example.com\r\n"
+        "User-Agent: curl/8.0\r\n"
+        "Accept: application/json\r\n"
+        "\r\n";
+    RequestParser parser;
+    RequestArena arena;
+
+    for (int round = 0; round < 2; ++round) {
+        RequestArena::Scope scope(arena);
+
+        size_t before = g_allocations.load();
+        ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+        const auto& request = parser.request();
+        auto accept = request.header("accept");
+
+        QueryParams params(request.query, arena);
+        auto region = params.find("region");
+        auto limit = params.find("limit");
+        size_t after = g_allocations.load();
+
+        if (round == 1) {
+            EXPECT_EQ(after - before, 0u);
+        }
+        EXPECT_EQ(accept, "application/json");
+        EXPECT_EQ(region, "奈良市");
+        EXPECT_EQ(limit, "20");
+        parser.reset();
+    }
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "http/request_parser.hpp"
+#include <string>
+
+using namespace http;
+
+class RequestParserTest : public ::testing::Test {
+protected:
+    RequestParser parser;
+    std::string buffer;
+};
+
+// Test 1: ボディなしの GET リクエスト
+TEST_F(RequestParserTest, SimpleGet) {
+    buffer = "GET /api/shops?region=nara HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+
+    const auto& request = parser.request();
+    EXPECT_EQ(request.method, "GET");
+    EXPECT_EQ(request.target, "/api/shops?region=nara");
+    EXPECT_EQ(request.path, "/api/shops");
+    EXPECT_EQ(request.query, "region=nara");
+    EXPECT_EQ(request.header("host").value_or(""), "localhost");
+    EXPECT_TRUE(request.body.empty());
+    EXPECT_TRUE(request.keep_alive);
+    EXPECT_EQ(parser.consumed(), buffer.size());
+}
+
+// Test 2: 複数回に分かれて届くリクエスト（4KB を超えるボディ）
+TEST_F(RequestParserTest, BodySplitAcrossReads) {
+    std::string body = R"({"username":"test_user","bio":")" + std::string(9000, 'a') + R"("})";
+    std::string request = "POST /api/users HTTP/1.1\r\nContent-Length: " +
+                          std::to_string(body.size()) + "\r\n\r\n" + body;
+
+    // 1バイトずつ受信した場合も途中から再開できる
+    for (size_t i = 0; i < request.size() - 1; ++i) {
+        buffer.push_back(request[i]);
+        ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Incomplete);
+    }
+    buffer.push_back(request.back());
+
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+    EXPECT_EQ(parser.request().body, body);
+}
+
+// Test 3: チャンク転送エンコーディングはバッファ内でデコードされる
+TEST_F(RequestParserTest, ChunkedBody) {
+    buffer = "POST /api/users HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+             "5\r\nhello\r\n"
+             "7;ext=1\r\n, world\r\n"
+             "0\r\n"
+             "X-Trailer: ignored\r\n"
+             "\r\n";
+
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+    EXPECT_EQ(parser.request().body, "hello, world");
+    EXPECT_EQ(parser.consumed(), buffer.size());
+}
+
+// Test 4: チャンクの途中で区切られた受信
+TEST_F(RequestParserTest, ChunkedBodySplitAcrossReads) {
+    std::string request = "POST /api/users HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                          "a\r\n0123456789\r\n3\r\nabc\r\n0\r\n\r\n";
+
+    size_t split = request.find("01234") + 3;
+    buffer = request.substr(0, split);
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Incomplete);
+
+    buffer += request.substr(split);
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+    EXPECT_EQ(parser.request().body, "0123456789abc");
+}
+
+// Test 5: パイプライン化された複数リクエスト
+TEST_F(RequestParserTest, PipelinedRequests) {
+    buffer = "GET /health HTTP/1.1\r\n\r\n"
+             "POST /api/users HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"
+             "GET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n";
+
+    size_t offset = 0;
+
+    ASSERT_EQ(parser.parse(buffer, offset), ParseStatus::Complete);
+    EXPECT_EQ(parser.request().path, "/health");
+    offset += parser.consumed();
+    parser.reset();
+
+    ASSERT_EQ(parser.parse(buffer, offset), ParseStatus::Complete);
+    EXPECT_EQ(parser.request().method, "POST");
+    EXPECT_EQ(parser.request().body, "{}");
+    offset += parser.consumed();
+    parser.reset();
+
+    ASSERT_EQ(parser.parse(buffer, offset), ParseStatus::Complete);
+    EXPECT_EQ(parser.request().path, "/metrics");
+    EXPECT_FALSE(parser.request().keep_alive);
+    offset += parser.consumed();
+
+    EXPECT_EQ(offset, buffer.size());
+}
+
+// Test 6: 処理済みデータを削除してオフセットが変わっても再開できる
+TEST_F(RequestParserTest, ResumeAfterBufferCompaction) {
+    buffer = "GET /health HTTP/1.1\r\n\r\nPOST /api/users HTTP/1.1\r\nContent-Le";
+
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+    size_t offset = parser.consumed();
+    parser.reset();
+
+    ASSERT_EQ(parser.parse(buffer, offset), ParseStatus::Incomplete);
+
+    buffer.erase(0, offset);
+    buffer += "ngth: 3\r\n\r\nabc";
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+    EXPECT_EQ(parser.request().body, "abc");
+}
+
+// Test 7: HTTP/1.0 は明示しない限り keep-alive しない
+TEST_F(RequestParserTest, Http10KeepAlive) {
+    buffer = "GET /health HTTP/1.0\r\n\r\n";
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+    EXPECT_FALSE(parser.request().keep_alive);
+
+    parser.reset();
+    buffer = "GET /health HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n";
+    ASSERT_EQ(parser.parse(buffer, 0), ParseStatus::Complete);
+    EXPECT_TRUE(parser.request().keep_alive);
+}
+
+// Test 8: 不正なリクエストの拒否
+TEST_F(RequestParserTest, RejectsMalformedRequests) {
+    buffer = "GET /health\r\n\r\n";
+    EXPECT_EQ(parser.parse(buffer, 0), ParseStatus::Error);
+    EXPECT_EQ(parser.error_status(), 400);
+
+    parser.reset();
+    buffer = "GET /health HTTP/2.0\r\n\r\n";
+    EXPECT_EQ(parser.parse(buffer, 0), ParseStatus::Error);
+    EXPECT_EQ(parser.error_status(), 505);
+
+    parser.reset();
+    buffer = "POST /api/users HTTP/1.1\r\nContent-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n";
+    EXPECT_EQ(parser.parse(buffer, 0), ParseStatus::Error);
+    EXPECT_EQ(parser.error_status(), 400);
+
+    parser.reset();
+    buffer = "POST /api/users HTTP/1.1\r\nContent-Length: abc\r\n\r\n";
+    EXPECT_EQ(parser.parse(buffer, 0), ParseStatus::Error);
+}
+
+// Test 9: サイズ上限
+TEST_F(RequestParserTest, EnforcesSizeLimits) {
+    RequestParser small_parser(64, 16);
+
+    buffer = "GET /" + std::string(100, 'a') + " HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(small_parser.parse(buffer, 0), ParseStatus::Error);
+    EXPECT_EQ(small_parser.error_status(), 431);
+
+    small_parser.reset();
+    buffer = "POST /api/users HTTP/1.1\r\nContent-Length: 17\r\n\r\n";
+    EXPECT_EQ(small_parser.parse(buffer, 0), ParseStatus::Error);
+    EXPECT_EQ(small_parser.error_status(), 413);
+}
+
+// Test 10: 桁あふれするチャンクサイズと大量のトレーラー行も上限で拒否
+TEST_F(RequestParserTest, RejectsOversizedChunksAndTrailers) {
+    RequestParser small_parser(64, 16);
+
+    buffer = "POST /api/users HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+             "4\r\nabcd\r\nFFFFFFFFFFFFFFFF\r\n";
+    EXPECT_EQ(small_parser.parse(buffer, 0), ParseStatus::Error);
+    EXPECT_EQ(small_parser.error_status(), 413);
+
+    // 1行ずつは短くても、トレーラー部全体が上限を超えれば拒否
+    small_parser.reset();
+    buffer = "POST /api/users HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n";
+    for (int i = 0; i < 10; ++i) {
+        buffer += "X-Trailer: 0123456789\r\n";
+    }
+    EXPECT_EQ(small_parser.parse(buffer, 0), ParseStatus::Error);
+    EXPECT_EQ(small_parser.error_status(), 431);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "importer/shop_import.hpp"
+
+using namespace importer;
+
+// Test 1: shops.json と同じ形の JSON を読み、任意項目の欠落は NULL にする
+TEST(ShopImportTest, ParsesJsonShops) {
+    auto parsed = parse_shops_json(R"([
+        {"id": "1", "name": "菩薩咖喱", "address": "奈良県奈良市薬師堂町21",
+         "latitude": 34.6775, "longitude": 135.8328, "region": "奈良市",
+         "spiceParameters": {"spiciness": 60, "stimulation": 45, "aroma": 85},
+         "rating": 4.6, "description": "ダルバート専門店"},
+        {"id": 2, "name": "ハチノス", "address": "奈良県奈良市南市町8-1",
+         "latitude": 34.6755, "longitude": 135.8312, "region": "奈良市", "phone": ""}
+    ])");
+
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_TRUE(parsed->rejected.empty());
+    ASSERT_EQ(parsed->shops.size(), 2u);
+
+    const auto& first = parsed->shops[0];
+    EXPECT_EQ(first.id, "1");
+    EXPECT_EQ(first.spice_params.aroma, 85);
+    EXPECT_DOUBLE_EQ(first.rating, 4.6);
+    EXPECT_EQ(first.description, "ダルバート専門店");
+    EXPECT_FALSE(first.phone.has_value());
+
+    const auto& second = parsed->shops[1];
+    EXPECT_EQ(second.id, "2");
+    EXPECT_EQ(second.spice_params.spiciness, 50);
+    EXPECT_FALSE(second.phone.has_value());
+}
+
+// Test 2: CSV は引用符内のカンマ・改行・"" を扱い、列の順序はヘッダーで決まる
+TEST(ShopImportTest, ParsesCsvWithQuotedFields) {
+    auto parsed = parse_shops_csv(
+        "\xEF\xBB\xBFregion,id,name,address,latitude,longitude,rating,description\r\n"
+        "奈良市,10,\"Curry \"\"A\"\"\",\"奈良市1, 2階\",34.68,135.80,4.5,\"辛い!\n本格派\"\r\n"
+        "\r\n"
+        "生駒市,11,B,生駒市2,34.69,135.70,,\n"
+    );
+
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_TRUE(parsed->rejected.empty());
+    ASSERT_EQ(parsed->shops.size(), 2u);
+
+    const auto& first = parsed->shops[0];
+    EXPECT_EQ(first.id, "10");
+    EXPECT_EQ(first.name, "Curry \"A\"");
+    EXPECT_EQ(first.address, "奈良市1, 2階");
+    EXPECT_EQ(first.region, "奈良市");
+    EXPECT_EQ(first.description, "辛い!\n本格派");
+
+    EXPECT_DOUBLE_EQ(parsed->shops[1].rating, 0.0);
+    EXPECT_FALSE(parsed->shops[1].description.has_value());
+}
+
+// Test 3: 制約に反する行・数値でない値・重複した id は理由とともに除外する
+TEST(ShopImportTest, RejectsInvalidRows) {
+    auto parsed = parse_shops_csv(
+        "id,name,address,latitude,longitude,region,spiciness,rating\n"
+        "1,A,addr,34.6,135.8,奈良市,60,4.0\n"
+        "2,B,addr,95.0,135.8,奈良市,60,4.0\n"
+        "3,C,addr,34.6,135.8,奈良市,120,4.0\n"
+        "4,D,addr,north,135.8,奈良市,60,4.0\n"
+        "1,E,addr,34.6,135.8,奈良市,60,4.0\n"
+        "5,F,addr,34.6,135.8,,60,4.0\n"
+    );
+
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ(parsed->shops.size(), 1u);
+    EXPECT_EQ(parsed->shops[0].id, "1");
+
+    ASSERT_EQ(parsed->rejected.size(), 5u);
+    EXPECT_NE(parsed->rejected[0].find("line 3"), std::string::npos);
+    EXPECT_NE(parsed->rejected[2].find("latitude is not a number"), std::string::npos);
+    EXPECT_NE(parsed->rejected[3].find("duplicate id 1"), std::string::npos);
+}
+
+// Test 4: 入力全体が読めないときはエラー
+TEST(ShopImportTest, FailsOnMalformedInput) {
+    EXPECT_FALSE(parse_shops_json("{\"id\": 1}").has_value());
+    EXPECT_FALSE(parse_shops_json("[").has_value());
+    EXPECT_FALSE(parse_shops_csv("id,name\n1,A\n").has_value());
+    EXPECT_FALSE(parse_shops_csv("").has_value());
+
+    EXPECT_EQ(format_from_path("shops.json"), InputFormat::Json);
+    EXPECT_EQ(format_from_path("data/nara.csv"), InputFormat::Csv);
+    EXPECT_FALSE(format_from_path("shops.txt").has_value());
+}
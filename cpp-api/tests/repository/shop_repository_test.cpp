@@ -265,3 +265,68 @@ TEST_F(ShopRepositoryTest, TransactionRollback) {
     // Note: トランザクション対応のリポジトリメソッドが必要
     // ここでは基本的なテストのみ
 }
+
+// Test 11: 検索条件はパラメータ化された1つの SQL に変換される
+TEST(ShopQueryCompileTest, CompilesParameterizedSql) {
+    ShopQuery query;
+    query.region = "奈良市";
+    query.rating.min = 4.0;
+    query.spiciness = {30, 80};
+    query.sort = ShopSort::RatingDesc;
+    query.limit = 20;
+
+    auto compiled = PostgresShopRepository::compile_query(query);
+    EXPECT_NE(compiled.sql.find("WHERE region = $1 AND rating >= $2 AND spiciness >= $3 AND spiciness <= $4"),
+              std::string::npos);
+    EXPECT_NE(compiled.sql.find("ORDER BY rating DESC"), std::string::npos);
+    EXPECT_TRUE(compiled.sql.ends_with("LIMIT $5"));
+    EXPECT_EQ(compiled.params, (std::vector<std::string>{"奈良市", "4", "30", "80", "20"}));
+
+    auto all = PostgresShopRepository::compile_query(ShopQuery{});
+    EXPECT_EQ(all.sql.find("WHERE"), std::string::npos);
+    EXPECT_TRUE(all.params.empty());
+}
+
+// Test 12: 検索条件による絞り込みと並べ替え
+TEST_F(ShopRepositoryTest, FindMatching) {
+    for (auto [suffix, rating, spiciness] : {std::tuple{" Query A", 4.8, 90}, {" Query B", 3.2, 85}, {" Query C", 4.1, 20}}) {
+        auto shop = create_test_shop(suffix);
+        shop.rating = rating;
+        shop.spice_params.spiciness = spiciness;
+        ASSERT_TRUE(repository->add(shop).has_value());
+    }
+
+    auto postgres_repo = dynamic_cast<PostgresShopRepository*>(repository.get());
+    ASSERT_NE(postgres_repo, nullptr);
+
+    ShopQuery query;
+    query.rating.min = 4.0;
+    query.spiciness.min = 50;
+    query.sort = ShopSort::RatingDesc;
+    query.bounds = BoundingBox{34.6, 135.7, 34.7, 135.9};
+
+    auto result = postgres_repo->find_matching(query);
+    ASSERT_TRUE(result.has_value());
+
+    std::vector<std::string> names;
+    for (const auto& shop : result.value()) {
+        EXPECT_TRUE(query.matches(shop));
+        if (shop.name.starts_with("Test Shop Query")) {
+            names.push_back(shop.name);
+        }
+    }
+    EXPECT_EQ(names, std::vector<std::string>{"Test Shop Query A"});
+}
+
+// Test 13: カーソルは並び替えキーと id のキーセット条件になる
+TEST(ShopQueryCompileTest, CompilesKeysetCursor) {
+    ShopQuery query;
+    query.sort = ShopSort::RatingDesc;
+    query.limit = 10;
+    query.after = ShopCursor{ShopSort::RatingDesc, 4.5, 0, "", "shop-42"};
+
+    auto compiled = PostgresShopRepository::compile_query(query);
+    EXPECT_NE(compiled.sql.find("WHERE rating <= $2 AND (rating < $2 OR id > $1)"), std::string::npos);
+    EXPECT_NE(compiled.sql.find("ORDER BY rating DESC, id LIMIT $3"), std::string::npos);
+    EXPECT_EQ(compiled.params, (std::vector<std::string>{"shop-42", "4.5", "10"}));
+}
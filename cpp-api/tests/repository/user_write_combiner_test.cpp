@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "repository/user_write_combiner.hpp"
+#include <atomic>
+#include <future>
+#include <latch>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace repository;
+
+namespace {
+
+// 受け取ったバッチを記録し、username が "dup" で始まる行を重複として返す書き込み関数
+struct FakeInserter {
+    std::mutex mutex;
+    std::vector<size_t> batch_sizes;
+    std::atomic<int> next_id{1};
+
+    std::vector<std::expected<domain::User, std::string>> insert(std::span<const domain::User> users) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch_sizes.push_back(users.size());
+        }
+        std::vector<std::expected<domain::User, std::string>> results;
+        for (const auto& user : users) {
+            if (user.username.starts_with("dup")) {
+                results.push_back(std::unexpected("User already exists"));
+                continue;
+            }
+            domain::User inserted = user;
+            inserted.id = std::to_string(next_id.fetch_add(1));
+            results.push_back(inserted);
+        }
+        return results;
+    }
+};
+
+domain::User make_user(const std::string& username) {
+    return domain::User("", username, username + "@example.com");
+}
+
+// 最初のバッチの書き込みを止め、その間に届いた登録を次のバッチへためる
+struct GatedInserter : FakeInserter {
+    std::promise<void> entered;
+    std::shared_future<void> released;
+    bool first = true;
+
+    explicit GatedInserter(std::shared_future<void> release) : released(std::move(release)) {}
+
+    std::vector<std::expected<domain::User, std::string>> insert(std::span<const domain::User> users) {
+        if (std::exchange(first, false)) {
+            entered.set_value();
+            released.wait();
+        }
+        return FakeInserter::insert(users);
+    }
+};
+
+// insert() の sender を開始し、完了したら results へ格納して done を減らす
+void start_insert(UserWriteCombiner& combiner, std::expected<domain::User, std::string> user,
+                  std::expected<domain::User, std::string>& result, std::latch& done) {
+    stdexec::start_detached(
+        combiner.insert(std::move(user))
+        | stdexec::then([&result, &done](std::expected<domain::User, std::string> inserted) {
+              result = std::move(inserted);
+              done.count_down();
+          })
+    );
+}
+
+} // namespace
+
+// Test 1: 書き込み中に届いた登録は次の1回の書き込みにまとめられる
+TEST(UserWriteCombinerTest, CombinesRegistrationsArrivingDuringWrite) {
+    std::promise<void> release;
+    GatedInserter inserter(release.get_future().share());
+    // 完了の通知は書き込みスレッドから届くため、combiner より先に破棄しない
+    std::vector<std::expected<domain::User, std::string>> results(9);
+    std::latch done(9);
+    UserWriteCombiner combiner(
+        [&inserter](std::span<const domain::User> users) { return inserter.insert(users); },
+        WriteCombinerOptions{64}
+    );
+
+    start_insert(combiner, make_user("first"), results[0], done);
+    inserter.entered.get_future().wait();
+
+    // 開始した時点でキューに入る（呼び出し元は待たない）
+    for (int i = 1; i < 9; ++i) {
+        start_insert(combiner, make_user("user" + std::to_string(i)), results[i], done);
+    }
+    release.set_value();
+    done.wait();
+
+    for (const auto& result : results) {
+        ASSERT_TRUE(result.has_value());
+        EXPECT_FALSE(result->id.empty());
+    }
+    ASSERT_EQ(inserter.batch_sizes.size(), 2u);
+    EXPECT_EQ(inserter.batch_sizes[0], 1u);
+    EXPECT_EQ(inserter.batch_sizes[1], 8u);
+
+    auto metrics = combiner.metrics();
+    EXPECT_EQ(metrics.batches, 2u);
+    EXPECT_EQ(metrics.rows, 9u);
+    EXPECT_EQ(metrics.max_batch, 8u);
+}
+
+// Test 2: 書き込みスレッドが空いていれば1件でも待たずに書き込まれる
+TEST(UserWriteCombinerTest, WritesImmediatelyWhenIdle) {
+    FakeInserter inserter;
+    UserWriteCombiner combiner(
+        [&inserter](std::span<const domain::User> users) { return inserter.insert(users); }
+    );
+
+    auto result = combiner.add(make_user("alone"));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->username, "alone");
+    EXPECT_FALSE(result->id.empty());
+    EXPECT_EQ(combiner.metrics().batches, 1u);
+}
+
+// Test 3: 行ごとの失敗はその行の呼び出し元だけに返る
+TEST(UserWriteCombinerTest, RoutesPerRowErrorsToCallers) {
+    FakeInserter inserter;
+    UserWriteCombiner combiner(
+        [&inserter](std::span<const domain::User> users) { return inserter.insert(users); },
+        WriteCombinerOptions{4}
+    );
+
+    std::vector<std::string> usernames{"alice", "dup_bob", "carol", "dave"};
+    std::vector<std::expected<domain::User, std::string>> results(usernames.size());
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < usernames.size(); ++i) {
+        threads.emplace_back([&, i] { results[i] = combiner.add(make_user(usernames[i])); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < usernames.size(); ++i) {
+        if (usernames[i] == "dup_bob") {
+            ASSERT_FALSE(results[i].has_value());
+            EXPECT_EQ(results[i].error(), "User already exists");
+        } else {
+            ASSERT_TRUE(results[i].has_value()) << usernames[i];
+            EXPECT_EQ(results[i]->username, usernames[i]);
+        }
+    }
+}
+
+// Test 4: 書き込み関数が例外を投げてもバッチ全員にエラーを返して処理を続ける
+TEST(UserWriteCombinerTest, SurvivesInsertFailure) {
+    std::atomic<int> calls{0};
+    UserWriteCombiner combiner(
+        [&calls](std::span<const domain::User> users) -> std::vector<std::expected<domain::User, std::string>> {
+            if (calls.fetch_add(1) == 0) {
+                throw std::runtime_error("connection lost");
+            }
+            return {users.begin(), users.end()};
+        },
+        WriteCombinerOptions{64}
+    );
+
+    EXPECT_FALSE(combiner.add(make_user("first")).has_value());
+    EXPECT_TRUE(combiner.add(make_user("second")).has_value());
+}
+
+// Test 5: ためた登録は max_batch 件ずつに分けて書き込まれる
+TEST(UserWriteCombinerTest, SplitsBacklogByMaxBatch) {
+    std::promise<void> release;
+    GatedInserter inserter(release.get_future().share());
+    // 完了の通知は書き込みスレッドから届くため、combiner より先に破棄しない
+    std::vector<std::expected<domain::User, std::string>> results(6);
+    std::latch done(6);
+    UserWriteCombiner combiner(
+        [&inserter](std::span<const domain::User> users) { return inserter.insert(users); },
+        WriteCombinerOptions{2}
+    );
+
+    start_insert(combiner, make_user("first"), results[0], done);
+    inserter.entered.get_future().wait();
+    for (int i = 1; i < 6; ++i) {
+        start_insert(combiner, make_user("user" + std::to_string(i)), results[i], done);
+    }
+    release.set_value();
+    done.wait();
+
+    EXPECT_EQ(inserter.batch_sizes, (std::vector<size_t>{1, 2, 2, 1}));
+}
+
+// Test 6: 検証エラーは書き込まずにそのまま返り、停止後の登録はエラーになる
+TEST(UserWriteCombinerTest, RejectsInvalidAndStoppedRegistrations) {
+    FakeInserter inserter;
+    UserWriteCombiner combiner(
+        [&inserter](std::span<const domain::User> users) { return inserter.insert(users); }
+    );
+
+    auto [rejected] = stdexec::sync_wait(combiner.insert(std::unexpected(std::string("Invalid JSON")))).value();
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error(), "Invalid JSON");
+    EXPECT_EQ(combiner.metrics().batches, 0u);
+
+    combiner.stop();
+    EXPECT_FALSE(combiner.add(make_user("late")).has_value());
+    EXPECT_TRUE(inserter.batch_sizes.empty());
+}
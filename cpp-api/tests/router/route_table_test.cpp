@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "router/routes.hpp"
+
+using namespace router;
+
+// ルーティング表はコンパイル時に構築・照合できる
+static_assert(kRouteTable.match(Method::Get, "/health").id == RouteId::Health);
+static_assert(kRouteTable.match(Method::Get, "/api/shops/nearby").id == RouteId::GetNearbyShops);
+
+// Test 1: リテラルのセグメントはパラメータより優先される
+TEST(RouteTableTest, PrefersLiteralSegments) {
+    EXPECT_EQ(kRouteTable.match(Method::Get, "/api/shops").id, RouteId::GetShops);
+    EXPECT_EQ(kRouteTable.match(Method::Get, "/api/shops/export").id, RouteId::ExportShops);
+
+    auto match = kRouteTable.match(Method::Get, "/api/shops/shop-123");
+    EXPECT_EQ(match.id, RouteId::GetShopById);
+    ASSERT_EQ(match.param_count, 1u);
+    EXPECT_EQ(match.param(0), "shop-123");
+}
+
+// Test 2: 型付きパラメータと入れ子のパス
+TEST(RouteTableTest, MatchesTypedParameters) {
+    auto recommendations = kRouteTable.match(Method::Get, "/api/users/42/recommendations");
+    EXPECT_EQ(recommendations.id, RouteId::GetRecommendations);
+    EXPECT_EQ(recommendations.param(0), "42");
+
+    EXPECT_EQ(kRouteTable.match(Method::Get, "/api/users/42").id, RouteId::GetUserById);
+    EXPECT_EQ(kRouteTable.match(Method::Get, "/api/users/abc").id, RouteId::None);
+    EXPECT_EQ(kRouteTable.match(Method::Get, "/api/users/").id, RouteId::None);
+    EXPECT_EQ(kRouteTable.match(Method::Get, "/api/shops/a/b").id, RouteId::None);
+    EXPECT_EQ(kRouteTable.match(Method::Get, "/").id, RouteId::None);
+    EXPECT_EQ(kRouteTable.match(Method::Get, "").id, RouteId::None);
+}
+
+// Test 3: パスが一致してメソッドが異なる場合は 405 用に区別する
+TEST(RouteTableTest, DistinguishesMethodMismatch) {
+    EXPECT_EQ(kRouteTable.match(Method::Post, "/api/users").id, RouteId::PostUser);
+
+    auto wrong_method = kRouteTable.match(Method::Delete, "/api/users");
+    EXPECT_EQ(wrong_method.id, RouteId::None);
+    EXPECT_TRUE(wrong_method.path_matched);
+
+    auto unknown = kRouteTable.match(parse_method("BREW"), "/health");
+    EXPECT_EQ(unknown.id, RouteId::None);
+    EXPECT_TRUE(unknown.path_matched);
+
+    EXPECT_FALSE(kRouteTable.match(Method::Get, "/nope").path_matched);
+}
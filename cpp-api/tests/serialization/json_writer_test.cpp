@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "serialization/json_writer.hpp"
+#include "serialization/domain_json.hpp"
+#include <limits>
+#include <string>
+
+using namespace serialization;
+
+namespace {
+
+std::string escaped(std::string_view s) {
+    std::string out;
+    append_escaped(out, s);
+    return out;
+}
+
+} // namespace
+
+// Test 1: 引用符・バックスラッシュ・制御文字をエスケープし、UTF-8 はそのまま書く
+TEST(JsonWriterTest, EscapesStrings) {
+    EXPECT_EQ(escaped(R"(say "hi")"), R"(say \"hi\")");
+    EXPECT_EQ(escaped("a\\b"), R"(a\\b)");
+    EXPECT_EQ(escaped("line1\nline2\ttab\r"), R"(line1\nline2\ttab\r)");
+    EXPECT_EQ(escaped(std::string_view("\x01\x1f", 2)), R"(\u0001\u001f)");
+    EXPECT_EQ(escaped(std::string_view("nul\0", 4)), R"(nul\u0000)");
+    EXPECT_EQ(escaped("奈良のカレー"), "奈良のカレー");
+}
+
+// Test 2: SIMD の区切り（16/32 バイト）をまたいでも全位置の特殊文字を検出する
+TEST(JsonWriterTest, EscapesAcrossVectorBoundaries) {
+    for (size_t length : {15u, 16u, 17u, 31u, 32u, 33u, 64u, 100u}) {
+        for (size_t pos = 0; pos < length; ++pos) {
+            std::string input(length, 'x');
+            input[pos] = '"';
+            std::string expected = input.substr(0, pos) + "\\\"" + input.substr(pos + 1);
+            EXPECT_EQ(escaped(input), expected) << "length=" << length << " pos=" << pos;
+        }
+    }
+    // 0x80 以上（UTF-8 の後続バイト）は制御文字として扱わない
+    std::string high(40, static_cast<char>(0xE3));
+    EXPECT_EQ(escaped(high), high);
+}
+
+// Test 3: カンマはネストごとに挿入され、数値は最短表記・非有限は null
+TEST(JsonWriterTest, WritesNestedStructures) {
+    std::string json;
+    JsonWriter writer(json);
+    writer.begin_object()
+        .key("a").value(1)
+        .key("b").begin_array().value(1.5).value("x").null().begin_object().end_object().end_array()
+        .key("c").value(true)
+        .key("d").value(std::numeric_limits<double>::infinity())
+        .key("e").fixed(3.14159, 2)
+        .key("f").raw(R"({"k":0})")
+    .end_object();
+
+    EXPECT_EQ(json, R"({"a":1,"b":[1.5,"x",null,{}],"c":true,"d":null,"e":3.14,"f":{"k":0}})");
+}
+
+// Test 4: 店舗の JSON は従来の項目を保ちつつ説明文をエスケープする
+TEST(JsonWriterTest, WritesShopWithEscapedText) {
+    domain::Shop shop("1", "Curry \"A\"", "奈良市1", std::nullopt, 34.68, 135.8, "奈良市",
+                      domain::SpiceParameters(80, 60, 70), 4.5, "辛い!\n本格派");
+    std::string json;
+    JsonWriter writer(json);
+    write_shop(writer, shop);
+
+    EXPECT_EQ(json,
+              R"({"id":"1","name":"Curry \"A\"","address":"奈良市1","phone":"","latitude":34.68,"longitude":135.8,)"
+              R"("region":"奈良市","spiceParameters":{"spiciness":80,"stimulation":60,"aroma":70},)"
+              R"("rating":4.5,"description":"辛い!\n本格派","image_url":""})");
+}
+
+// Test 5: ユーザーのプロフィールは User の項目にお気に入り・苦手な店舗の ID を加える
+TEST(JsonWriterTest, WritesUserProfile) {
+    domain::UserProfile profile;
+    profile.user = domain::User("7", "spice_lover", "user@example.com");
+    profile.favorite_shop_ids = {"1", "2"};
+
+    std::string json;
+    JsonWriter writer(json);
+    write_user_profile(writer, profile);
+
+    EXPECT_EQ(json,
+              R"({"id":"7","username":"spice_lover","email":"user@example.com",)"
+              R"("spiciness":50,"stimulation":50,"aroma":50,)"
+              R"("favoriteShopIds":["1","2"],"dislikedShopIds":[]})");
+}
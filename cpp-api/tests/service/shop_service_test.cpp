@@ -0,0 +1,328 @@
+#include <gtest/gtest.h>
+#include "service/shop_service.hpp"
+#include <atomic>
+#include <format>
+
+using namespace domain;
+using namespace repository;
+using namespace service;
+
+// find_all の呼び出し回数を数えるインメモリのリポジトリ
+class FakeShopRepository : public IRepository<Shop> {
+public:
+    std::vector<Shop> shops;
+    std::atomic<int> find_all_calls{0};
+    bool unavailable = false;
+
+    std::expected<std::vector<Shop>, std::string> find_all() override {
+        find_all_calls++;
+        if (unavailable) {
+            return std::unexpected("snapshot load failed");
+        }
+        return shops;
+    }
+    std::expected<std::optional<Shop>, std::string> find_by_id(const std::string& id) override {
+        for (const auto& shop : shops) {
+            if (shop.id == id) {
+                return shop;
+            }
+        }
+        return std::nullopt;
+    }
+    std::expected<Shop, std::string> add(const Shop& entity) override { return entity; }
+    std::expected<Shop, std::string> update(const Shop& entity) override { return entity; }
+    std::expected<bool, std::string> remove(const std::string&) override { return false; }
+};
+
+// find_matching を ShopQuery の評価で代用し、受け取った条件を記録するリポジトリ
+class FakeShopQueryRepository : public IShopQueryRepository {
+public:
+    std::vector<Shop> shops;
+    std::vector<ShopQuery> queries;
+
+    std::expected<std::vector<Shop>, std::string> find_matching(const ShopQuery& query) override {
+        queries.push_back(query);
+        std::vector<Shop> matched;
+        for (const auto& shop : shops) {
+            if (query.matches(shop)) {
+                matched.push_back(shop);
+            }
+        }
+        std::ranges::sort(matched, [&query](const Shop& a, const Shop& b) { return query.before(a, b); });
+        if (query.limit && matched.size() > *query.limit) {
+            matched.resize(*query.limit);
+        }
+        return matched;
+    }
+};
+
+class ShopServiceTest : public ::testing::Test {
+protected:
+    std::shared_ptr<FakeShopRepository> repository = std::make_shared<FakeShopRepository>();
+
+    void SetUp() override {
+        repository->shops = {
+            Shop("1", "Curry A", "奈良市1", std::nullopt, 34.68, 135.80, "奈良市", SpiceParameters(80, 60, 70), 4.5),
+            Shop("2", "Curry B", "奈良市2", std::nullopt, 34.69, 135.81, "奈良市", SpiceParameters(30, 20, 90), 4.0),
+        };
+    }
+};
+
+// Test 1: 繰り返しの取得ではリポジトリを再読み込みせず同じバッファを返す
+TEST_F(ShopServiceTest, ServesAllShopsFromSnapshot) {
+    ShopService service(repository);
+
+    auto first = service.get_all_shops_shared_json();
+    auto second = service.get_all_shops_shared_json();
+
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(first.value(), second.value());
+    EXPECT_EQ(repository->find_all_calls, 1);
+    EXPECT_NE(first.value()->find(R"("id":"1")"), std::string::npos);
+    EXPECT_NE(first.value()->find(R"("id":"2")"), std::string::npos);
+}
+
+// Test 2: ID検索は店舗ごとの JSON 断片を返す
+TEST_F(ShopServiceTest, FindsShopFragmentById) {
+    ShopService service(repository);
+
+    auto shop = service.get_shop_by_id_json("2");
+    ASSERT_TRUE(shop.has_value());
+    EXPECT_TRUE(shop.value().starts_with(R"({"id":"2","name":"Curry B")"));
+
+    EXPECT_FALSE(service.get_shop_by_id_json("999").has_value());
+}
+
+// Test 3: refresh_snapshot で新しいスナップショットに差し替わり、古い参照は有効なまま
+TEST_F(ShopServiceTest, RefreshSwapsSnapshot) {
+    ShopService service(repository);
+
+    auto before = service.get_all_shops_shared_json().value();
+
+    repository->shops.pop_back();
+    ASSERT_TRUE(service.refresh_snapshot().has_value());
+
+    auto after = service.get_all_shops_shared_json().value();
+    EXPECT_NE(before, after);
+    EXPECT_NE(before->find(R"("id":"2")"), std::string::npos);
+    EXPECT_EQ(after->find(R"("id":"2")"), std::string::npos);
+}
+
+// Test 4: 変更された店舗だけを読み直す
+TEST_F(ShopServiceTest, RefreshShopsAppliesRowChanges) {
+    ShopService service(repository);
+    ASSERT_TRUE(service.get_snapshot().has_value());
+
+    repository->shops[0].name = "Curry A2";
+    repository->shops.push_back(
+        Shop("3", "Curry C", "奈良市3", std::nullopt, 34.70, 135.82, "奈良市", SpiceParameters(50, 50, 50), 3.5)
+    );
+
+    ASSERT_TRUE(service.refresh_shops({"1", "3"}).has_value());
+    EXPECT_EQ(repository->find_all_calls, 1);
+
+    auto snapshot = service.get_snapshot().value();
+    ASSERT_EQ(snapshot->shops.size(), 3u);
+    EXPECT_NE(snapshot->all_json->find("Curry A2"), std::string::npos);
+    EXPECT_NE(snapshot->find_index("3"), snapshot->shops.size());
+}
+
+// Test 5: 推薦は好みに近い順で、評価と位置で絞り込める
+TEST_F(ShopServiceTest, RecommendsByPreferences) {
+    repository->shops.push_back(
+        Shop("3", "Curry C", "大阪市1", std::nullopt, 34.70, 135.50, "大阪市", SpiceParameters(78, 62, 70), 3.0));
+    ShopService service(repository);
+
+    RecommendationQuery query;
+    query.preferences = UserPreferences(80, 60, 70);
+
+    auto all = service.recommend_shops_json(query);
+    ASSERT_TRUE(all.has_value());
+    EXPECT_TRUE(all.value().starts_with(R"([{"matchScore":100,"spiceDistance":0.00,"shop":{"id":"1")"));
+    EXPECT_LT(all.value().find(R"("id":"3")"), all.value().find(R"("id":"2")"));
+
+    query.min_rating = 4.2;
+    auto rated = service.recommend_shops_json(query).value();
+    EXPECT_NE(rated.find(R"("id":"1")"), std::string::npos);
+    EXPECT_EQ(rated.find(R"("id":"2")"), std::string::npos);
+    EXPECT_EQ(rated.find(R"("id":"3")"), std::string::npos);
+
+    // 大阪周辺 5km では店舗 3 だけ（距離付き）
+    query.min_rating = 0.0;
+    query.near = RecommendationQuery::Near{34.70, 135.50, 5.0};
+    auto nearby = service.recommend_shops_json(query).value();
+    EXPECT_NE(nearby.find(R"("distanceKm":0.000,"shop":{"id":"3")"), std::string::npos);
+    EXPECT_EQ(nearby.find(R"("id":"1")"), std::string::npos);
+}
+
+// Test 6: 条件なしは全店舗の JSON を共有し、条件付きはスナップショット上で絞り込む
+TEST_F(ShopServiceTest, QueriesSnapshot) {
+    ShopService service(repository);
+
+    auto all = service.query_shops_shared_json(ShopQuery{});
+    ASSERT_TRUE(all.has_value());
+    EXPECT_EQ(all.value(), service.get_all_shops_shared_json().value());
+
+    ShopQuery query;
+    query.aroma.min = 80;
+    auto aromatic = service.query_shops_shared_json(query).value();
+    EXPECT_EQ(aromatic->find(R"("id":"1")"), std::string::npos);
+    EXPECT_NE(aromatic->find(R"("id":"2")"), std::string::npos);
+
+    query = ShopQuery{};
+    query.sort = ShopSort::RatingDesc;
+    query.limit = 1;
+    auto top = service.query_shops_shared_json(query).value();
+    EXPECT_TRUE(top->starts_with(R"([{"id":"1")"));
+    EXPECT_EQ(top->find(R"("id":"2")"), std::string::npos);
+}
+
+// Test 7: カーソルで全ページを辿ると重複・欠落なく並び順どおりに取得できる
+TEST_F(ShopServiceTest, PaginatesWithCursor) {
+    for (int i = 0; i < 9; ++i) {
+        repository->shops.push_back(Shop(std::format("p{}", i), "Curry P", "奈良市", std::nullopt,
+                                         34.68, 135.80, "奈良市", SpiceParameters(50, 50, 50), 3.0 + (i % 3) * 0.5));
+    }
+    ShopService service(repository);
+
+    ShopQuery query;
+    query.sort = ShopSort::RatingDesc;
+    query.limit = 4;
+
+    std::string all;
+    size_t pages = 0;
+    while (true) {
+        auto page = service.query_shops_page(query);
+        ASSERT_TRUE(page.has_value());
+        all += *page.value().json;
+        pages++;
+        if (!page.value().next_cursor) {
+            break;
+        }
+        auto cursor = decode_shop_cursor(*page.value().next_cursor);
+        ASSERT_TRUE(cursor.has_value());
+        query.after = cursor.value();
+    }
+
+    EXPECT_EQ(pages, 3u);
+    for (const auto* id : {"\"1\"", "\"2\"", "\"p0\"", "\"p8\""}) {
+        auto first = all.find(id);
+        ASSERT_NE(first, std::string::npos) << id;
+        EXPECT_EQ(all.find(id, first + 1), std::string::npos) << id;
+    }
+    // 評価 4.5 の店舗 1 が最初、同評価は id 順
+    EXPECT_TRUE(all.starts_with(R"([{"id":"1")"));
+    EXPECT_LT(all.find(R"("id":"p2")"), all.find(R"("id":"p5")"));
+
+    EXPECT_FALSE(decode_shop_cursor("!!").has_value());
+    auto name_cursor = ShopCursor::from(repository->shops[0], ShopSort::Name);
+    EXPECT_EQ(decode_shop_cursor(encode_shop_cursor(name_cursor)).value().name, "Curry A");
+}
+
+// Test 8: ストリーミング出力は全店舗の JSON 配列になり、打ち切りはエラーになる
+TEST_F(ShopServiceTest, StreamsAllShops) {
+    ShopService service(repository);
+
+    std::string json;
+    auto result = service.stream_all_shops_json([&json](std::string_view part) {
+        json += part;
+        return true;
+    });
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(json.starts_with(R"([{"id":"1")"));
+    EXPECT_NE(json.find(R"(},{"id":"2")"), std::string::npos);
+    EXPECT_TRUE(json.ends_with("}]"));
+
+    int parts = 0;
+    auto aborted = service.stream_all_shops_json([&parts](std::string_view) { return ++parts < 2; });
+    EXPECT_FALSE(aborted.has_value());
+    EXPECT_EQ(parts, 2);
+}
+
+// Test 9: 一時領域は渡したアリーナから確保され、結果はデフォルトのリソースと同じになる
+TEST_F(ShopServiceTest, UsesArenaForTemporaries) {
+    // 確保回数を数えるだけの上流リソース
+    struct CountingResource : std::pmr::memory_resource {
+        int allocations = 0;
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+    ShopService service(repository);
+
+    ShopQuery query;
+    query.sort = ShopSort::RatingDesc;
+    query.limit = 1;
+
+    CountingResource upstream;
+    std::pmr::monotonic_buffer_resource arena(&upstream);
+    auto page = service.query_shops_page(query, &arena);
+    ASSERT_TRUE(page.has_value());
+    EXPECT_GT(upstream.allocations, 0);
+    EXPECT_EQ(*page.value().json, *service.query_shops_page(query).value().json);
+
+    auto nearby = service.find_nearby_shops_json(34.68, 135.80, 5.0, &arena);
+    ASSERT_TRUE(nearby.has_value());
+    EXPECT_NE(nearby.value().find(R"("id":"1")"), std::string::npos);
+}
+
+// Test 10: 追加された店舗は ID 順の位置に入り、変更のない店舗の JSON 断片は使い回される
+TEST_F(ShopServiceTest, RefreshShopsKeepsIdOrderAndReusesFragments) {
+    repository->shops[1].id = "3";
+    ShopService service(repository);
+    auto before = service.get_snapshot().value();
+
+    repository->shops.push_back(
+        Shop("2", "Curry C", "奈良市3", std::nullopt, 34.70, 135.82, "奈良市", SpiceParameters(50, 50, 50), 3.5)
+    );
+    ASSERT_TRUE(service.refresh_shops({"2"}).has_value());
+
+    auto after = service.get_snapshot().value();
+    ASSERT_EQ(after->shops.size(), 3u);
+    EXPECT_EQ(after->shops[0].id, "1");
+    EXPECT_EQ(after->shops[1].id, "2");
+    EXPECT_EQ(after->shops[2].id, "3");
+    EXPECT_EQ(after->shop_json[0], before->shop_json[0]);
+    EXPECT_EQ(after->shop_json[2], before->shop_json[1]);
+
+    // 全件読み込みと同じ JSON になる
+    std::ranges::sort(repository->shops, {}, &Shop::id);
+    ASSERT_TRUE(service.refresh_snapshot().has_value());
+    EXPECT_EQ(*after->all_json, *service.get_snapshot().value()->all_json);
+}
+
+// Test 11: スナップショットを読み込めないときは条件と件数をリポジトリの検索で評価する
+TEST_F(ShopServiceTest, FallsBackToRepositoryQueryWithoutSnapshot) {
+    auto query_repository = std::make_shared<FakeShopQueryRepository>();
+    query_repository->shops = repository->shops;
+    repository->unavailable = true;
+    ShopService service(repository, query_repository);
+
+    ShopQuery query;
+    query.sort = ShopSort::RatingDesc;
+    query.limit = 1;
+
+    auto page = service.query_shops_page(query);
+    ASSERT_TRUE(page.has_value());
+    EXPECT_TRUE(page.value().json->starts_with(R"([{"id":"1")"));
+    ASSERT_TRUE(page.value().next_cursor.has_value());
+    ASSERT_EQ(query_repository->queries.size(), 1u);
+    EXPECT_EQ(query_repository->queries[0].limit, 2u);
+
+    // 次のページはカーソルごとリポジトリへ渡し、最後のページにはカーソルがない
+    query.after = decode_shop_cursor(*page.value().next_cursor).value();
+    auto next = service.query_shops_page(query);
+    ASSERT_TRUE(next.has_value());
+    EXPECT_TRUE(next.value().json->starts_with(R"([{"id":"2")"));
+    EXPECT_FALSE(next.value().next_cursor.has_value());
+
+    // フォールバックがなければエラーのまま
+    ShopService without_fallback(repository);
+    EXPECT_FALSE(without_fallback.query_shops_page(query).has_value());
+}
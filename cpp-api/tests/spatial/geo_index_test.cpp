@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "spatial/geo_index.hpp"
+#include "spatial/coordinate_store.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <random>
+
+using namespace spatial;
+
+class GeoIndexTest : public ::testing::Test {
+protected:
+    std::vector<GeoPoint> points;
+
+    void SetUp() override {
+        // 近畿圏に散らばる点
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> lat(33.5, 35.8);
+        std::uniform_real_distribution<double> lon(134.5, 136.5);
+        for (std::uint32_t i = 0; i < 5000; ++i) {
+            points.push_back(GeoPoint{lat(rng), lon(rng), i});
+        }
+    }
+
+    // 全件走査による正解
+    std::vector<GeoHit> brute_force(double latitude, double longitude) const {
+        std::vector<GeoHit> hits;
+        for (const auto& p : points) {
+            hits.push_back(GeoHit{p.index, haversine_km(latitude, longitude, p.latitude, p.longitude)});
+        }
+        std::sort(hits.begin(), hits.end(), [](const GeoHit& a, const GeoHit& b) {
+            return a.distance_km < b.distance_km || (a.distance_km == b.distance_km && a.index < b.index);
+        });
+        return hits;
+    }
+};
+
+// Test 1: 既知の距離（奈良駅 → 大阪駅 約 30km）
+TEST_F(GeoIndexTest, HaversineDistance) {
+    EXPECT_NEAR(haversine_km(34.6808, 135.8195, 34.7025, 135.4959), 29.7, 1.0);
+    EXPECT_DOUBLE_EQ(haversine_km(34.68, 135.80, 34.68, 135.80), 0.0);
+}
+
+// Test 2: 半径検索は全件走査と同じ結果を距離順に返す
+TEST_F(GeoIndexTest, WithinRadiusMatchesBruteForce) {
+    GeoIndex index(points);
+
+    for (double radius : {0.5, 3.0, 12.0, 80.0}) {
+        auto expected = brute_force(34.6851, 135.8050);
+        std::erase_if(expected, [radius](const GeoHit& h) { return h.distance_km > radius; });
+
+        auto actual = index.within_radius(34.6851, 135.8050, radius);
+        ASSERT_EQ(actual.size(), expected.size()) << "radius=" << radius;
+        for (size_t i = 0; i < actual.size(); ++i) {
+            EXPECT_EQ(actual[i].index, expected[i].index);
+        }
+    }
+}
+
+// Test 3: k近傍は全件走査の上位 k 件と一致する（範囲外の検索点も含む）
+TEST_F(GeoIndexTest, NearestMatchesBruteForce) {
+    GeoIndex index(points, 0.02);
+
+    for (auto [lat, lon] : {std::pair{34.6851, 135.8050}, std::pair{35.0, 134.0}, std::pair{36.5, 137.0}}) {
+        auto expected = brute_force(lat, lon);
+        auto actual = index.nearest(lat, lon, 10);
+
+        ASSERT_EQ(actual.size(), 10u);
+        for (size_t i = 0; i < actual.size(); ++i) {
+            EXPECT_EQ(actual[i].index, expected[i].index);
+            EXPECT_DOUBLE_EQ(actual[i].distance_km, expected[i].distance_km);
+        }
+    }
+}
+
+// Test 4: 最大半径と空のインデックス
+TEST_F(GeoIndexTest, NearestRespectsMaxRadius) {
+    GeoIndex index(points);
+    for (const auto& hit : index.nearest(34.6851, 135.8050, 1000, 5.0)) {
+        EXPECT_LE(hit.distance_km, 5.0);
+    }
+
+    GeoIndex empty;
+    EXPECT_TRUE(empty.nearest(34.0, 135.0, 5).empty());
+    EXPECT_TRUE(empty.within_radius(34.0, 135.0, 10.0).empty());
+}
+
+// Test 5: SoA カーネルの候補は正確な距離の判定を取りこぼさない（端数の範囲も含む）
+TEST_F(GeoIndexTest, CoordinateStoreFilterCoversExactHits) {
+    CoordinateStore store;
+    for (const auto& p : points) {
+        store.push_back(p.latitude, p.longitude);
+    }
+
+    for (auto [begin, end] : {std::pair<size_t, size_t>{0, points.size()}, {3, 4}, {7, 1234}}) {
+        std::pmr::vector<std::uint32_t> candidates;
+        store.filter_within_radius(34.6851, 135.8050, 15.0, begin, end, candidates);
+
+        size_t expected = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& p = points[i];
+            bool inside = haversine_km(34.6851, 135.8050, p.latitude, p.longitude) <= 15.0;
+            bool candidate = std::ranges::find(candidates, static_cast<std::uint32_t>(i)) != candidates.end();
+            expected += inside ? 1 : 0;
+            EXPECT_TRUE(!inside || candidate) << "kernel=" << CoordinateStore::kernel_name() << " i=" << i;
+        }
+        // 緩めた判定による余分な候補はごくわずか
+        EXPECT_LE(candidates.size(), expected + 2);
+    }
+}
+
+// Test 6: 正距円筒近似は短い半径で大円距離とほぼ一致する
+TEST_F(GeoIndexTest, EquirectangularFastPath) {
+    CoordinateStore store;
+    for (const auto& p : points) {
+        store.push_back(p.latitude, p.longitude);
+    }
+
+    std::pmr::vector<std::uint32_t> haversine;
+    std::pmr::vector<std::uint32_t> equirectangular;
+    store.filter_within_radius(34.6851, 135.8050, 5.0, 0, store.size(), haversine);
+    store.filter_within_radius(34.6851, 135.8050, 5.0, 0, store.size(), equirectangular,
+                               DistanceMode::Equirectangular);
+
+    ASSERT_FALSE(haversine.empty());
+    EXPECT_EQ(haversine, equirectangular);
+}
+
+// Test 7: 渡したアリーナだけで結果と候補を確保する（上流を null_memory_resource にしても失敗しない）
+TEST_F(GeoIndexTest, SearchesAllocateFromArena) {
+    GeoIndex index(points);
+    auto expected_nearby = index.within_radius(34.6851, 135.8050, 12.0);
+    auto expected_nearest = index.nearest(34.6851, 135.8050, 10);
+
+    std::vector<std::byte> buffer(1 << 20);
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    auto nearby = index.within_radius(34.6851, 135.8050, 12.0, &arena);
+    auto nearest = index.nearest(34.6851, 135.8050, 10, std::numeric_limits<double>::infinity(), &arena);
+
+    EXPECT_EQ(nearby.get_allocator().resource(), &arena);
+    ASSERT_EQ(nearby.size(), expected_nearby.size());
+    ASSERT_EQ(nearest.size(), expected_nearest.size());
+    for (size_t i = 0; i < nearest.size(); ++i) {
+        EXPECT_EQ(nearest[i].index, expected_nearest[i].index);
+    }
+}
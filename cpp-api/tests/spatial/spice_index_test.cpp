@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "spatial/spice_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace spatial;
+
+class SpiceIndexTest : public ::testing::Test {
+protected:
+    std::vector<SpicePoint> points;
+    std::vector<double> ratings;
+    SpiceIndex index;
+
+    void SetUp() override {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> level(0, 100);
+        std::uniform_real_distribution<double> rating(1.0, 5.0);
+        for (int i = 0; i < 3000; ++i) {
+            points.push_back(SpicePoint{level(rng), level(rng), level(rng)});
+            ratings.push_back(rating(rng));
+            index.push_back(points.back(), ratings.back());
+        }
+    }
+
+    // 全件走査による正解（距離の昇順、同距離はインデックス順）
+    std::vector<std::uint32_t> brute_force(const SpicePoint& q, size_t k, double min_rating) const {
+        std::vector<std::pair<int, std::uint32_t>> all;
+        for (std::uint32_t i = 0; i < points.size(); ++i) {
+            if (ratings[i] < min_rating) continue;
+            int ds = points[i].spiciness - q.spiciness;
+            int dt = points[i].stimulation - q.stimulation;
+            int da = points[i].aroma - q.aroma;
+            all.emplace_back(ds * ds + dt * dt + da * da, i);
+        }
+        std::sort(all.begin(), all.end());
+        std::vector<std::uint32_t> result;
+        for (size_t i = 0; i < std::min(k, all.size()); ++i) {
+            result.push_back(all[i].second);
+        }
+        return result;
+    }
+};
+
+// Test 1: k近傍は全件走査と同じ順序で返す（評価による除外を含む）
+TEST_F(SpiceIndexTest, NearestMatchesBruteForce) {
+    for (double min_rating : {0.0, 4.0}) {
+        SpicePoint query{72, 40, 55};
+        auto expected = brute_force(query, 20, min_rating);
+        auto actual = index.nearest(query, 20, min_rating);
+
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            EXPECT_EQ(actual[i].index, expected[i]);
+            EXPECT_GE(ratings[actual[i].index], min_rating);
+        }
+    }
+}
+
+// Test 2: 候補を指定した検索は候補の中だけから選ぶ
+TEST_F(SpiceIndexTest, NearestAmongCandidates) {
+    std::vector<std::uint32_t> candidates = {5, 10, 15, 20, 2999};
+    auto hits = index.nearest(SpicePoint{50, 50, 50}, 3, 0.0, candidates);
+
+    ASSERT_EQ(hits.size(), 3u);
+    for (const auto& hit : hits) {
+        EXPECT_NE(std::ranges::find(candidates, hit.index), candidates.end());
+    }
+    EXPECT_LE(hits[0].distance, hits[1].distance);
+    EXPECT_LE(hits[1].distance, hits[2].distance);
+
+    EXPECT_TRUE(SpiceIndex().nearest(SpicePoint{50, 50, 50}, 3).empty());
+}
@@ -0,0 +1,167 @@
+// 店舗データの一括取り込み
+// JSON（shops.json と同じ形）または CSV を検証し、チャンクごとに並列の COPY で shops へ書き込む。
+// 接続先は API サーバーと同じ環境変数（DB_HOST / DB_PORT / DB_NAME / DB_USER / DB_PASSWORD）
+//
+//   ./shop_import <file.json|file.csv> [--format json|csv] [--workers N] [--chunk-size N] [--replace] [--dry-run]
+#include "database/connection_pool.hpp"
+#include "importer/shop_import.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+void print_usage() {
+    std::println("Usage: shop_import <file.json|file.csv> [options]");
+    std::println("  --format json|csv   入力形式（省略時は拡張子から判定）");
+    std::println("  --workers N         並列に COPY する接続数（既定: CPU 数、最大 8）");
+    std::println("  --chunk-size N      1トランザクションの行数（既定: 5000）");
+    std::println("  --replace           入力にない店舗を削除し、shops を入力と同じ内容に置き換える（失敗時は変更しない）");
+    std::println("  --dry-run           解析と検証だけを行い、書き込まない");
+}
+
+std::optional<size_t> parse_count(std::string_view value) {
+    int parsed = std::atoi(std::string(value).c_str());
+    if (parsed <= 0) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(parsed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string path;
+    std::optional<importer::InputFormat> format;
+    importer::ImportOptions options;
+    options.workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+    bool dry_run = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&]() -> std::optional<std::string_view> {
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+            return std::string_view(argv[++i]);
+        };
+
+        if (arg == "--format") {
+            auto value = next();
+            if (value == "json") {
+                format = importer::InputFormat::Json;
+            } else if (value == "csv") {
+                format = importer::InputFormat::Csv;
+            } else {
+                print_usage();
+                return 2;
+            }
+        } else if (arg == "--workers" || arg == "--chunk-size") {
+            auto value = next();
+            auto count = value ? parse_count(*value) : std::nullopt;
+            if (!count) {
+                std::println("❌ {} requires a positive number", arg);
+                return 2;
+            }
+            (arg == "--workers" ? options.workers : options.chunk_size) = *count;
+        } else if (arg == "--replace") {
+            options.replace = true;
+        } else if (arg == "--dry-run") {
+            dry_run = true;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return 0;
+        } else if (path.empty() && !arg.starts_with("--")) {
+            path = std::string(arg);
+        } else {
+            print_usage();
+            return 2;
+        }
+    }
+
+    if (path.empty()) {
+        print_usage();
+        return 2;
+    }
+    if (!format) {
+        format = importer::format_from_path(path);
+    }
+    if (!format) {
+        std::println("❌ Cannot detect input format of {} (use --format)", path);
+        return 2;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::println("❌ Cannot open {}", path);
+        return 1;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    const std::string input = std::move(buffer).str();
+
+    std::println("📄 Parsing {} ({} bytes)...", path, input.size());
+    auto parsed = *format == importer::InputFormat::Json
+        ? importer::parse_shops_json(input)
+        : importer::parse_shops_csv(input);
+    if (!parsed) {
+        std::println("❌ {}", parsed.error());
+        return 1;
+    }
+
+    for (const auto& rejected : parsed->rejected) {
+        std::println("⚠️  Skipped {}", rejected);
+    }
+    std::println("✅ {} valid shop(s), {} rejected", parsed->shops.size(), parsed->rejected.size());
+
+    if (dry_run || parsed->shops.empty()) {
+        return parsed->rejected.empty() ? 0 : 1;
+    }
+
+    auto config = database::DatabaseConfig::from_env();
+    if (!config) {
+        std::println("❌ Failed to load database configuration from environment");
+        return 1;
+    }
+
+    auto pool = database::ConnectionPool::create(*config, options.workers);
+    if (!pool) {
+        std::println("❌ Failed to create connection pool: {}", pool.error());
+        return 1;
+    }
+
+    std::println("🚚 Importing with {} worker(s), {} rows per chunk{}...",
+                 options.workers, options.chunk_size, options.replace ? " (replacing existing shops)" : "");
+    std::fflush(stdout);
+
+    auto report = importer::import_shops(*pool, parsed->shops, options);
+    if (!report) {
+        std::println("❌ Import failed: {}", report.error());
+        return 1;
+    }
+
+    for (const auto& failure : report->failed_chunks) {
+        std::println("❌ Chunk failed: {}", failure);
+    }
+    if (options.replace) {
+        if (!report->failed_chunks.empty()) {
+            std::println("❌ Replace aborted, shops was not modified");
+            return 1;
+        }
+        std::println("🗑️  Removed {} shop(s) missing from the input", report->removed);
+    }
+
+    const double seconds = static_cast<double>(report->elapsed.count()) / 1000.0;
+    std::println("✅ Imported {} / {} shop(s) in {} chunk(s), {:.2f}s ({:.0f} rows/s)",
+                 report->imported, parsed->shops.size(), report->chunks, seconds,
+                 seconds > 0.0 ? static_cast<double>(report->imported) / seconds : 0.0);
+
+    return report->failed_chunks.empty() && parsed->rejected.empty() ? 0 : 1;
+}
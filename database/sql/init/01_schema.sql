@@ -5,8 +5,10 @@
 CREATE EXTENSION IF NOT EXISTS "uuid-ossp";
 
 -- Shops table
+-- id はバイト順（COLLATE "C"）で比較する。API サーバーのスナップショット・キーセットページングの
+-- 並び順と一致し、id を含む比較・並べ替えが主キーと下のインデックスをそのまま使える
 CREATE TABLE shops (
-    id SERIAL PRIMARY KEY,
+    id VARCHAR(255) COLLATE "C" PRIMARY KEY,
     name VARCHAR(255) NOT NULL,
     address TEXT NOT NULL,
     latitude DECIMAL(10, 7) NOT NULL,
@@ -23,8 +25,12 @@ CREATE TABLE shops (
 
 -- Indexes for shops
 CREATE INDEX idx_shops_region ON shops(region);
+CREATE INDEX idx_shops_region_rating ON shops(region, rating DESC);
 CREATE INDEX idx_shops_location ON shops(latitude, longitude);
-CREATE INDEX idx_shops_rating ON shops(rating DESC);
+-- 並び替え（sort=rating / spiciness / name）とキーセットページングの同順位を id で解決する
+CREATE INDEX idx_shops_rating ON shops(rating DESC, id);
+CREATE INDEX idx_shops_spiciness ON shops(spiciness DESC, id);
+CREATE INDEX idx_shops_name ON shops((name COLLATE "C"), id);
 
 -- Users table
 CREATE TABLE users (
@@ -48,7 +54,7 @@ CREATE INDEX idx_users_email ON users(email);
 -- User favorite shops (many-to-many)
 CREATE TABLE user_favorite_shops (
     user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,
-    shop_id INTEGER REFERENCES shops(id) ON DELETE CASCADE,
+    shop_id VARCHAR(255) COLLATE "C" REFERENCES shops(id) ON DELETE CASCADE,
     created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     PRIMARY KEY (user_id, shop_id)
 );
@@ -60,7 +66,7 @@ CREATE INDEX idx_user_favorite_shops_shop ON user_favorite_shops(shop_id);
 -- User disliked shops (many-to-many)
 CREATE TABLE user_disliked_shops (
     user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,
-    shop_id INTEGER REFERENCES shops(id) ON DELETE CASCADE,
+    shop_id VARCHAR(255) COLLATE "C" REFERENCES shops(id) ON DELETE CASCADE,
     created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     PRIMARY KEY (user_id, shop_id)
 );
@@ -89,3 +95,41 @@ CREATE TRIGGER update_users_updated_at
     BEFORE UPDATE ON users
     FOR EACH ROW
     EXECUTE FUNCTION update_updated_at_column();
+
+-- Cache invalidation notifications
+-- 行の変更を NOTIFY "<table>_changed" '<operation>:<id>' で API サーバーへ通知する
+-- （ペイロードが空の id はテーブル全体の無効化）
+CREATE OR REPLACE FUNCTION notify_row_change() RETURNS trigger AS $$
+DECLARE
+    row_id TEXT;
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        row_id := OLD.id::TEXT;
+    ELSE
+        row_id := NEW.id::TEXT;
+    END IF;
+    PERFORM pg_notify(TG_TABLE_NAME || '_changed', TG_OP || ':' || row_id);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION notify_table_truncate() RETURNS trigger AS $$
+BEGIN
+    PERFORM pg_notify(TG_TABLE_NAME || '_changed', TG_OP || ':');
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER shops_notify_change
+    AFTER INSERT OR UPDATE OR DELETE ON shops
+    FOR EACH ROW EXECUTE FUNCTION notify_row_change();
+CREATE TRIGGER shops_notify_truncate
+    AFTER TRUNCATE ON shops
+    FOR EACH STATEMENT EXECUTE FUNCTION notify_table_truncate();
+
+CREATE TRIGGER users_notify_change
+    AFTER INSERT OR UPDATE OR DELETE ON users
+    FOR EACH ROW EXECUTE FUNCTION notify_row_change();
+CREATE TRIGGER users_notify_truncate
+    AFTER TRUNCATE ON users
+    FOR EACH STATEMENT EXECUTE FUNCTION notify_table_truncate();
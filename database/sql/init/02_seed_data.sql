@@ -53,9 +53,6 @@ INSERT INTO shops (id, name, address, latitude, longitude, region, spiciness, st
 (49, 'カレーレストラン ラージ', '奈良県橿原市石川町312-1', 34.498, 135.79, '橿原市', 60, 55, 75, 4.1, '橿原の本格インドカレー。豊富なベジタリアンメニューも魅力。'),
 (50, 'インド・ネパール料理 シェルパ', '奈良県桜井市大福234-6', 34.522, 135.848, '桜井市', 65, 60, 80, 4.2, '桜井のネパール料理専門店。ダルバートと濃厚カレーが人気。');
 
--- Reset the sequence for shops
-SELECT setval('shops_id_seq', (SELECT MAX(id) FROM shops));
-
 -- Users data
 INSERT INTO users (username, email, display_name, bio, pref_spiciness, pref_stimulation, pref_aroma, is_public, created_at) VALUES
 ('spice_lover_nara', 'spice.lover@example.com', 'スパイス愛好家', '奈良でスパイスカレーを食べ歩いています。刺激的で香り豊かなカレーが大好きです！', 80, 75, 90, true, '2024-01-15 09:00:00'),
@@ -0,0 +1,34 @@
+-- 既存データベース向け: shops.id を COLLATE "C" の文字列にし、並び替え用のインデックスを追加する
+-- （init/01_schema.sql・cpp-api/schema.sql は作成時点でこの状態）
+-- API サーバーのスナップショットとキーセットページングは id をバイト順で比較するため、
+-- 整数やデフォルト照合順序の id ではページの境界がずれる
+--
+--   psql -U spice_user -d spice_road -f database/sql/migrations/001_shops_id_collate_c.sql
+
+BEGIN;
+
+-- 参照する側も同じ型・照合順序にするため、外部キーを張り直す
+ALTER TABLE user_favorite_shops DROP CONSTRAINT IF EXISTS user_favorite_shops_shop_id_fkey;
+ALTER TABLE user_disliked_shops DROP CONSTRAINT IF EXISTS user_disliked_shops_shop_id_fkey;
+
+ALTER TABLE shops ALTER COLUMN id DROP DEFAULT;
+ALTER TABLE shops ALTER COLUMN id TYPE VARCHAR(255) COLLATE "C" USING id::TEXT;
+ALTER TABLE user_favorite_shops ALTER COLUMN shop_id TYPE VARCHAR(255) COLLATE "C" USING shop_id::TEXT;
+ALTER TABLE user_disliked_shops ALTER COLUMN shop_id TYPE VARCHAR(255) COLLATE "C" USING shop_id::TEXT;
+
+ALTER TABLE user_favorite_shops ADD CONSTRAINT user_favorite_shops_shop_id_fkey
+    FOREIGN KEY (shop_id) REFERENCES shops(id) ON DELETE CASCADE;
+ALTER TABLE user_disliked_shops ADD CONSTRAINT user_disliked_shops_shop_id_fkey
+    FOREIGN KEY (shop_id) REFERENCES shops(id) ON DELETE CASCADE;
+
+-- SERIAL だった場合の採番用シーケンス（id は取り込み元が決める）
+DROP SEQUENCE IF EXISTS shops_id_seq;
+
+-- 並び替え（sort=rating / spiciness / name）とキーセットページングの同順位を id で解決する
+-- idx_shops_rating は以前 (rating DESC) だけだったため作り直す
+DROP INDEX IF EXISTS idx_shops_rating;
+CREATE INDEX IF NOT EXISTS idx_shops_rating ON shops(rating DESC, id);
+CREATE INDEX IF NOT EXISTS idx_shops_spiciness ON shops(spiciness DESC, id);
+CREATE INDEX IF NOT EXISTS idx_shops_name ON shops((name COLLATE "C"), id);
+
+COMMIT;
@@ -0,0 +1,49 @@
+-- 既存データベース向け: API サーバーのキャッシュを無効化する NOTIFY のトリガーを追加する
+-- （init/01_schema.sql・cpp-api/schema.sql は作成時点でこの状態。繰り返し適用できる）
+--
+--   psql -U spice_user -d spice_road -f database/sql/migrations/002_change_notifications.sql
+
+BEGIN;
+
+-- 行の変更を NOTIFY "<table>_changed" '<operation>:<id>' で API サーバーへ通知する
+-- （ペイロードが空の id はテーブル全体の無効化）
+CREATE OR REPLACE FUNCTION notify_row_change() RETURNS trigger AS $$
+DECLARE
+    row_id TEXT;
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        row_id := OLD.id::TEXT;
+    ELSE
+        row_id := NEW.id::TEXT;
+    END IF;
+    PERFORM pg_notify(TG_TABLE_NAME || '_changed', TG_OP || ':' || row_id);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION notify_table_truncate() RETURNS trigger AS $$
+BEGIN
+    PERFORM pg_notify(TG_TABLE_NAME || '_changed', TG_OP || ':');
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS shops_notify_change ON shops;
+CREATE TRIGGER shops_notify_change
+    AFTER INSERT OR UPDATE OR DELETE ON shops
+    FOR EACH ROW EXECUTE FUNCTION notify_row_change();
+DROP TRIGGER IF EXISTS shops_notify_truncate ON shops;
+CREATE TRIGGER shops_notify_truncate
+    AFTER TRUNCATE ON shops
+    FOR EACH STATEMENT EXECUTE FUNCTION notify_table_truncate();
+
+DROP TRIGGER IF EXISTS users_notify_change ON users;
+CREATE TRIGGER users_notify_change
+    AFTER INSERT OR UPDATE OR DELETE ON users
+    FOR EACH ROW EXECUTE FUNCTION notify_row_change();
+DROP TRIGGER IF EXISTS users_notify_truncate ON users;
+CREATE TRIGGER users_notify_truncate
+    AFTER TRUNCATE ON users
+    FOR EACH STATEMENT EXECUTE FUNCTION notify_table_truncate();
+
+COMMIT;